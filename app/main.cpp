@@ -1,12 +1,24 @@
+#include <chrono>
 #include <iostream>
 #include <thread>
+#include <vector>
 
+#include "logger/LockFreeLogQueue.h"
 #include "logger/LogQueue.h"
 #include "logger/Logger.h"
 #include "logger/SocketLogger.h"
 
 using namespace logger;
 
+// Очередь между потоком ввода и рабочим потоком выбирается
+// при сборке: -DLOGGER_LOCKFREE_QUEUE=ON включает
+// lock-free кольцо LockFreeLogQueue
+#ifdef LOGGER_LOCKFREE_QUEUE
+using AppLogQueue = LockFreeLogQueue;
+#else
+using AppLogQueue = LogQueue;
+#endif
+
 // Функция для преобразования строки в уровень логирования
 LogLevel parseLevel(const std::string &s,
                     LogLevel defaultLevel) {
@@ -39,12 +51,17 @@ int main(int argc, char *argv[]) {
   // Проверка аргументов командной строки
   if (argc < 2) {
     std::cerr << "Usage: " << argv[0]
-              << " <log_file> [default_level]\n";
+              << " <log_file|socket|endpoint> "
+                 "[default_level]\n";
+    std::cerr << "  endpoint: [framed+]tcp://HOST:PORT, "
+                 "udp://HOST:PORT, [framed+]unix:PATH, "
+                 "unixgram:PATH\n";
     return 1;
   }
 
   std::string mode
-    = argv[1];  // Имя файла или режим "socket"
+    = argv[1];  // Имя файла, режим "socket" или адрес
+                // сервера логов
   LogLevel defaultLevel = LogLevel::Info;
   if (argc >= 3) {
     defaultLevel = parseLevel(argv[2], LogLevel::Info);
@@ -52,29 +69,49 @@ int main(int argc, char *argv[]) {
 
   std::unique_ptr<ILogger> loggerPtr;
 
-  if (mode == "socket") {
+  // Режимы сетевого логгера: "socket" (TCP
+  // 127.0.0.1:5000) или адрес сервера (tcp://, udp://,
+  // unix:, unixgram:); префикс "framed+" или режим
+  // "socket-framed" включают протокол кадров
+  SocketLoggerOptions options;
+  std::string target = mode;
+  const std::string framedPrefix = "framed+";
+  if (target == "socket-framed") {
+    options.protocol = WireProtocol::Framed;
+    target = "socket";
+  } else if (target.compare(0, framedPrefix.size(),
+                            framedPrefix)
+             == 0) {
+    options.protocol = WireProtocol::Framed;
+    target.erase(0, framedPrefix.size());
+  }
+  Endpoint endpoint;  // По умолчанию tcp://127.0.0.1:5000
+
+  if (target == "socket"
+      || parseEndpoint(target, endpoint)) {
     // Создаём SocketLogger и подключаемся к серверу
     // логирования
     loggerPtr = std::make_unique<SocketLogger>(
-      "127.0.0.1", 5000, defaultLevel);
+      endpoint, defaultLevel, options);
   } else {
     // Создаём обычный файл-логгер
     loggerPtr
       = std::make_unique<Logger>(mode, defaultLevel);
   }
 
-  LogQueue logQueue;  // Очередь логов между потоками
+  AppLogQueue logQueue;  // Очередь логов между потоками
 
   // Запускаем рабочий поток, который извлекает сообщения из
-  // очереди и логирует
+  // очереди пачками и логирует каждую пачку одной записью
   std::thread worker([&loggerPtr, &logQueue] {
-    while (true) {
-      auto optMsg
-        = logQueue.pop();  // Получаем сообщение из очереди
-      if (!optMsg)
-        break;  // Если очередь закрыта — завершаем поток
-      loggerPtr->log(optMsg->text,
-                     optMsg->level);  // Логируем сообщение
+    constexpr std::size_t kMaxBatch = 256;
+    constexpr std::chrono::milliseconds kBatchWait{100};
+    std::vector<LogMessage> batch;
+    // popBatch возвращает false, когда очередь закрыта и
+    // пуста — тогда завершаем поток
+    while (logQueue.popBatch(batch, kMaxBatch, kBatchWait)) {
+      if (!batch.empty())
+        loggerPtr->logBatch(batch.data(), batch.size());
     }
   });
 
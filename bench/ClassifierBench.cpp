@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "LevelClassifier.h"
+
+namespace {
+
+// Прежняя реализация log_stats: копия строки в верхнем
+// регистре и до 12 вызовов find
+StatsLevel legacyDetermineLevel(std::string_view line) {
+  std::string upperLine(line);
+  std::transform(upperLine.begin(), upperLine.end(),
+                 upperLine.begin(), ::toupper);
+  if (upperLine.find("ERROR") != std::string::npos
+      || upperLine.find("ERR") != std::string::npos
+      || upperLine.find("FATAL") != std::string::npos)
+    return StatsLevel::Error;
+  else if (upperLine.find("WARNING") != std::string::npos
+           || upperLine.find("WARN") != std::string::npos
+           || upperLine.find("WRN") != std::string::npos)
+    return StatsLevel::Warning;
+  else if (upperLine.find("INFO") != std::string::npos
+           || upperLine.find("INFORMATION")
+                != std::string::npos)
+    return StatsLevel::Info;
+  else if (upperLine.find("DEBUG") != std::string::npos
+           || upperLine.find("DBG") != std::string::npos
+           || upperLine.find("TRACE") != std::string::npos)
+    return StatsLevel::Debug;
+  else
+    return StatsLevel::Unknown;
+}
+
+// Набор строк: в основном строки Logger с разными
+// уровнями, часть — произвольный текст; в некоторых
+// сообщениях встречается слово "error"
+std::vector<std::string> sampleLines() {
+  const char *levels[] = {"INFO", "INFO", "INFO", "WARNING",
+                          "ERROR"};
+  std::vector<std::string> lines;
+  for (int i = 0; i < 1000; ++i) {
+    std::string body = "request " + std::to_string(i)
+                       + " handled by worker "
+                       + std::to_string(i % 16)
+                       + " in 12 ms, payload 4096 bytes";
+    if (i % 7 == 0)
+      body += " after retrying a transient error";
+    if (i % 10 == 9) {
+      lines.push_back("free-form " + body);
+    } else {
+      lines.push_back("[2024-05-01 12:00:00.123] ["
+                      + std::string(levels[i % 5]) + "] "
+                      + body);
+    }
+  }
+  return lines;
+}
+
+// Наносекунд на строку для classify
+template <typename Classify>
+double run(const std::vector<std::string> &lines,
+           int rounds, Classify classify, unsigned &sink) {
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < rounds; ++r) {
+    for (const std::string &line : lines)
+      sink += static_cast<unsigned>(classify(line));
+  }
+  auto elapsed = std::chrono::duration<double, std::nano>(
+                   std::chrono::steady_clock::now() - start)
+                   .count();
+  return elapsed / (static_cast<double>(lines.size())
+                    * rounds);
+}
+
+}  // namespace
+
+// Использование: classifier_bench [число проходов]
+int main(int argc, char *argv[]) {
+  int rounds = argc >= 2 ? std::stoi(argv[1]) : 2000;
+  std::vector<std::string> lines = sampleLines();
+
+  // Строки, в которых прежний поиск ошибался: слово из
+  // текста сообщения вместо поля уровня
+  int differ = 0;
+  for (const std::string &line : lines) {
+    if (legacyDetermineLevel(line) != classifyLevel(line))
+      ++differ;
+  }
+
+  unsigned sink = 0;
+  double legacy = run(lines, rounds, legacyDetermineLevel,
+                      sink);
+  double current = run(lines, rounds, classifyLevel, sink);
+
+  std::cout << "Level classification, " << lines.size()
+            << " lines x " << rounds << " rounds:\n"
+            << std::fixed << std::setprecision(1);
+  std::cout << "  uppercase copy + find    " << legacy
+            << " ns/line\n";
+  std::cout << "  classifyLevel            " << current
+            << " ns/line\n";
+  std::cout << "  speedup                  "
+            << legacy / current << "x\n";
+  std::cout << "  labels changed           " << differ
+            << " (checksum " << sink << ")\n";
+  return 0;
+}
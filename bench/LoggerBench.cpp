@@ -0,0 +1,181 @@
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "logger/LogMacros.h"
+#include "logger/Logger.h"
+#include "logger/MmapFileLogger.h"
+
+using namespace logger;
+
+namespace {
+
+// Один прогон: записывает lines строк и возвращает
+// пропускную способность в строках в секунду
+double run(const std::string &filename,
+           const LoggerOptions &options, int lines) {
+  std::remove(filename.c_str());
+  const std::string message(80, 'x');
+
+  auto start = std::chrono::steady_clock::now();
+  {
+    Logger logger(filename, LogLevel::Info, options);
+    for (int i = 0; i < lines; ++i) {
+      logger.log(message, LogLevel::Info);
+    }
+  }  // Деструктор дописывает буфер — входит в замер
+  auto elapsed = std::chrono::duration<double>(
+                   std::chrono::steady_clock::now() - start)
+                   .count();
+
+  std::remove(filename.c_str());
+  return lines / elapsed;
+}
+
+// Прогон с несколькими потоками-производителями: lines
+// строк на каждый поток
+double runThreads(const std::string &filename,
+                  const LoggerOptions &options, int lines,
+                  int threadCount) {
+  std::remove(filename.c_str());
+  const std::string message(80, 'x');
+
+  auto start = std::chrono::steady_clock::now();
+  {
+    Logger logger(filename, LogLevel::Info, options);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+      threads.emplace_back([&logger, &message, lines] {
+        for (int i = 0; i < lines; ++i) {
+          logger.log(message, LogLevel::Info);
+        }
+      });
+    }
+    for (auto &th : threads)
+      th.join();
+  }
+  auto elapsed = std::chrono::duration<double>(
+                   std::chrono::steady_clock::now() - start)
+                   .count();
+
+  std::remove(filename.c_str());
+  return lines * threadCount / elapsed;
+}
+
+// Прогон MmapFileLogger с теми же строками
+double runMmap(const std::string &filename, int lines) {
+  std::remove(filename.c_str());
+  const std::string message(80, 'x');
+
+  auto start = std::chrono::steady_clock::now();
+  {
+    MmapFileLogger logger(filename, LogLevel::Info);
+    for (int i = 0; i < lines; ++i) {
+      logger.log(message, LogLevel::Info);
+    }
+  }
+  auto elapsed = std::chrono::duration<double>(
+                   std::chrono::steady_clock::now() - start)
+                   .count();
+
+  std::remove(filename.c_str());
+  return lines / elapsed;
+}
+
+// Стоимость отключённого вызова уровня Info в наносекундах:
+// прямой log() строит строку и делает виртуальный вызов,
+// макрос ограничивается проверкой уровня
+double runDisabled(const std::string &filename, int lines,
+                   bool useMacro) {
+  std::remove(filename.c_str());
+  Logger logger(filename, LogLevel::Warning);
+  ILogger &base = logger;
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < lines; ++i) {
+    if (useMacro) {
+      LOGGER_LOG(base, LogLevel::Info,
+                 "request " + std::to_string(i));
+    } else {
+      base.log("request " + std::to_string(i), LogLevel::Info);
+    }
+  }
+  auto elapsed = std::chrono::duration<double, std::nano>(
+                   std::chrono::steady_clock::now() - start)
+                   .count();
+
+  std::remove(filename.c_str());
+  return elapsed / lines;
+}
+
+// Печатает строку таблицы результатов
+void report(const std::string &name, double linesPerSec) {
+  std::cout << "  " << std::left << std::setw(32) << name
+            << std::right << std::setw(14) << std::fixed
+            << std::setprecision(0) << linesPerSec
+            << " lines/s\n";
+}
+
+}  // namespace
+
+// Использование: logger_bench [файл] [число строк]
+int main(int argc, char *argv[]) {
+  std::string filename
+    = argc >= 2 ? argv[1] : "logger_bench.log";
+  int lines = argc >= 3 ? std::stoi(argv[2]) : 500000;
+
+  std::cout << "Logger flush policies, " << lines
+            << " lines of 80 bytes:\n";
+
+  LoggerOptions eachLine;  // Поведение по умолчанию
+  report("flush every message", run(filename, eachLine, lines));
+
+  LoggerOptions onError;
+  onError.flush.eachMessage = false;
+  onError.flush.onError = true;
+  report("flush on error (64 KiB buffer)",
+         run(filename, onError, lines));
+
+  LoggerOptions bytes;
+  bytes.flush.eachMessage = false;
+  bytes.flush.everyBytes = 256 * 1024;
+  report("flush every 256 KiB", run(filename, bytes, lines));
+
+  LoggerOptions interval;
+  interval.flush.eachMessage = false;
+  interval.flush.interval = std::chrono::milliseconds(100);
+  report("flush every 100 ms", run(filename, interval, lines));
+
+  LoggerOptions manual;
+  manual.flush.eachMessage = false;
+  manual.bufferSize = 1024 * 1024;
+  report("manual flush (1 MiB buffer)",
+         run(filename, manual, lines));
+
+  report("MmapFileLogger", runMmap(filename, lines));
+
+  constexpr int kThreads = 4;
+  std::cout << "\nContention, " << kThreads
+            << " producer threads:\n";
+  LoggerOptions shared;
+  shared.flush.eachMessage = false;
+  report("shared buffer (logMutex_)",
+         runThreads(filename, shared, lines, kThreads));
+  LoggerOptions staged = shared;
+  staged.staging.enabled = true;
+  report("per-thread staging",
+         runThreads(filename, staged, lines, kThreads));
+
+  std::cout << "\nDisabled Info call:\n"
+            << std::setprecision(2);
+  std::cout << "  log() with message        "
+            << runDisabled(filename, lines, false) << " ns\n";
+  std::cout << "  LOGGER_LOG                "
+            << runDisabled(filename, lines, true) << " ns\n";
+
+  return 0;
+}
@@ -0,0 +1,43 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "logger/BinaryLogDecoder.h"
+
+using namespace logger;
+
+// Утилита для чтения двоичных логов BinaryLogger:
+// печатает их в формате "[время] [уровень] сообщение"
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0]
+              << " <binary_log> [output_file]\n";
+    return 1;
+  }
+
+  std::ifstream in(argv[1], std::ios::binary);
+  if (!in.is_open()) {
+    std::cerr << "Failed to open " << argv[1] << "\n";
+    return 1;
+  }
+
+  // Вывод в файл, если он указан, иначе в stdout
+  std::ofstream file;
+  if (argc >= 3) {
+    file.open(argv[2], std::ios::trunc);
+    if (!file.is_open()) {
+      std::cerr << "Failed to open " << argv[2] << "\n";
+      return 1;
+    }
+  }
+  std::ostream &out = argc >= 3 ? file : std::cout;
+
+  std::string error;
+  long decoded = decodeBinaryLog(in, out, &error);
+  if (decoded < 0) {
+    std::cerr << "Decode error: " << error << "\n";
+    return 1;
+  }
+  std::cerr << "Decoded " << decoded << " messages\n";
+  return 0;
+}
@@ -0,0 +1,109 @@
+#pragma once  // Защита от повторного включения
+              // заголовочного файла
+
+#include <array>  // Для счётчиков по уровням
+#include <atomic>  // Для атомарных счётчиков и уровня
+#include <condition_variable>  // Для ожидания в очереди
+#include <cstddef>  // Для std::size_t
+#include <cstdint>  // Для std::uint64_t
+#include <deque>  // Для ограниченной очереди сообщений
+#include <memory>  // Для std::unique_ptr
+#include <mutex>  // Для защиты очереди
+#include <string>  // Для std::string
+#include <thread>  // Для рабочего потока
+
+#include "ILogger.h"  // Интерфейс логгера
+#include "LogMessage.h"  // Структура LogMessage
+
+namespace logger {
+
+// Поведение AsyncLogger при заполненной очереди
+enum class OverflowPolicy {
+  Block,  // Вызывающий поток ждёт освобождения места
+  DropNewest,  // Новое сообщение отбрасывается
+  DropOldest,  // Вытесняется самое старое сообщение
+  DropBelowLevel  // Отбрасываются сообщения менее важные,
+                  // чем dropLevel; остальные ждут места
+};
+
+// Параметры асинхронного логгера
+struct AsyncLoggerOptions {
+  std::size_t capacity
+    = 8192;  // Ёмкость очереди (0 считается как 1)
+  OverflowPolicy policy
+    = OverflowPolicy::Block;  // Политика переполнения
+  LogLevel dropLevel
+    = LogLevel::Warning;  // Порог для DropBelowLevel
+  std::size_t maxBatch
+    = 256;  // Максимальный размер пачки для приёмника
+            // (0 считается как 1)
+};
+
+// Асинхронная обёртка над любым логгером: log() только
+// кладёт сообщение в ограниченную очередь, а запись в
+// приёмник (файл, сокет) выполняет собственный рабочий
+// поток пачками через ILogger::logBatch
+class AsyncLogger : public ILogger {
+ public:
+  // Конструктор: принимает приёмник во владение и запускает
+  // рабочий поток
+  explicit AsyncLogger(std::unique_ptr<ILogger> sink,
+                       AsyncLoggerOptions options = {});
+
+  // Деструктор: дописывает оставшиеся сообщения и
+  // останавливает рабочий поток
+  ~AsyncLogger();
+
+  AsyncLogger(const AsyncLogger &) = delete;
+  AsyncLogger &operator=(const AsyncLogger &) = delete;
+
+  // Ставит сообщение в очередь, если уровень >= текущего
+  void log(const std::string &message,
+           LogLevel level) override;
+
+  // Устанавливает уровень логирования (и у приёмника)
+  void setLogLevel(LogLevel level) override;
+
+  // Возвращает текущий уровень логирования
+  LogLevel getLogLevel() const override;
+
+  // Блокирует, пока все принятые к этому моменту сообщения
+  // не будут переданы приёмнику
+  void flush();
+
+  // Общее число отброшенных сообщений
+  std::uint64_t droppedCount() const;
+
+  // Число отброшенных сообщений указанного уровня
+  std::uint64_t droppedCount(LogLevel level) const;
+
+ private:
+  // Цикл рабочего потока
+  void run();
+
+  // Учитывает отброшенное сообщение
+  void countDrop(LogLevel level);
+
+  std::unique_ptr<ILogger> sink_;  // Приёмник сообщений
+  const AsyncLoggerOptions options_;  // Параметры
+
+  std::deque<LogMessage> queue_;  // Очередь сообщений
+  std::mutex mutex_;  // Мьютекс очереди
+  std::condition_variable
+    notEmpty_;  // Сигнал рабочему потоку
+  std::condition_variable
+    notFull_;  // Сигнал ожидающим производителям
+  std::condition_variable
+    drained_;  // Сигнал для flush()
+  std::uint64_t accepted_ = 0;  // Принято в очередь
+  std::uint64_t completed_
+    = 0;  // Передано приёмнику или вытеснено
+  bool stopping_ = false;  // Флаг остановки
+
+  std::array<std::atomic<std::uint64_t>, 3>
+    dropped_{};  // Отброшенные сообщения по уровням
+
+  std::thread worker_;  // Рабочий поток
+};
+
+}  // namespace logger
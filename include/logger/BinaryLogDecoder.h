@@ -0,0 +1,20 @@
+#pragma once  // Защита от повторного включения
+              // заголовочного файла
+
+#include <cstddef>  // Для std::size_t
+#include <istream>  // Для входного потока
+#include <ostream>  // Для выходного потока
+#include <string>  // Для текста ошибки
+
+namespace logger {
+
+// Декодирует двоичный лог BinaryLogger из in в текстовый
+// формат "[время] [УРОВЕНЬ] сообщение" (как у Logger) в
+// out. Возвращает число декодированных сообщений или -1
+// при повреждённом файле (описание ошибки — в error).
+// Обрезанная последняя запись (аварийное завершение)
+// ошибкой не считается.
+long decodeBinaryLog(std::istream &in, std::ostream &out,
+                     std::string *error = nullptr);
+
+}  // namespace logger
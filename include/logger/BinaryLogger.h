@@ -0,0 +1,222 @@
+#pragma once  // Защита от повторного включения
+              // заголовочного файла
+
+#include <cstdint>  // Для целых фиксированной ширины
+#include <cstring>  // Для memcpy
+#include <fstream>  // Для записи в файл
+#include <mutex>  // Для синхронизации записи
+#include <string>  // Для std::string
+#include <string_view>  // Для строковых аргументов
+#include <type_traits>  // Для выбора кодирования аргумента
+#include <unordered_map>  // Для реестра форматов
+#include <vector>  // Для списка форматов
+
+#include "ILogger.h"  // Интерфейс логгера
+#include "LogMacros.h"  // LOGGER_MIN_LEVEL
+
+namespace logger {
+
+// Двоичный формат лога (порядок байт — порядок хоста):
+//
+//   Заголовок файла: 8 байт kBinaryLogMagic.
+//   Запись формата (один раз на каждый использованный ID):
+//     uint8 kFormatRecord, uint32 id, uint32 длина, байты
+//   Запись сообщения:
+//     uint8 kEntryRecord, uint32 id, uint8 уровень,
+//     int64 наносекунды от эпохи, uint32 длина аргументов,
+//     аргументы (тег uint8 + значение)
+//
+// Строка формата содержит заполнители "{}", которые
+// декодер заменяет значениями аргументов по порядку.
+// Строки и форматы не обрезаются; запись с аргументами
+// длиннее kMaxEntryArgs не пишется (об этом сообщается в
+// stderr), а декодер считает такую длину повреждением.
+namespace binlog {
+
+// Шестой байт — версия формата (в версии 1 длины строк
+// были uint16)
+constexpr char kBinaryLogMagic[8]
+  = {'L', 'G', 'B', 'I', 'N', '2', '\0', '\0'};
+constexpr std::uint8_t kFormatRecord = 1;
+constexpr std::uint8_t kEntryRecord = 2;
+
+// Предел длины аргументов одной записи и строки формата
+constexpr std::uint32_t kMaxEntryArgs = 256 * 1024 * 1024;
+
+// Теги аргументов
+enum class ArgTag : std::uint8_t {
+  Int = 1,  // int64
+  UInt = 2,  // uint64
+  Double = 3,  // double
+  String = 4  // uint32 длина + байты
+};
+
+// ID формата "{}" для обычного log(message, level)
+constexpr std::uint32_t kPlainMessageFormat = 0;
+
+// Дописывает в out байтовое представление значения
+template <typename T>
+void appendRaw(std::string &out, const T &value) {
+  char bytes[sizeof(T)];
+  std::memcpy(bytes, &value, sizeof(T));
+  out.append(bytes, sizeof(T));
+}
+
+// Кодирует строковый аргумент. Строку длиннее
+// kMaxEntryArgs writeEntry всё равно не запишет, поэтому
+// длина сохраняется как есть, а не обрезается
+inline void encodeArg(std::string &out,
+                      std::string_view value) {
+  auto len = static_cast<std::uint32_t>(
+    value.size() > kMaxEntryArgs ? kMaxEntryArgs + 1
+                                 : value.size());
+  out += static_cast<char>(ArgTag::String);
+  appendRaw(out, len);
+  out.append(value.data(), value.size());
+}
+
+// Кодирует числовой аргумент: целые со знаком — Int, без
+// знака — UInt, с плавающей точкой — Double. Символы
+// кодируются как строка из одного байта.
+template <typename T>
+void encodeArg(std::string &out, const T &value) {
+  if constexpr (std::is_same_v<T, char>) {
+    encodeArg(out, std::string_view(&value, 1));
+  } else if constexpr (std::is_same_v<T, bool>
+                       || std::is_unsigned_v<T>) {
+    out += static_cast<char>(ArgTag::UInt);
+    appendRaw(out, static_cast<std::uint64_t>(value));
+  } else if constexpr (std::is_integral_v<T>
+                       || std::is_enum_v<T>) {
+    out += static_cast<char>(ArgTag::Int);
+    appendRaw(out, static_cast<std::int64_t>(value));
+  } else if constexpr (std::is_floating_point_v<T>) {
+    out += static_cast<char>(ArgTag::Double);
+    appendRaw(out, static_cast<double>(value));
+  } else {
+    encodeArg(out, std::string_view(value));
+  }
+}
+
+// Возвращает первый аргумент макроса (строку формата)
+template <typename... Rest>
+constexpr const char *formatOf(const char *fmt,
+                               const Rest &...) {
+  return fmt;
+}
+
+}  // namespace binlog
+
+// Процессный реестр строк формата: каждой уникальной строке
+// присваивается постоянный ID. Обращение к реестру
+// происходит один раз на место вызова (через статическую
+// переменную в макросе LOGGER_BINARY_LOG).
+class FormatRegistry {
+ public:
+  static FormatRegistry &instance();
+
+  // Возвращает ID строки формата, регистрируя её при
+  // первом обращении
+  std::uint32_t intern(const char *fmt);
+
+  // Возвращает строку формата по ID
+  std::string format(std::uint32_t id) const;
+
+ private:
+  FormatRegistry();
+
+  mutable std::mutex mutex_;  // Мьютекс реестра
+  std::unordered_map<std::string, std::uint32_t>
+    ids_;  // Строка формата -> ID
+  std::vector<std::string> formats_;  // ID -> строка
+};
+
+// Логгер двоичного формата с отложенным форматированием.
+// На горячем пути проверяется уровень, затем в буфер
+// копируются только ID формата, метка времени и сырые
+// байты аргументов; строка собирается декодером
+// (log_decode) уже вне приложения.
+class BinaryLogger : public ILogger {
+ public:
+  // Конструктор: создаёт двоичный лог-файл (существующий
+  // перезаписывается: ID форматов действуют в пределах
+  // одного процесса)
+  explicit BinaryLogger(const std::string &filename,
+                        LogLevel level = LogLevel::Info);
+
+  // Деструктор: сбрасывает буфер и закрывает файл
+  ~BinaryLogger();
+
+  // Записывает готовую строку (формат "{}")
+  void log(const std::string &message,
+           LogLevel level) override;
+
+  // Записывает сообщение с форматом id и аргументами без
+  // форматирования. Обычно вызывается через
+  // LOGGER_BINARY_LOG, который назначает id статически.
+  template <typename... Args>
+  void logFormat(LogLevel level, std::uint32_t id,
+                 const char * /*fmt*/, const Args &...args) {
+    if (!isEnabled(level))
+      return;
+    std::string &encoded = argBuffer();
+    encoded.clear();
+    (binlog::encodeArg(encoded, args), ...);
+    writeEntry(level, id, encoded);
+  }
+
+  // Вариант без макроса: ID находится по строке формата в
+  // реестре на каждом вызове (медленнее, чем макрос)
+  template <typename... Args>
+  void logf(LogLevel level, const char *fmt,
+            const Args &...args) {
+    if (!isEnabled(level))
+      return;
+    logFormat(level, FormatRegistry::instance().intern(fmt),
+              fmt, args...);
+  }
+
+  // Устанавливает текущий уровень логирования
+  void setLogLevel(LogLevel level) override;
+
+  // Возвращает текущий уровень логирования
+  LogLevel getLogLevel() const override;
+
+  // Сбрасывает буфер файла на диск
+  void flush();
+
+ private:
+  // Буфер кодирования аргументов (свой в каждом потоке)
+  static std::string &argBuffer();
+
+  // Записывает запись сообщения (и запись формата, если
+  // этот ID ещё не встречался в файле)
+  void writeEntry(LogLevel level, std::uint32_t id,
+                  const std::string &args);
+
+  std::ofstream file_;  // Двоичный лог-файл
+  std::mutex mutex_;  // Мьютекс записи
+  std::vector<bool>
+    written_;  // ID, чьи форматы уже записаны в файл
+};
+
+}  // namespace logger
+
+// Логирование в BinaryLogger с отложенным форматированием:
+//   LOGGER_BINARY_LOG(log, LogLevel::Info, "user {} took {} ms",
+//                     userId, elapsed);
+// ID строки формата вычисляется один раз на место вызова;
+// уровни ниже LOGGER_MIN_LEVEL вырезаются как в LOGGER_LOG.
+#define LOGGER_BINARY_LOG(binaryLogger, level, ...)          \
+  do {                                                       \
+    if constexpr (static_cast<int>(level)                    \
+                  <= LOGGER_MIN_LEVEL) {                     \
+      if ((binaryLogger).isEnabled(level)) {                 \
+        static const std::uint32_t logger_format_id_         \
+          = ::logger::FormatRegistry::instance().intern(     \
+            ::logger::binlog::formatOf(__VA_ARGS__));        \
+        (binaryLogger)                                       \
+          .logFormat(level, logger_format_id_, __VA_ARGS__); \
+      }                                                      \
+    }                                                        \
+  } while (0)
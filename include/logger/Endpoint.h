@@ -0,0 +1,63 @@
+#pragma once  // Защита от повторного включения
+              // заголовочного файла
+
+#include <sys/socket.h>  // Для sockaddr_storage, socklen_t
+
+#include <string>  // Для адреса и пути
+
+namespace logger {
+
+// Транспорт между SocketLogger и log_stats
+enum class Transport {
+  Tcp,  // AF_INET, поток
+  Udp,  // AF_INET, датаграммы (без подтверждения доставки)
+  UnixStream,  // AF_UNIX, поток (тот же хост)
+  UnixDatagram  // AF_UNIX, датаграммы (тот же хост)
+};
+
+// Адрес сервера логов. Для Tcp/Udp используются host и
+// port, для Unix* — path
+struct Endpoint {
+  Transport transport = Transport::Tcp;
+  std::string host = "127.0.0.1";  // IPv4-адрес
+  int port = 5000;  // Порт
+  std::string path;  // Путь сокета AF_UNIX
+
+  // Сетевой транспорт (host и port, а не path)
+  bool isInet() const {
+    return transport == Transport::Tcp
+           || transport == Transport::Udp;
+  }
+
+  // Потоковый транспорт (соединение, рукопожатие, кадры)
+  bool isStream() const {
+    return transport == Transport::Tcp
+           || transport == Transport::UnixStream;
+  }
+
+  static Endpoint tcp(const std::string &host, int port);
+  static Endpoint udp(const std::string &host, int port);
+  static Endpoint unixStream(const std::string &path);
+  static Endpoint unixDatagram(const std::string &path);
+};
+
+// Разбирает строку адреса:
+//   tcp://127.0.0.1:5000    udp://127.0.0.1:5001
+//   unix:/tmp/log.sock      unixgram:/tmp/log.dgram
+// Возвращает false, если строка не распознана
+bool parseEndpoint(const std::string &spec, Endpoint &out);
+
+// Строка адреса в формате parseEndpoint
+std::string toString(const Endpoint &endpoint);
+
+// Заполняет адрес для connect/bind; false — адрес
+// некорректен (не IPv4 или слишком длинный путь)
+bool toSockaddr(const Endpoint &endpoint,
+                sockaddr_storage &addr, socklen_t &len);
+
+// Создаёт сокет нужного семейства и типа (с SOCK_CLOEXEC,
+// по умолчанию неблокирующий); -1 при ошибке
+int openSocket(const Endpoint &endpoint,
+               bool nonBlocking = true);
+
+}  // namespace logger
@@ -0,0 +1,164 @@
+#pragma once  // Защита от повторного включения
+              // заголовочного файла
+
+#include <cstddef>  // Для std::size_t
+#include <cstdint>  // Для целых фиксированной ширины
+#include <string>  // Для буфера кадров
+#include <string_view>  // Для полезной нагрузки кадра
+
+#include "LogLevel.h"  // Уровни логирования
+
+namespace logger::frame {
+
+// Протокол кадров между SocketLogger и log_stats (включается
+// клиентом; по умолчанию используется текстовый протокол).
+//
+// Рукопожатие: клиент сразу после подключения отправляет
+// строку "LOGFRAME <версия>\n". Сервер, поддерживающий
+// версию, отвечает "LOGFRAME <версия> OK\n", и дальше по
+// соединению идут кадры. Если ответа нет (старый сервер)
+// или он другой, клиент продолжает текстовым протоколом.
+//
+// Кадр (целые — в сетевом порядке байт):
+//   uint32 длина остатка кадра (1 + 8 + N)
+//   uint8  уровень (значение LogLevel)
+//   int64  время записи, наносекунды от эпохи
+//   N байт сообщения (может содержать '\n')
+
+constexpr std::uint32_t kVersion = 1;
+constexpr char kHelloPrefix[] = "LOGFRAME ";
+constexpr std::size_t kHelloPrefixLength
+  = sizeof(kHelloPrefix) - 1;
+
+// Размер заголовка кадра после поля длины
+constexpr std::size_t kFixedBody = 1 + 8;
+
+// Предел длины кадра: всё больше считается ошибкой потока
+constexpr std::uint32_t kMaxFrameBody = 16 * 1024 * 1024;
+
+// Строка приветствия клиента
+inline std::string helloLine(
+  std::uint32_t version = kVersion) {
+  return kHelloPrefix + std::to_string(version) + "\n";
+}
+
+// Ответ сервера, принявшего версию
+inline std::string ackLine(
+  std::uint32_t version = kVersion) {
+  return kHelloPrefix + std::to_string(version) + " OK\n";
+}
+
+// Разбирает строку приветствия (без '\n'); возвращает
+// версию или 0, если это не приветствие
+inline std::uint32_t parseHello(std::string_view line) {
+  if (line.substr(0, kHelloPrefixLength) != kHelloPrefix)
+    return 0;
+  std::uint32_t version = 0;
+  for (char c : line.substr(kHelloPrefixLength)) {
+    if (c < '0' || c > '9' || version > 1000000)
+      return 0;
+    version = version * 10
+              + static_cast<std::uint32_t>(c - '0');
+  }
+  return version;
+}
+
+// Дописывает value в out старшими байтами вперёд
+template <typename T>
+void appendBigEndian(std::string &out, T value) {
+  auto bits = static_cast<std::uint64_t>(value);
+  for (int shift = static_cast<int>(sizeof(T) * 8) - 8;
+       shift >= 0; shift -= 8) {
+    out += static_cast<char>((bits >> shift) & 0xFF);
+  }
+}
+
+// Читает целое из len байт, записанных старшими вперёд
+inline std::uint64_t readBigEndian(const char *data,
+                                   std::size_t len) {
+  std::uint64_t value = 0;
+  for (std::size_t i = 0; i < len; ++i) {
+    value = (value << 8)
+            | static_cast<unsigned char>(data[i]);
+  }
+  return value;
+}
+
+// Дописывает кадр в out
+inline void appendFrame(std::string &out, LogLevel level,
+                        std::int64_t timestampNs,
+                        std::string_view message) {
+  appendBigEndian(out, static_cast<std::uint32_t>(
+                         kFixedBody + message.size()));
+  out += static_cast<char>(level);
+  appendBigEndian(out, timestampNs);
+  out.append(message.data(), message.size());
+}
+
+// Разобранный кадр. payload указывает в буфер декодера и
+// действителен до следующего вызова feed()
+struct Frame {
+  LogLevel level;  // Уровень
+  std::int64_t timestampNs;  // Время записи
+  std::string_view payload;  // Сообщение
+};
+
+// Потоковый декодер кадров: принимает байты в любом
+// разбиении и выдаёт целые кадры без поиска разделителей
+class FrameDecoder {
+ public:
+  // Добавляет принятые байты
+  void feed(const char *data, std::size_t len) {
+    if (pos_ > 0 && pos_ == buffer_.size()) {
+      buffer_.clear();
+      pos_ = 0;
+    } else if (pos_ > buffer_.size() / 2) {
+      buffer_.erase(0, pos_);  // Сдвигаем необработанный
+      pos_ = 0;                // хвост в начало
+    }
+    buffer_.append(data, len);
+  }
+
+  // Извлекает следующий целый кадр; false — данных пока
+  // недостаточно или поток повреждён (см. failed())
+  bool next(Frame &out) {
+    if (failed_ || buffer_.size() - pos_ < 4)
+      return false;
+    auto body = static_cast<std::uint32_t>(
+      readBigEndian(buffer_.data() + pos_, 4));
+    if (body < kFixedBody || body > kMaxFrameBody) {
+      failed_ = true;
+      return false;
+    }
+    if (buffer_.size() - pos_ < 4 + body)
+      return false;
+
+    const char *p = buffer_.data() + pos_ + 4;
+    auto level = static_cast<unsigned char>(p[0]);
+    out.level = level <= static_cast<unsigned char>(
+                  LogLevel::Info)
+                  ? static_cast<LogLevel>(level)
+                  : LogLevel::Info;
+    out.timestampNs = static_cast<std::int64_t>(
+      readBigEndian(p + 1, 8));
+    out.payload = std::string_view(p + kFixedBody,
+                                   body - kFixedBody);
+    pos_ += 4 + body;
+    return true;
+  }
+
+  // Поток повреждён (неверная длина кадра)
+  bool failed() const { return failed_; }
+
+  // Необработанные байты (неполный кадр)
+  std::size_t pending() const {
+    return buffer_.size() - pos_;
+  }
+
+ private:
+  std::string buffer_;  // Принятые байты
+  std::size_t pos_ = 0;  // Начало необработанных данных
+  bool failed_ = false;  // Поток повреждён
+};
+
+}  // namespace logger::frame
@@ -1,9 +1,12 @@
 #pragma once  // Гарантирует, что заголовочный файл будет
               // включён только один раз при компиляции
 
+#include <atomic>  // Для атомарного порога уровня
+#include <cstddef>  // Для std::size_t
 #include <string>  // Для использования std::string
 
 #include "LogLevel.h"  // Определение перечисления LogLevel
+#include "LogMessage.h"  // Определение структуры LogMessage
 
 namespace logger {
 
@@ -21,11 +24,48 @@ class ILogger {
                    LogLevel level)
     = 0;
 
+  // Логирует пачку из count сообщений. Реализация по
+  // умолчанию вызывает log() для каждого сообщения;
+  // логгеры переопределяют её, чтобы выполнить одну
+  // запись/отправку на всю пачку
+  virtual void logBatch(const LogMessage *messages,
+                        std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+      log(messages[i].text, messages[i].level);
+    }
+  }
+
   // Устанавливает текущий уровень логирования
   virtual void setLogLevel(LogLevel level) = 0;
 
   // Возвращает текущий установленный уровень логирования
   virtual LogLevel getLogLevel() const = 0;
+
+  // Быстрая проверка уровня до построения сообщения: одно
+  // relaxed-чтение атомарного порога без виртуального
+  // вызова и блокировок. Используется макросами LOGGER_LOG
+  bool isEnabled(LogLevel level) const {
+    return level <= threshold_.load(std::memory_order_relaxed);
+  }
+
+ protected:
+  // Конструктор с начальным уровнем логирования
+  explicit ILogger(LogLevel level = LogLevel::Info)
+      : threshold_(level) {}
+
+  // Публикует уровень логирования для isEnabled();
+  // логгеры вызывают его из setLogLevel()
+  void storeLevel(LogLevel level) {
+    threshold_.store(level, std::memory_order_relaxed);
+  }
+
+  // Текущий опубликованный уровень логирования
+  LogLevel loadLevel() const {
+    return threshold_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  std::atomic<LogLevel> threshold_;  // Порог уровня
 };
 
 }  // namespace logger
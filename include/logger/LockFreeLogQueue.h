@@ -0,0 +1,282 @@
+#pragma once  // Защита от повторного включения
+              // заголовочного файла
+
+#include <atomic>  // Для атомарных позиций и номеров ячеек
+#include <chrono>  // Для таймаута ожидания пачки
+#include <condition_variable>  // Для сна потребителя
+#include <cstddef>  // Для size_t и ptrdiff_t
+#include <memory>  // Для std::unique_ptr
+#include <mutex>  // Для мьютекса ожидания потребителя
+#include <optional>  // Для безопасного возвращения пустого значения
+#include <thread>  // Для std::this_thread::yield
+#include <vector>  // Для выдачи пачки сообщений
+
+#include "LogMessage.h"  // Для определения LogMessage
+
+namespace logger {
+
+// Размер кэш-линии, по которому выравниваются счётчики и
+// ячейки кольца (избегаем false sharing между потоками)
+constexpr std::size_t kCacheLineSize = 64;
+
+// Ограниченная lock-free очередь с несколькими
+// производителями и одним потребителем (MPSC) на основе
+// кольцевого буфера с номерами последовательности в каждой
+// ячейке (схема Д. Вьюкова). Контракт совпадает с
+// LogQueue: push(), блокирующий pop(), popBatch(),
+// drainAll() и close().
+//
+// Производители не берут мьютекс: место в кольце
+// захватывается одним CAS по хвосту. Потребитель засыпает
+// на условной переменной только после короткого ожидания
+// впустую, и производитель будит его лишь тогда, когда он
+// действительно спит.
+//
+// После close() потребитель дочитывает все ячейки до
+// хвоста, в том числе захваченные, но ещё не
+// опубликованные производителем, поэтому сообщение push(),
+// вернувшегося до close(), не теряется. Сообщение push(),
+// идущего одновременно с close(), может остаться в кольце
+// непрочитанным, если захватило место уже после того, как
+// потребитель дочитал очередь.
+class LockFreeLogQueue {
+ public:
+  // Ёмкость очереди по умолчанию (в сообщениях)
+  static constexpr std::size_t kDefaultCapacity = 8192;
+
+  // Конструктор: ёмкость округляется вверх до степени двойки
+  explicit LockFreeLogQueue(
+    std::size_t capacity = kDefaultCapacity)
+      : capacity_(roundUpToPowerOfTwo(capacity)),
+        mask_(capacity_ - 1),
+        slots_(new Slot[capacity_]) {
+    for (std::size_t i = 0; i < capacity_; ++i) {
+      slots_[i].seq.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  LockFreeLogQueue(const LockFreeLogQueue &) = delete;
+  LockFreeLogQueue &operator=(const LockFreeLogQueue &)
+    = delete;
+
+  // Добавляет сообщение в очередь. Если очередь заполнена —
+  // ждёт освобождения места. После close() сообщение,
+  // которому не хватило места, отбрасывается.
+  void push(const LogMessage &msg) {
+    unsigned spins = 0;
+    while (!tryPush(msg)) {
+      if (closed_.load(std::memory_order_acquire))
+        return;
+      backoff(spins);
+    }
+  }
+
+  // Пытается добавить сообщение без ожидания. Возвращает
+  // false, если очередь заполнена.
+  bool tryPush(const LogMessage &msg) {
+    std::size_t pos
+      = tail_.value.load(std::memory_order_relaxed);
+    Slot *slot = nullptr;
+    while (true) {
+      slot = &slots_[pos & mask_];
+      std::size_t seq
+        = slot->seq.load(std::memory_order_acquire);
+      auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+      if (diff == 0) {
+        // Ячейка свободна — пытаемся захватить позицию
+        if (tail_.value.compare_exchange_weak(
+              pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;  // Кольцо заполнено
+      } else {
+        // Другой производитель успел раньше — перечитываем
+        pos = tail_.value.load(std::memory_order_relaxed);
+      }
+    }
+
+    slot->msg = msg;
+    // Публикуем ячейку для потребителя
+    slot->seq.store(pos + 1, std::memory_order_release);
+    wakeConsumer();
+    return true;
+  }
+
+  // Извлекает сообщение из очереди (блокирует, если очередь
+  // пуста). Возвращает std::nullopt, если очередь закрыта и
+  // пуста. Должен вызываться только одним потоком.
+  std::optional<LogMessage> pop() {
+    while (true) {
+      if (auto msg = tryPop())
+        return msg;
+      if (closed_.load(std::memory_order_acquire))
+        return popClaimed();
+      waitForData();
+    }
+  }
+
+  // Извлекает до max сообщений, ожидая не дольше timeout
+  // появления первого. Содержимое out заменяется пачкой.
+  // Возвращает false, если очередь закрыта и пуста.
+  bool popBatch(std::vector<LogMessage> &out,
+                std::size_t max,
+                std::chrono::milliseconds timeout) {
+    out.clear();
+    if (!ready() && !closed_.load(std::memory_order_acquire))
+      waitForData(std::chrono::steady_clock::now()
+                  + timeout);
+
+    bool closed = closed_.load(std::memory_order_acquire);
+    while (out.size() < max) {
+      auto msg = closed ? popClaimed() : tryPop();
+      if (!msg)
+        break;
+      out.push_back(std::move(*msg));
+    }
+    return !out.empty() || !closed;
+  }
+
+  // Забирает все опубликованные сообщения без ожидания
+  // (после close() — и захваченные, дожидаясь их
+  // публикации). Возвращает их количество.
+  std::size_t drainAll(std::vector<LogMessage> &out) {
+    out.clear();
+    bool closed = closed_.load(std::memory_order_acquire);
+    while (auto msg = closed ? popClaimed() : tryPop()) {
+      out.push_back(std::move(*msg));
+    }
+    return out.size();
+  }
+
+  // Извлекает сообщение без ожидания (только потребитель)
+  std::optional<LogMessage> tryPop() {
+    Slot &slot = slots_[head_.value & mask_];
+    std::size_t seq
+      = slot.seq.load(std::memory_order_acquire);
+    if (seq != head_.value + 1)
+      return std::nullopt;  // Ячейка ещё не опубликована
+
+    std::optional<LogMessage> msg(std::move(slot.msg));
+    // Освобождаем ячейку для следующего круга кольца
+    slot.seq.store(head_.value + capacity_,
+                   std::memory_order_release);
+    ++head_.value;
+    return msg;
+  }
+
+  // Закрывает очередь — потребитель будет разбужен
+  void close() {
+    closed_.store(true, std::memory_order_release);
+    std::lock_guard<std::mutex> lock(waitMutex_);
+    cv_.notify_all();
+  }
+
+  // Возвращает ёмкость кольца
+  std::size_t capacity() const { return capacity_; }
+
+ private:
+  // Ячейка кольца, выровненная по кэш-линии
+  struct alignas(kCacheLineSize) Slot {
+    std::atomic<std::size_t>
+      seq{0};  // Номер последовательности ячейки
+    LogMessage msg;  // Хранимое сообщение
+  };
+
+  // Счётчик, занимающий отдельную кэш-линию
+  template <typename T>
+  struct alignas(kCacheLineSize) Padded {
+    T value{};
+  };
+
+  static std::size_t roundUpToPowerOfTwo(std::size_t n) {
+    std::size_t result = 2;
+    while (result < n)
+      result <<= 1;
+    return result;
+  }
+
+  // Извлекает сообщение после close(): пока голова не
+  // догнала хвост, ячейка под ней захвачена производителем,
+  // который вот-вот её опубликует, — ждём его.
+  // std::nullopt — очередь дочитана
+  std::optional<LogMessage> popClaimed() {
+    unsigned spins = 0;
+    while (head_.value
+           != tail_.value.load(std::memory_order_acquire)) {
+      if (auto msg = tryPop())
+        return msg;
+      backoff(spins);
+    }
+    return std::nullopt;
+  }
+
+  // Проверяет, опубликована ли ячейка под головой очереди
+  bool ready() const {
+    return slots_[head_.value & mask_].seq.load(
+             std::memory_order_acquire)
+           == head_.value + 1;
+  }
+
+  // Короткое активное ожидание, затем уступаем процессор
+  static void backoff(unsigned &spins) {
+    if (++spins > kSpinLimit)
+      std::this_thread::yield();
+  }
+
+  // Ожидание данных потребителем: сначала крутимся, затем
+  // засыпаем на условной переменной (не дольше deadline)
+  void waitForData(
+    std::chrono::steady_clock::time_point deadline
+    = std::chrono::steady_clock::time_point::max()) {
+    for (unsigned i = 0; i < kSpinLimit; ++i) {
+      if (ready() || closed_.load(std::memory_order_acquire))
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(waitMutex_);
+    consumerSleeping_.store(true,
+                            std::memory_order_relaxed);
+    // Парный барьер с wakeConsumer(): либо производитель
+    // увидит флаг сна, либо мы увидим его ячейку
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto wakeUp = [this] {
+      return ready()
+             || closed_.load(std::memory_order_acquire);
+    };
+    if (deadline == std::chrono::steady_clock::time_point::max())
+      cv_.wait(lock, wakeUp);
+    else
+      cv_.wait_until(lock, deadline, wakeUp);
+    consumerSleeping_.store(false,
+                            std::memory_order_relaxed);
+  }
+
+  // Будит потребителя, только если он спит
+  void wakeConsumer() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (consumerSleeping_.load(std::memory_order_relaxed)) {
+      std::lock_guard<std::mutex> lock(waitMutex_);
+      cv_.notify_one();
+    }
+  }
+
+  static constexpr unsigned kSpinLimit = 64;
+
+  const std::size_t capacity_;  // Ёмкость (степень двойки)
+  const std::size_t mask_;  // Маска для индекса в кольце
+  std::unique_ptr<Slot[]> slots_;  // Ячейки кольца
+
+  Padded<std::atomic<std::size_t>>
+    tail_;  // Позиция записи (общая для производителей)
+  Padded<std::size_t>
+    head_;  // Позиция чтения (только потребитель)
+  alignas(kCacheLineSize) std::atomic<bool>
+    consumerSleeping_{false};  // Потребитель спит на cv_
+  std::atomic<bool> closed_{false};  // Флаг закрытия
+  std::mutex waitMutex_;  // Мьютекс для сна потребителя
+  std::condition_variable
+    cv_;  // Условная переменная для сна потребителя
+};
+
+}  // namespace logger
@@ -9,4 +9,18 @@ namespace logger {
 // Info    — информационные сообщения общего характера
 enum class LogLevel { Error = 0, Warning = 1, Info = 2 };
 
+// Возвращает имя уровня в том виде, в каком оно пишется в
+// строку лога: "ERROR", "WARNING" или "INFO"
+inline const char *logLevelName(LogLevel level) {
+  switch (level) {
+    case LogLevel::Error:
+      return "ERROR";
+    case LogLevel::Warning:
+      return "WARNING";
+    case LogLevel::Info:
+      return "INFO";
+  }
+  return "UNKNOWN";
+}
+
 }  // namespace logger
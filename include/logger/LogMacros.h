@@ -0,0 +1,63 @@
+#pragma once  // Защита от повторного включения
+              // заголовочного файла
+
+#include <type_traits>  // Для std::is_invocable_v
+#include <utility>  // Для std::forward
+
+#include "ILogger.h"  // Интерфейс логгера и isEnabled()
+
+// Числовые значения уровней для препроцессора (совпадают с
+// LogLevel)
+#define LOGGER_LEVEL_ERROR 0
+#define LOGGER_LEVEL_WARNING 1
+#define LOGGER_LEVEL_INFO 2
+
+// Наименее важный уровень, который остаётся в программе.
+// Вызовы менее важных уровней вырезаются при компиляции.
+// Задаётся через CMake: -DLOGGER_MIN_LEVEL=warning
+#ifndef LOGGER_MIN_LEVEL
+#define LOGGER_MIN_LEVEL LOGGER_LEVEL_INFO
+#endif
+
+namespace logger::detail {
+
+// Сообщение макроса: строка используется как есть, а
+// вызываемый объект (лямбда) вызывается только здесь —
+// после того как проверка уровня прошла
+template <typename Message>
+decltype(auto) materialize(Message &&message) {
+  if constexpr (std::is_invocable_v<Message &>) {
+    return std::forward<Message>(message)();
+  } else {
+    return std::forward<Message>(message);
+  }
+}
+
+}  // namespace logger::detail
+
+// Логирование с проверкой уровня до построения сообщения:
+//   LOGGER_LOG(log, LogLevel::Info, "user " + name);
+//   LOGGER_LOG(log, LogLevel::Info, [&] { return dump(); });
+// level должен быть константой. Уровни ниже LOGGER_MIN_LEVEL
+// отбрасываются через if constexpr (код не генерируется, но
+// выражение проверяется компилятором). Для остальных
+// выражение вычисляется только если isEnabled(level) —
+// одно relaxed-чтение и предсказуемый переход.
+#define LOGGER_LOG(loggerRef, level, ...)                    \
+  do {                                                       \
+    if constexpr (static_cast<int>(level)                    \
+                  <= LOGGER_MIN_LEVEL) {                     \
+      if ((loggerRef).isEnabled(level)) {                    \
+        (loggerRef).log(                                     \
+          ::logger::detail::materialize(__VA_ARGS__), level); \
+      }                                                      \
+    }                                                        \
+  } while (0)
+
+#define LOGGER_ERROR(loggerRef, ...) \
+  LOGGER_LOG(loggerRef, ::logger::LogLevel::Error, __VA_ARGS__)
+#define LOGGER_WARNING(loggerRef, ...)                      \
+  LOGGER_LOG(loggerRef, ::logger::LogLevel::Warning,        \
+             __VA_ARGS__)
+#define LOGGER_INFO(loggerRef, ...) \
+  LOGGER_LOG(loggerRef, ::logger::LogLevel::Info, __VA_ARGS__)
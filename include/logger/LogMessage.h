@@ -0,0 +1,17 @@
+#pragma once  // Защита от повторного включения
+              // заголовочного файла
+
+#include <string>  // Для std::string
+
+#include "LogLevel.h"  // Перечисление уровней логирования
+
+namespace logger {
+
+// Структура, представляющая лог-сообщение с текстом и
+// уровнем
+struct LogMessage {
+  std::string text;  // Текст сообщения
+  LogLevel level;  // Уровень логирования
+};
+
+}  // namespace logger
@@ -1,10 +1,13 @@
 #pragma once  // Защита от повторного включения
               // заголовочного файла
 
+#include <chrono>  // Для таймаута ожидания пачки
 #include <condition_variable>  // Для синхронизации потоков
+#include <cstddef>  // Для std::size_t
+#include <deque>  // Для хранения лог-сообщений
 #include <mutex>  // Для блокировки доступа к очереди
 #include <optional>  // Для безопасного возвращения пустого значения
-#include <queue>  // Для хранения лог-сообщений
+#include <vector>  // Для выдачи пачки сообщений
 
 #include "Logger.h"  // Для определения LogMessage
 
@@ -12,14 +15,15 @@ namespace logger {
 
 // Класс потокобезопасной очереди сообщений для передачи
 // логов между потоками. Поддерживает push(), pop() с
-// блокировкой, и закрытие очереди через close().
+// блокировкой, пакетное извлечение popBatch()/drainAll() и
+// закрытие очереди через close().
 class LogQueue {
  public:
   // Добавляет сообщение в очередь и уведомляет ожидающий
   // поток
   void push(const LogMessage &msg) {
     std::lock_guard<std::mutex> lock(m_);
-    q_.push(msg);
+    q_.push_back(msg);
     cv_.notify_one();  // Пробуждает один поток, ожидающий
                        // сообщение
   }
@@ -37,11 +41,58 @@ class LogQueue {
     if (q_.empty() && closed_)
       return std::nullopt;  // Если очередь пуста и закрыта
                             // — завершение
-    auto msg = q_.front();  // Получаем первое сообщение
-    q_.pop();  // Удаляем его из очереди
+    auto msg = std::move(
+      q_.front());  // Получаем первое сообщение
+    q_.pop_front();  // Удаляем его из очереди
     return msg;
   }
 
+  // Извлекает до max сообщений за одно взятие блокировки.
+  // Ждёт не дольше timeout, пока в очереди не появятся
+  // сообщения. Содержимое out заменяется извлечённой
+  // пачкой (она может быть пустой по таймауту). Возвращает
+  // false, если очередь закрыта и пуста.
+  bool popBatch(std::vector<LogMessage> &out,
+                std::size_t max,
+                std::chrono::milliseconds timeout) {
+    out.clear();
+    std::deque<LogMessage> batch;
+    {
+      std::unique_lock<std::mutex> lock(m_);
+      cv_.wait_for(lock, timeout, [this] {
+        return !q_.empty() || closed_;
+      });
+
+      if (q_.empty())
+        return !closed_;
+
+      if (q_.size() <= max) {
+        batch.swap(q_);  // Забираем весь накопленный хвост
+      } else {
+        for (std::size_t i = 0; i < max; ++i) {
+          batch.push_back(std::move(q_.front()));
+          q_.pop_front();
+        }
+      }
+    }
+    moveTo(batch, out);
+    return true;
+  }
+
+  // Забирает все накопленные сообщения без ожидания.
+  // Содержимое out заменяется извлечёнными сообщениями.
+  // Возвращает их количество.
+  std::size_t drainAll(std::vector<LogMessage> &out) {
+    out.clear();
+    std::deque<LogMessage> batch;
+    {
+      std::lock_guard<std::mutex> lock(m_);
+      batch.swap(q_);
+    }
+    moveTo(batch, out);
+    return out.size();
+  }
+
   // Закрывает очередь — все ожидающие потоки будут
   // разбужены
   void close() {
@@ -52,7 +103,17 @@ class LogQueue {
   }
 
  private:
-  std::queue<LogMessage> q_;  // Очередь лог-сообщений
+  // Перемещает сообщения пачки в выходной вектор (вне
+  // блокировки)
+  static void moveTo(std::deque<LogMessage> &batch,
+                     std::vector<LogMessage> &out) {
+    out.reserve(batch.size());
+    for (auto &msg : batch) {
+      out.push_back(std::move(msg));
+    }
+  }
+
+  std::deque<LogMessage> q_;  // Очередь лог-сообщений
   std::mutex m_;  // Мьютекс для синхронизации доступа
   std::condition_variable
     cv_;  // Условная переменная для ожидания
@@ -1,57 +1,269 @@
 #pragma once  // Защита от повторного включения
               // заголовочного файла
 
+#include <atomic>  // Для номеров сообщений
 #include <chrono>  // Для работы с временными метками
+#include <condition_variable>  // Для фонового сброса
+#include <cstddef>  // Для std::size_t
+#include <cstdint>  // Для std::uint64_t
 #include <ctime>  // Для преобразования времени
 #include <fstream>  // Для записи в файл
+#include <memory>  // Для подмены открытого файла при ротации
 #include <mutex>  // Для синхронизации доступа к лог-файлу
 #include <string>  // Для std::string
+#include <thread>  // Для потока фонового сброса
+#include <vector>  // Для пользовательского буфера файла
 
-#include "ILogger.h"   // Интерфейс логгера
-#include "LogLevel.h"  // Перечисление уровней логирования
+#include "ILogger.h"     // Интерфейс логгера
+#include "LogLevel.h"    // Перечисление уровней логирования
+#include "LogMessage.h"  // Структура LogMessage
+#include "Timestamp.h"   // Форматтер меток времени
 
 namespace logger {
 
-// Структура, представляющая лог-сообщение с текстом и
-// уровнем
-struct LogMessage {
-  std::string text;  // Текст сообщения
-  LogLevel level;  // Уровень логирования
+// Политика сброса буфера лог-файла на диск. Условия
+// объединяются: сброс выполняется, если сработало любое из
+// включённых. Если все выключены, данные сбрасываются
+// только при заполнении буфера, вызове flush() и в
+// деструкторе.
+struct FlushPolicy {
+  bool eachMessage
+    = true;  // Сброс после каждой записи (как std::endl)
+  std::size_t everyBytes
+    = 0;  // Сброс после накопления N байт (0 — выключено)
+  std::chrono::milliseconds interval{
+    0};  // Фоновый сброс каждые T мс (0 — выключено)
+  bool onError
+    = false;  // Немедленный сброс на LogLevel::Error
+};
+
+// Политика ротации лог-файла. Ротация срабатывает по
+// размеру текущего файла или по интервалу времени (что
+// наступит раньше). Закрытый сегмент переименовывается в
+// "<файл>.<ГГГГММДД-ЧЧММСС>-<N>", при необходимости
+// сжимается в .gz и удаляется по правилам хранения — всё
+// это выполняет фоновый поток, а не вызывающие log().
+// Пустой файл не ротируется. После неудачной ротации
+// (например, rename запрещён) ротация по размеру
+// возобновляется только через retryDelay, чтобы каждая
+// запись не повторяла ошибку.
+struct RotationPolicy {
+  std::size_t maxBytes
+    = 0;  // Размер файла для ротации (0 — выключено)
+  std::chrono::seconds interval{
+    0};  // Интервал ротации (0 — выключено)
+  std::size_t maxFiles
+    = 0;  // Сколько сегментов хранить (0 — без предела)
+  std::chrono::seconds maxAge{
+    0};  // Максимальный возраст сегмента (0 — без предела)
+  bool compress = false;  // Сжимать сегменты в gzip
+                          // (если собрано с zlib)
+  std::chrono::milliseconds retryDelay{
+    1000};  // Пауза перед повтором ротации по размеру
+            // после неудачи (удваивается до минуты)
+};
+
+// Поточные буферы (staging). Каждый поток форматирует
+// строки в собственный буфер без общей блокировки; буфер,
+// достигший bufferBytes (или содержащий ошибку при
+// FlushPolicy::onError), передаётся фоновому писателю —
+// под общим мьютексом выполняется только перенос строки.
+// Недозаполненные буферы писатель забирает раз в
+// collectInterval, а также flush() и деструктор. Порядок
+// строк одного потока сохраняется; строки разных потоков
+// перемежаются блоками.
+struct StagingPolicy {
+  bool enabled = false;  // Включить поточные буферы
+  std::size_t bufferBytes
+    = 16 * 1024;  // Порог передачи буфера писателю
+  std::chrono::milliseconds collectInterval{
+    50};  // Период сбора недозаполненных буферов
+};
+
+// Параметры файлового логгера
+struct LoggerOptions {
+  FlushPolicy flush;  // Политика сброса
+  RotationPolicy rotation;  // Политика ротации
+  StagingPolicy staging;  // Поточные буферы
+  bool sequenceNumbers
+    = false;  // Префикс "#N " — глобальный номер
+              // сообщения для слияния вывода по порядку
+  std::size_t bufferSize
+    = 64 * 1024;  // Размер буфера потока в байтах
+                  // (0 — буфер библиотеки по умолчанию)
+  TimestampFormatter timestamp;  // Формат меток времени
 };
 
 // Реализация логгера, записывающего сообщения в файл
 class Logger : public ILogger {
  public:
-  // Конструктор: принимает имя файла и уровень логирования
-  // по умолчанию
+  // Конструктор: принимает имя файла, уровень логирования
+  // по умолчанию и параметры буферизации
   explicit Logger(const std::string &filename,
-                  LogLevel level = LogLevel::Info);
+                  LogLevel level = LogLevel::Info,
+                  LoggerOptions options = LoggerOptions());
 
-  // Деструктор: закрывает файл
+  // Деструктор: останавливает фоновый сброс, сбрасывает
+  // буфер и закрывает файл
   ~Logger();
 
   // Записывает сообщение в лог, если уровень >= текущего
   void log(const std::string &message,
            LogLevel level) override;
 
+  // Записывает пачку сообщений одной операцией записи и
+  // одним сбросом буфера
+  void logBatch(const LogMessage *messages,
+                std::size_t count) override;
+
   // Устанавливает текущий уровень логирования
   void setLogLevel(LogLevel level) override;
 
   // Возвращает текущий уровень логирования
   LogLevel getLogLevel() const override;
 
+  // Дописывает поточные буферы и принудительно сбрасывает
+  // буфер на диск
+  void flush();
+
+  // Выполняет ротацию немедленно и ждёт, пока фоновый поток
+  // не закончит сжатие и очистку старых сегментов. Требует
+  // включённой ротации (иначе ничего не делает). Возвращает
+  // false, если ротация не удалась (файл не переименован
+  // или новый не открыт) или ротация выключена.
+  bool rotate();
+
+  // Возвращает true, если библиотека собрана с zlib и
+  // RotationPolicy::compress действует
+  static bool compressionSupported();
+
  private:
-  // Возвращает текущую дату и время в строковом формате
-  // "YYYY-MM-DD HH:MM:SS"
-  std::string getCurrentTime() const;
+  // Открытый лог-файл вместе с собственным буфером потока
+  struct LogFile {
+    std::vector<char> buffer;  // Буфер потока
+    std::ofstream stream;  // Поток записи
+  };
+
+  // Буфер одного потока-производителя. Мьютекс буфера
+  // берут только его поток и сборщик недозаполненных
+  // буферов, поэтому он практически не конкурентный
+  struct Stage {
+    std::mutex mutex;  // Мьютекс буфера
+    std::string data;  // Отформатированные строки
+    LogLevel mostSevere
+      = LogLevel::Info;  // Самый важный уровень в data
+    std::atomic<bool> closed{false};  // Логгер уничтожен
+  };
+
+  // Блок строк, переданный писателю
+  struct StagedChunk {
+    std::string text;  // Строки лога
+    LogLevel mostSevere;  // Самый важный уровень в блоке
+  };
+
+  // Возвращает буфер текущего потока (создаёт его при
+  // первом обращении)
+  Stage &stage();
+
+  // Передаёт содержимое буфера писателю (вызывается под
+  // stage.mutex)
+  void handOff(Stage &stage);
+
+  // Забирает недозаполненные буферы всех потоков
+  void collectStages();
+
+  // Записывает переданные блоки в файл
+  void writeStaged();
+
+  // Цикл фонового писателя поточных буферов
+  void runStagingWriter();
+
+  // Открывает файл filename_ в режиме добавления
+  std::unique_ptr<LogFile> openFile() const;
+
+  // Цикл фонового потока ротации
+  void runRotator();
+
+  // Подменяет текущий файл новым, затем сжимает и удаляет
+  // старые сегменты (выполняется в фоновом потоке).
+  // Пустой файл оставляет как есть. Возвращает false,
+  // если файл не подменён
+  bool rotateNow();
+
+  // Снова разрешает ротацию по размеру (после паузы за
+  // неудачей)
+  void rearmRotation();
+
+  // Записывает готовый текст и применяет политику сброса
+  // (вызывается под logMutex_)
+  void writeLocked(const std::string &text,
+                   LogLevel mostSevere);
+
+  // Цикл фонового потока сброса по интервалу
+  void runFlushTicker();
+
+  // Дописывает в out строку лога "[время] [уровень]
+  // сообщение\n"
+  void appendLine(std::string &out,
+                  const std::string &message,
+                  LogLevel level) const;
 
   // Преобразует уровень логирования в строку
   static std::string logLevelToString(LogLevel level);
 
-  std::ofstream logFile_;  // Поток для записи в лог-файл
-  LogLevel currentLevel_;  // Текущий уровень логирования
+  const std::uint64_t id_;  // Уникальный номер логгера
+  std::string filename_;  // Имя текущего лог-файла
+  std::size_t bufferSize_;  // Размер буфера потока
+  std::unique_ptr<LogFile>
+    file_;  // Текущий файл (подменяется при ротации)
+  FlushPolicy flushPolicy_;  // Политика сброса
+  RotationPolicy rotation_;  // Политика ротации
+  TimestampFormatter timestamp_;  // Форматтер меток времени
+  StagingPolicy staging_;  // Поточные буферы
+  bool sequenceNumbers_;  // Писать номера сообщений
+  mutable std::atomic<std::uint64_t>
+    sequence_{0};  // Следующий номер сообщения
+  std::size_t unflushedBytes_
+    = 0;  // Байт записано с последнего сброса
+  std::size_t fileBytes_ = 0;  // Размер текущего файла
+  bool rotationPending_
+    = false;  // Ротация по размеру уже запрошена
   mutable std::mutex
     logMutex_;  // Мьютекс для потокобезопасной записи
+
+  std::mutex tickerMutex_;  // Мьютекс фонового сброса
+  std::condition_variable
+    tickerCv_;  // Пробуждение фонового потока при остановке
+  bool stopTicker_ = false;  // Флаг остановки
+  std::thread ticker_;  // Поток сброса по интервалу
+
+  std::mutex rotatorMutex_;  // Мьютекс потока ротации
+  std::condition_variable
+    rotatorCv_;  // Пробуждение потока ротации
+  bool rotationRequested_ = false;  // Запрошена ротация
+  bool rotationInProgress_ = false;  // Ротация выполняется
+  bool stopRotator_ = false;  // Флаг остановки
+  std::uint64_t rotationAttempts_
+    = 0;  // Попытки ротации (удачные и нет)
+  std::uint64_t rotations_ = 0;  // Завершённые ротации
+  bool lastRotationOk_ = false;  // Исход последней попытки
+  std::uint64_t segmentSeq_ = 0;  // Номер сегмента
+  std::thread rotator_;  // Поток ротации
+
+  std::mutex stagesMutex_;  // Мьютекс списка буферов
+  std::vector<std::shared_ptr<Stage>>
+    stages_;  // Буферы всех потоков-производителей
+  std::mutex handoffMutex_;  // Мьютекс передачи блоков
+  std::condition_variable
+    stagedCv_;  // Пробуждение писателя
+  std::vector<StagedChunk> staged_;  // Блоки для записи
+  std::vector<std::string>
+    spare_;  // Освобождённые строки для повторного
+             // использования
+  std::vector<StagedChunk>
+    writing_;  // Блоки, записываемые под logMutex_
+  bool stopStaging_ = false;  // Флаг остановки писателя
+  std::thread stagingWriter_;  // Фоновый писатель
 };
 
 }  // namespace logger
@@ -0,0 +1,115 @@
+#pragma once  // Защита от повторного включения
+              // заголовочного файла
+
+#include <atomic>  // Для атомарного резервирования места
+#include <cstddef>  // Для std::size_t
+#include <cstdint>  // Для std::uint64_t
+#include <memory>  // Для массива отображённых экстентов
+#include <mutex>  // Для роста файла (вне горячего пути)
+#include <string>  // Для std::string
+
+#include "ILogger.h"  // Интерфейс логгера
+#include "LogMessage.h"  // Структура LogMessage
+#include "Timestamp.h"  // Форматтер меток времени
+
+namespace logger {
+
+// Параметры логгера с отображением файла в память
+struct MmapLoggerOptions {
+  std::size_t extentSize
+    = 16 * 1024 * 1024;  // Размер экстента (округляется до
+                         // размера страницы)
+  std::size_t maxExtents
+    = 4096;  // Максимальное число экстентов в файле
+  TimestampFormatter timestamp;  // Формат меток времени
+};
+
+// Файловый логгер, пишущий напрямую в отображённый в память
+// файл. Файл заранее расширяется крупными экстентами
+// (posix_fallocate) и отображается по частям. Писатель
+// резервирует место одним fetch_add по смещению и копирует
+// готовую строку в отображение — без std::ofstream и без
+// общего мьютекса на горячем пути.
+//
+// При штатном завершении файл обрезается до фактической
+// длины. После аварийного завершения хвост файла заполнен
+// нулями (и может содержать «дыры» от незавершённых
+// записей); при открытии логгер восстанавливает корректный
+// префикс — все полные строки до первого нулевого байта — и
+// продолжает запись после него.
+class MmapFileLogger : public ILogger {
+ public:
+  // Конструктор: открывает (или создаёт) файл,
+  // восстанавливает корректный префикс и готовит запись
+  explicit MmapFileLogger(
+    const std::string &filename,
+    LogLevel level = LogLevel::Info,
+    MmapLoggerOptions options = MmapLoggerOptions());
+
+  // Деструктор: снимает отображения и обрезает файл до
+  // фактической длины. Вызывающий должен гарантировать,
+  // что конкурентных вызовов log() больше нет.
+  ~MmapFileLogger();
+
+  MmapFileLogger(const MmapFileLogger &) = delete;
+  MmapFileLogger &operator=(const MmapFileLogger &)
+    = delete;
+
+  // Записывает сообщение, если уровень >= текущего
+  void log(const std::string &message,
+           LogLevel level) override;
+
+  // Записывает пачку сообщений одним резервированием
+  void logBatch(const LogMessage *messages,
+                std::size_t count) override;
+
+  // Устанавливает текущий уровень логирования
+  void setLogLevel(LogLevel level) override;
+
+  // Возвращает текущий уровень логирования
+  LogLevel getLogLevel() const override;
+
+  // Синхронно сбрасывает отображённые страницы на диск
+  void flush();
+
+  // Признак успешно открытого файла
+  bool isOpen() const { return fd_ >= 0; }
+
+  // Текущая логическая длина файла в байтах
+  std::size_t size() const;
+
+  // Число сообщений, не поместившихся в maxExtents
+  std::uint64_t droppedCount() const;
+
+ private:
+  // Восстанавливает корректный префикс существующего файла
+  // и возвращает его длину
+  std::size_t recoverValidPrefix();
+
+  // Резервирует место и копирует текст в отображение
+  void write(const std::string &text);
+
+  // Возвращает адрес экстента index, при необходимости
+  // расширяя файл и отображая его
+  char *extent(std::size_t index);
+
+  // Дописывает в out строку "[время] [уровень] сообщение\n"
+  void appendLine(std::string &out,
+                  const std::string &message,
+                  LogLevel level) const;
+
+  int fd_ = -1;  // Дескриптор файла
+  std::size_t extentSize_;  // Размер экстента
+  std::size_t maxExtents_;  // Предел числа экстентов
+  TimestampFormatter timestamp_;  // Форматтер меток времени
+
+  std::atomic<std::size_t>
+    next_{0};  // Следующее свободное смещение в файле
+  std::unique_ptr<std::atomic<char *>[]>
+    extents_;  // Адреса отображённых экстентов
+  std::mutex growMutex_;  // Мьютекс расширения файла
+  std::atomic<std::uint64_t>
+    dropped_{0};  // Сообщения, не поместившиеся в файл
+};
+
+}  // namespace logger
@@ -1,46 +1,174 @@
 #pragma once  // Защита от повторного включения
               // заголовочного файла
 
-#include <netinet/in.h>  // Для работы с сетевыми структурами и протоколами (sockaddr_in и др.)
-#include <unistd.h>  // Для системных вызовов POSIX (close и т.п.)
-
+#include <atomic>  // Для счётчиков и флага соединения
+#include <chrono>  // Для интервалов переподключения
+#include <condition_variable>  // Для пробуждения потока ввода-вывода
+#include <cstdint>  // Для std::uint64_t, std::int64_t
 #include <mutex>  // Для мьютекса — защиты от одновременного доступа из нескольких потоков
 #include <string>  // Для std::string
+#include <thread>  // Для потока ввода-вывода
+#include <vector>  // Для границ записей в буфере отправки
 
+#include "Endpoint.h"  // Адрес и транспорт сервера
 #include "ILogger.h"  // Интерфейс ILogger для реализации методов логгера
+#include "SpillRing.h"  // Кольцевой буфер неотправленных сообщений
+#include "Timestamp.h"  // Форматтер меток времени
 
 namespace logger {
 
-// Класс логгера, отправляющего сообщения через TCP-сокет на
-// указанный хост и порт
+// Протокол передачи сообщений на сервер
+enum class WireProtocol {
+  Text,  // Строки "[время] [уровень] сообщение\n"
+  Framed  // Кадры с длиной (FrameProtocol.h); если сервер
+          // не подтвердил версию — текст на новом
+          // соединении. Только для потоковых транспортов
+};
+
+// Параметры сетевого логгера
+struct SocketLoggerOptions {
+  WireProtocol protocol
+    = WireProtocol::Text;  // Протокол передачи
+  std::chrono::milliseconds handshakeTimeout{
+    1000};  // Ожидание ответа на приветствие (Framed)
+  std::size_t spillBytes
+    = 4 * 1024 * 1024;  // Ёмкость буфера неотправленных
+                        // сообщений; при переполнении
+                        // новые сообщения отбрасываются
+  std::chrono::milliseconds reconnectMin{
+    100};  // Первая пауза перед переподключением
+  std::chrono::milliseconds reconnectMax{
+    5000};  // Предел паузы (удваивается после неудачи)
+  std::chrono::milliseconds connectTimeout{
+    1000};  // Таймаут одной попытки подключения
+  std::chrono::milliseconds lingerTimeout{
+    1000};  // Сколько деструктор ждёт отправки остатка
+  TimestampFormatter timestamp;  // Формат меток времени
+};
+
+// Класс логгера, отправляющего сообщения на сервер логов
+// по TCP, UDP или сокету AF_UNIX (Endpoint). По
+// датаграммным транспортам каждое сообщение уходит
+// отдельной датаграммой-строкой. Вызывающие потоки только
+// дописывают строку в кольцевой буфер; подключение,
+// отправку и переподключение с нарастающей паузой
+// выполняет фоновый поток на неблокирующем сокете. Пока
+// сервер недоступен или не успевает читать, сообщения
+// копятся в буфере.
 class SocketLogger : public ILogger {
  public:
-  // Конструктор: устанавливает соединение с хостом и
-  // портом, задаёт уровень логирования по умолчанию
-  SocketLogger(const std::string &host, int port,
-               LogLevel defaultLevel);
+  // Конструктор: запоминает адрес, задаёт уровень
+  // логирования по умолчанию и запускает поток
+  // ввода-вывода (подключение выполняется в нём)
+  SocketLogger(
+    const Endpoint &endpoint, LogLevel defaultLevel,
+    SocketLoggerOptions options = SocketLoggerOptions());
+
+  // То же для TCP-сервера host:port
+  SocketLogger(
+    const std::string &host, int port, LogLevel defaultLevel,
+    SocketLoggerOptions options = SocketLoggerOptions());
 
-  // Деструктор: закрывает сокет
+  // Деструктор: ждёт отправки остатка не дольше
+  // lingerTimeout и закрывает сокет
   ~SocketLogger();
 
-  // Отправляет лог-сообщение по TCP в формате "[время]
-  // [уровень] сообщение" Сообщение отправляется только при
-  // валидном соединении и если уровень >= установленного
+  // Ставит сообщение в буфер отправки, если уровень >=
+  // установленного. Не ждёт сеть: в буфер копируются
+  // уровень, время и текст, строка или кадр собираются
+  // потоком ввода-вывода
   void log(const std::string &message,
            LogLevel level) override;
 
+  // Ставит пачку сообщений в буфер за одно взятие
+  // блокировки
+  void logBatch(const LogMessage *messages,
+                std::size_t count) override;
+
   // Устанавливает текущий уровень логирования
   void setLogLevel(LogLevel level) override;
 
   // Возвращает текущий уровень логирования
   LogLevel getLogLevel() const override;
 
+  // Ждёт, пока все принятые сообщения не будут отправлены,
+  // но не дольше timeout. Возвращает true, если буфер пуст
+  bool flush(std::chrono::milliseconds timeout);
+
+  // Есть ли сейчас соединение с сервером
+  bool isConnected() const;
+
+  // Подтвердил ли сервер протокол кадров на текущем
+  // соединении
+  bool isFramed() const;
+
+  // Число сообщений, отброшенных из-за переполнения буфера
+  std::uint64_t droppedCount() const;
+
  private:
-  int sock_;  // Дескриптор TCP-сокета
-  LogLevel logLevel_;  // Текущий уровень логирования
-  mutable std::mutex
-    mutex_;  // Мьютекс для потокобезопасности доступа к
-             // сокету и уровню
+  // Дописывает в out запись кольца: уровень, время и
+  // текст сообщения
+  void appendRecord(std::string &out,
+                    const std::string &message,
+                    LogLevel level) const;
+
+  // Кладёт готовую запись в кольцо (вызывается под
+  // мьютексом); false — нет места
+  bool enqueueLocked(const std::string &record);
+
+  // Собирает wire_ из записей raw_, начиная с next_, в
+  // согласованном протоколе
+  void encodeWire();
+
+  // Приветствие протокола кадров; true — сервер согласился
+  bool handshake();
+
+  // Цикл потока ввода-вывода
+  void run();
+
+  // Одна попытка подключения с таймаутом
+  bool connectNow();
+
+  // Отправляет буфер wire_, пока сокет принимает
+  // данные. false — соединение разорвано
+  bool sendPending(std::chrono::milliseconds wait);
+
+  // То же для датаграммного сокета: одна запись — одна
+  // датаграмма
+  bool sendDatagrams(std::chrono::milliseconds wait);
+
+  // Закрывает сокет после ошибки; недоотправленная запись
+  // будет отправлена заново целиком
+  void disconnect();
+
+  Endpoint endpoint_;  // Адрес сервера
+  SocketLoggerOptions options_;  // Параметры
+  int sock_ = -1;  // Дескриптор сокета (только поток
+                   // ввода-вывода)
+  bool reportedDown_ = false;  // Обрыв уже выведен в stderr
+  bool textOnce_ = false;  // Следующее подключение — без
+                           // приветствия (сервер не
+                           // подтвердил кадры)
+
+  mutable std::mutex mutex_;  // Мьютекс буфера
+  std::condition_variable dataCv_;  // Появились данные
+  std::condition_variable drainedCv_;  // Буфер опустел
+  SpillRing spill_;  // Сообщения, ждущие отправки
+  bool ioWaiting_ = false;  // Поток ждёт данных
+  bool sending_ = false;  // В raw_ есть данные
+  bool stopping_ = false;  // Флаг остановки
+  std::uint64_t dropped_ = 0;  // Отброшено сообщений
+
+  std::string raw_;  // Записи, взятые из кольца
+  std::vector<std::size_t> rawEnds_;  // Концы записей в raw_
+  std::size_t next_ = 0;  // Первая неотправленная запись
+  std::string wire_;  // Закодированные записи с next_
+  std::vector<std::size_t>
+    wireEnds_;  // Концы записей в wire_
+  std::size_t sent_ = 0;  // Отправлено байт из wire_
+  std::atomic<bool> connected_{false};  // Есть соединение
+  std::atomic<bool> framed_{false};  // Соединение в кадрах
+  std::thread io_;  // Поток ввода-вывода
 };
 
 }  // namespace logger
@@ -0,0 +1,103 @@
+#pragma once  // Защита от повторного включения
+              // заголовочного файла
+
+#include <algorithm>  // Для std::min
+#include <cstddef>  // Для std::size_t
+#include <cstdint>  // Для std::uint32_t
+#include <cstring>  // Для memcpy
+#include <string>  // Для выдачи записей
+#include <vector>  // Для кольцевого буфера и границ записей
+
+namespace logger {
+
+// Кольцевой буфер записей фиксированной ёмкости в байтах.
+// Каждая запись хранится как [uint32 длина][байты] и
+// извлекается целиком, поэтому границы сообщений известны
+// и после обрыва соединения. Не потокобезопасен: владелец
+// защищает его своим мьютексом.
+class SpillRing {
+ public:
+  // Создаёт буфер ёмкостью capacity байт (включая
+  // заголовки записей)
+  explicit SpillRing(std::size_t capacity)
+      : buffer_(capacity) {}
+
+  // Добавляет запись; false, если для неё нет места
+  bool push(const char *data, std::size_t len) {
+    std::size_t need = sizeof(std::uint32_t) + len;
+    if (len > UINT32_MAX || need > buffer_.size() - used_)
+      return false;
+
+    auto header = static_cast<std::uint32_t>(len);
+    std::size_t tail = (head_ + used_) % buffer_.size();
+    tail = copyIn(tail, reinterpret_cast<const char *>(&header),
+                  sizeof(header));
+    copyIn(tail, data, len);
+    used_ += need;
+    ++records_;
+    return true;
+  }
+
+  // Дописывает в out целые записи (без заголовков), пока
+  // их суммарный размер не превысит maxBytes (хотя бы одну
+  // запись). Конец каждой записи в out добавляется в ends.
+  // Возвращает число извлечённых записей.
+  std::size_t popInto(std::string &out,
+                      std::vector<std::size_t> &ends,
+                      std::size_t maxBytes) {
+    std::size_t popped = 0;
+    std::size_t taken = 0;
+    while (records_ > 0) {
+      std::uint32_t len = 0;
+      std::size_t body = copyOut(
+        head_, reinterpret_cast<char *>(&len), sizeof(len));
+      if (popped > 0 && taken + len > maxBytes)
+        break;
+
+      std::size_t at = out.size();
+      out.resize(at + len);
+      head_ = copyOut(body, &out[at], len);
+      used_ -= sizeof(len) + len;
+      --records_;
+      ends.push_back(out.size());
+      taken += len;
+      ++popped;
+    }
+    if (records_ == 0)
+      head_ = 0;  // Пустое кольцо начинаем с начала
+    return popped;
+  }
+
+  bool empty() const { return records_ == 0; }
+  std::size_t records() const { return records_; }
+  std::size_t bytes() const { return used_; }
+  std::size_t capacity() const { return buffer_.size(); }
+
+ private:
+  // Копирует len байт в кольцо с позиции pos (с переходом
+  // через конец); возвращает позицию после них
+  std::size_t copyIn(std::size_t pos, const char *data,
+                     std::size_t len) {
+    std::size_t first = std::min(len, buffer_.size() - pos);
+    std::memcpy(buffer_.data() + pos, data, first);
+    std::memcpy(buffer_.data(), data + first, len - first);
+    return (pos + len) % buffer_.size();
+  }
+
+  // Копирует len байт из кольца начиная с pos; возвращает
+  // позицию после них
+  std::size_t copyOut(std::size_t pos, char *data,
+                      std::size_t len) const {
+    std::size_t first = std::min(len, buffer_.size() - pos);
+    std::memcpy(data, buffer_.data() + pos, first);
+    std::memcpy(data + first, buffer_.data(), len - first);
+    return (pos + len) % buffer_.size();
+  }
+
+  std::vector<char> buffer_;  // Байты кольца
+  std::size_t head_ = 0;  // Начало первой записи
+  std::size_t used_ = 0;  // Занято байт
+  std::size_t records_ = 0;  // Число записей
+};
+
+}  // namespace logger
@@ -0,0 +1,64 @@
+#pragma once  // Защита от повторного включения
+              // заголовочного файла
+
+#include <chrono>  // Для временных точек system_clock
+#include <cstddef>  // Для std::size_t
+#include <string>  // Для std::string
+
+namespace logger {
+
+// Точность дробной части метки времени
+enum class TimePrecision {
+  Seconds,  // "YYYY-MM-DD HH:MM:SS"
+  Milliseconds,  // "YYYY-MM-DD HH:MM:SS.mmm"
+  Microseconds  // "YYYY-MM-DD HH:MM:SS.uuuuuu"
+};
+
+// Источник текущего времени
+enum class ClockSource {
+  System,  // std::chrono::system_clock
+  Fast  // Грубые монотонные часы CLOCK_MONOTONIC_COARSE,
+        // привязанные к системному времени при создании
+        // форматтера (разрешение — единицы миллисекунд)
+};
+
+// Форматтер меток времени, общий для Logger и
+// SocketLogger. Префикс с точностью до секунды кэшируется в
+// каждом потоке и пересобирается через localtime_r только
+// при смене секунды, поэтому на каждую строку лога
+// остаётся копирование 19 байт и, при необходимости,
+// дробной части.
+class TimestampFormatter {
+ public:
+  // Максимальная длина отформатированной метки
+  static constexpr std::size_t kMaxLength = 26;
+
+  explicit TimestampFormatter(
+    TimePrecision precision = TimePrecision::Seconds,
+    ClockSource source = ClockSource::System);
+
+  // Возвращает текущее время выбранного источника
+  std::chrono::system_clock::time_point now() const;
+
+  // Записывает метку времени tp в buf (не менее kMaxLength
+  // байт, без завершающего нуля). Возвращает длину.
+  std::size_t format(
+    char *buf, std::chrono::system_clock::time_point tp) const;
+
+  // Дописывает текущую метку времени в конец out
+  void append(std::string &out) const;
+
+  // Возвращает текущую метку времени строкой
+  std::string current() const;
+
+  TimePrecision precision() const { return precision_; }
+
+ private:
+  TimePrecision precision_;  // Точность дробной части
+  ClockSource source_;  // Источник времени
+  std::chrono::nanoseconds
+    fastOffset_{};  // Смещение монотонных часов к
+                    // системному времени (для Fast)
+};
+
+}  // namespace logger
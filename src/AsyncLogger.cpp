@@ -0,0 +1,170 @@
+#include "logger/AsyncLogger.h"
+
+#include <vector>  // Для пачки сообщений рабочего потока
+
+namespace logger {
+
+namespace {
+
+// Очередь нулевой ёмкости не принимала бы ничего, а
+// DropOldest вытеснял бы из пустой: ёмкость не меньше 1.
+// Пустая пачка не забирала бы сообщений, и рабочий поток
+// крутился бы вечно: пачка тоже не меньше 1
+AsyncLoggerOptions validated(AsyncLoggerOptions options) {
+  if (options.capacity == 0)
+    options.capacity = 1;
+  if (options.maxBatch == 0)
+    options.maxBatch = 1;
+  return options;
+}
+
+}  // namespace
+
+// Конструктор: запоминает приёмник и параметры, запускает
+// рабочий поток
+AsyncLogger::AsyncLogger(std::unique_ptr<ILogger> sink,
+                         AsyncLoggerOptions options)
+    : ILogger(sink->getLogLevel()),
+      sink_(std::move(sink)),
+      options_(validated(options)) {
+  worker_ = std::thread(&AsyncLogger::run, this);
+}
+
+// Деструктор: рабочий поток дописывает очередь до конца и
+// завершается
+AsyncLogger::~AsyncLogger() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  notEmpty_.notify_all();
+  notFull_.notify_all();
+  worker_.join();
+}
+
+// Постановка сообщения в очередь с учётом политики
+// переполнения
+void AsyncLogger::log(const std::string &message,
+                      LogLevel level) {
+  if (!isEnabled(level)) {
+    return;  // Сообщение ниже текущего уровня
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (stopping_) {
+    countDrop(level);
+    return;
+  }
+
+  if (queue_.size() >= options_.capacity) {
+    switch (options_.policy) {
+      case OverflowPolicy::DropNewest:
+        countDrop(level);
+        return;
+      case OverflowPolicy::DropOldest:
+        countDrop(queue_.front().level);
+        queue_.pop_front();
+        ++completed_;
+        break;
+      case OverflowPolicy::DropBelowLevel:
+        if (level > options_.dropLevel) {
+          countDrop(level);
+          return;
+        }
+        [[fallthrough]];
+      case OverflowPolicy::Block:
+        notFull_.wait(lock, [this] {
+          return queue_.size() < options_.capacity
+                 || stopping_;
+        });
+        if (stopping_) {
+          // Остановка не дождалась места: сообщение
+          // отброшено
+          countDrop(level);
+          return;
+        }
+        break;
+    }
+  }
+
+  queue_.push_back(LogMessage{message, level});
+  ++accepted_;
+  lock.unlock();
+  notEmpty_.notify_one();
+}
+
+// Установка уровня: фильтруем до постановки в очередь и
+// передаём уровень приёмнику
+void AsyncLogger::setLogLevel(LogLevel level) {
+  storeLevel(level);
+  sink_->setLogLevel(level);
+}
+
+// Получение текущего уровня логирования
+LogLevel AsyncLogger::getLogLevel() const {
+  return loadLevel();
+}
+
+// Ожидание, пока рабочий поток не обработает всё принятое
+void AsyncLogger::flush() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  std::uint64_t target = accepted_;
+  drained_.wait(lock,
+                [this, target] { return completed_ >= target; });
+}
+
+// Общее число отброшенных сообщений
+std::uint64_t AsyncLogger::droppedCount() const {
+  std::uint64_t total = 0;
+  for (const auto &counter : dropped_) {
+    total += counter.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+// Число отброшенных сообщений указанного уровня
+std::uint64_t AsyncLogger::droppedCount(
+  LogLevel level) const {
+  return dropped_[static_cast<std::size_t>(level)].load(
+    std::memory_order_relaxed);
+}
+
+// Учёт отброшенного сообщения
+void AsyncLogger::countDrop(LogLevel level) {
+  dropped_[static_cast<std::size_t>(level)].fetch_add(
+    1, std::memory_order_relaxed);
+}
+
+// Рабочий поток: забирает пачку под одной блокировкой и
+// передаёт её приёмнику вне блокировки
+void AsyncLogger::run() {
+  std::vector<LogMessage> batch;
+  while (true) {
+    batch.clear();
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      notEmpty_.wait(lock, [this] {
+        return !queue_.empty() || stopping_;
+      });
+      if (queue_.empty() && stopping_)
+        break;
+
+      while (!queue_.empty()
+             && batch.size() < options_.maxBatch) {
+        batch.push_back(std::move(queue_.front()));
+        queue_.pop_front();
+      }
+    }
+    notFull_.notify_all();
+
+    sink_->logBatch(batch.data(), batch.size());
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      completed_ += batch.size();
+    }
+    drained_.notify_all();
+  }
+}
+
+}  // namespace logger
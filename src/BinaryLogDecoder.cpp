@@ -0,0 +1,221 @@
+#include "logger/BinaryLogDecoder.h"
+
+#include <algorithm>  // Для std::min
+#include <chrono>  // Для преобразования меток времени
+#include <cstdint>  // Для целых фиксированной ширины
+#include <cstdio>  // Для snprintf
+#include <cstring>  // Для memcmp, memcpy
+#include <string>  // Для std::string
+#include <unordered_map>  // Для словаря форматов
+
+#include "logger/BinaryLogger.h"  // Константы формата
+#include "logger/LogLevel.h"  // Имена уровней
+#include "logger/Timestamp.h"  // Форматирование времени
+
+namespace logger {
+
+namespace {
+
+// Читает значение фиксированного размера; false — конец
+// файла
+template <typename T>
+bool readRaw(std::istream &in, T &value) {
+  char bytes[sizeof(T)];
+  if (!in.read(bytes, sizeof(T)))
+    return false;
+  std::memcpy(&value, bytes, sizeof(T));
+  return true;
+}
+
+// Читает len байт порциями: память растёт по мере
+// прихода данных, поэтому длина из обрезанного файла не
+// выделяет лишнего; false — конец файла
+bool readBytes(std::istream &in, std::uint32_t len,
+               std::string &out) {
+  constexpr std::size_t kChunk = 64 * 1024;
+  out.clear();
+  while (out.size() < len) {
+    std::size_t have = out.size();
+    std::size_t chunk = std::min<std::size_t>(
+      kChunk, len - have);
+    out.resize(have + chunk);
+    if (!in.read(out.data() + have,
+                 static_cast<std::streamsize>(chunk)))
+      return false;
+  }
+  return true;
+}
+
+// Курсор по байтам аргументов одной записи
+struct ArgReader {
+  const std::string &data;
+  std::size_t pos = 0;
+
+  template <typename T>
+  bool read(T &value) {
+    if (pos + sizeof(T) > data.size())
+      return false;
+    std::memcpy(&value, data.data() + pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+  }
+
+  // Декодирует следующий аргумент в текст
+  bool next(std::string &out) {
+    std::uint8_t tag = 0;
+    if (!read(tag))
+      return false;
+    switch (static_cast<binlog::ArgTag>(tag)) {
+      case binlog::ArgTag::Int: {
+        std::int64_t v = 0;
+        if (!read(v))
+          return false;
+        out += std::to_string(v);
+        return true;
+      }
+      case binlog::ArgTag::UInt: {
+        std::uint64_t v = 0;
+        if (!read(v))
+          return false;
+        out += std::to_string(v);
+        return true;
+      }
+      case binlog::ArgTag::Double: {
+        double v = 0;
+        if (!read(v))
+          return false;
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%g", v);
+        out += buf;
+        return true;
+      }
+      case binlog::ArgTag::String: {
+        std::uint32_t len = 0;
+        if (!read(len) || len > data.size() - pos)
+          return false;
+        out.append(data, pos, len);
+        pos += len;
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+// Подставляет аргументы в заполнители "{}"; лишние
+// аргументы дописываются через пробел
+bool render(const std::string &fmt, const std::string &args,
+            std::string &out) {
+  ArgReader reader{args};
+  for (std::size_t i = 0; i < fmt.size(); ++i) {
+    if (fmt[i] == '{' && i + 1 < fmt.size()
+        && fmt[i + 1] == '}' && reader.pos < args.size()) {
+      if (!reader.next(out))
+        return false;
+      ++i;
+    } else {
+      out += fmt[i];
+    }
+  }
+  while (reader.pos < args.size()) {
+    out += ' ';
+    if (!reader.next(out))
+      return false;
+  }
+  return true;
+}
+
+// Сохраняет описание ошибки, если его запросили
+long fail(std::string *error, const std::string &text) {
+  if (error != nullptr)
+    *error = text;
+  return -1;
+}
+
+}  // namespace
+
+// Декодирование двоичного лога в текст
+long decodeBinaryLog(std::istream &in, std::ostream &out,
+                     std::string *error) {
+  // Сигнатура без байта версии
+  constexpr std::size_t kVersionByte = 5;
+  char magic[sizeof(binlog::kBinaryLogMagic)];
+  if (!in.read(magic, sizeof(magic))
+      || std::memcmp(magic, binlog::kBinaryLogMagic,
+                     kVersionByte)
+           != 0) {
+    return fail(error, "not a binary log file");
+  }
+  if (std::memcmp(magic, binlog::kBinaryLogMagic,
+                  sizeof(magic))
+      != 0)
+    return fail(error, std::string("unsupported binary log "
+                                   "version ")
+                         + magic[kVersionByte]);
+
+  TimestampFormatter timestamp;
+  std::unordered_map<std::uint32_t, std::string> formats;
+  std::string args;
+  std::string line;
+  long decoded = 0;
+
+  std::uint8_t type = 0;
+  while (readRaw(in, type)) {
+    std::uint32_t id = 0;
+    if (type == binlog::kFormatRecord) {
+      std::uint32_t len = 0;
+      if (!readRaw(in, id) || !readRaw(in, len))
+        break;  // Обрезанная запись в конце файла
+      if (len > binlog::kMaxEntryArgs)
+        return fail(error, "corrupted format length "
+                             + std::to_string(len));
+      std::string fmt;
+      if (!readBytes(in, len, fmt))
+        break;
+      formats[id] = std::move(fmt);
+      continue;
+    }
+    if (type != binlog::kEntryRecord)
+      return fail(error, "unknown record type "
+                           + std::to_string(type));
+
+    std::uint8_t level = 0;
+    std::int64_t ticks = 0;
+    std::uint32_t argLen = 0;
+    if (!readRaw(in, id) || !readRaw(in, level)
+        || !readRaw(in, ticks) || !readRaw(in, argLen))
+      break;
+    if (argLen > binlog::kMaxEntryArgs)
+      return fail(error, "corrupted arguments length "
+                           + std::to_string(argLen));
+    if (!readBytes(in, argLen, args))
+      break;
+
+    auto it = formats.find(id);
+    if (it == formats.end())
+      return fail(error,
+                  "unknown format id " + std::to_string(id));
+
+    // Строка в том же виде, что пишет Logger
+    char stamp[TimestampFormatter::kMaxLength];
+    std::size_t stampLen = timestamp.format(
+      stamp, std::chrono::system_clock::time_point(
+               std::chrono::duration_cast<
+                 std::chrono::system_clock::duration>(
+                 std::chrono::nanoseconds(ticks))));
+    line.clear();
+    line += '[';
+    line.append(stamp, stampLen);
+    line += "] [";
+    line += logLevelName(static_cast<LogLevel>(level));
+    line += "] ";
+    if (!render(it->second, args, line))
+      return fail(error, "corrupted arguments");
+    line += '\n';
+    out << line;
+    ++decoded;
+  }
+  return decoded;
+}
+
+}  // namespace logger
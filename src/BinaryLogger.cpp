@@ -0,0 +1,146 @@
+#include "logger/BinaryLogger.h"
+
+#include <chrono>  // Для метки времени записи
+#include <cstdio>  // Для fprintf
+
+namespace logger {
+
+// Единственный экземпляр реестра форматов
+FormatRegistry &FormatRegistry::instance() {
+  static FormatRegistry registry;
+  return registry;
+}
+
+// Реестр создаётся с форматом обычного сообщения под ID 0
+FormatRegistry::FormatRegistry() {
+  formats_.push_back("{}");
+  ids_.emplace("{}", binlog::kPlainMessageFormat);
+}
+
+// Регистрация строки формата
+std::uint32_t FormatRegistry::intern(const char *fmt) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = ids_.find(fmt);
+  if (it != ids_.end())
+    return it->second;
+
+  auto id = static_cast<std::uint32_t>(formats_.size());
+  formats_.emplace_back(fmt);
+  ids_.emplace(formats_.back(), id);
+  return id;
+}
+
+// Строка формата по ID
+std::string FormatRegistry::format(std::uint32_t id) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return id < formats_.size() ? formats_[id] : std::string();
+}
+
+// Конструктор: создаём файл и пишем заголовок
+BinaryLogger::BinaryLogger(const std::string &filename,
+                           LogLevel level)
+    : ILogger(level) {
+  file_.open(filename, std::ios::binary | std::ios::trunc);
+  if (!file_.is_open()) {
+    fprintf(stderr, "Failed to open log file: %s\n",
+            filename.c_str());
+    return;
+  }
+  file_.write(binlog::kBinaryLogMagic,
+              sizeof(binlog::kBinaryLogMagic));
+}
+
+// Деструктор: закрытие потока сбрасывает буфер
+BinaryLogger::~BinaryLogger() {
+  if (file_.is_open())
+    file_.close();
+}
+
+// Обычное сообщение записывается как формат "{}" с одним
+// строковым аргументом
+void BinaryLogger::log(const std::string &message,
+                       LogLevel level) {
+  logFormat(level, binlog::kPlainMessageFormat, "{}",
+            std::string_view(message));
+}
+
+// Установка текущего уровня логирования
+void BinaryLogger::setLogLevel(LogLevel level) {
+  storeLevel(level);
+}
+
+// Получение текущего уровня логирования
+LogLevel BinaryLogger::getLogLevel() const {
+  return loadLevel();
+}
+
+// Сброс буфера файла
+void BinaryLogger::flush() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (file_.is_open())
+    file_.flush();
+}
+
+// Буфер аргументов текущего потока
+std::string &BinaryLogger::argBuffer() {
+  thread_local std::string buffer;
+  return buffer;
+}
+
+// Запись сообщения в файл
+void BinaryLogger::writeEntry(LogLevel level,
+                              std::uint32_t id,
+                              const std::string &args) {
+  // Декодер отверг бы такую запись, а обрезка потеряла бы
+  // данные незаметно
+  if (args.size() > binlog::kMaxEntryArgs) {
+    fprintf(stderr,
+            "BinaryLogger: message arguments exceed %u "
+            "bytes, message dropped\n",
+            static_cast<unsigned>(binlog::kMaxEntryArgs));
+    return;
+  }
+
+  auto ticks
+    = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch())
+        .count();
+
+  // Запись собирается вне блокировки
+  thread_local std::string record;
+  record.clear();
+  record += static_cast<char>(binlog::kEntryRecord);
+  binlog::appendRaw(record, id);
+  record += static_cast<char>(level);
+  binlog::appendRaw(record, static_cast<std::int64_t>(ticks));
+  binlog::appendRaw(record,
+                    static_cast<std::uint32_t>(args.size()));
+  record += args;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!file_.is_open())
+    return;
+
+  // Формат пишется в файл перед первым его использованием
+  if (id >= written_.size())
+    written_.resize(id + 1, false);
+  if (!written_[id]) {
+    std::string fmt = FormatRegistry::instance().format(id);
+    auto len = static_cast<std::uint32_t>(fmt.size());
+    std::string def;
+    def += static_cast<char>(binlog::kFormatRecord);
+    binlog::appendRaw(def, id);
+    binlog::appendRaw(def, len);
+    def += fmt;
+    file_.write(def.data(),
+                static_cast<std::streamsize>(def.size()));
+    written_[id] = true;
+  }
+
+  file_.write(record.data(),
+              static_cast<std::streamsize>(record.size()));
+  if (level == LogLevel::Error)
+    file_.flush();  // Ошибки сразу попадают на диск
+}
+
+}  // namespace logger
@@ -0,0 +1,151 @@
+#include "logger/Endpoint.h"
+
+#include <arpa/inet.h>  // Для inet_pton
+#include <netinet/in.h>  // Для sockaddr_in
+#include <sys/un.h>  // Для sockaddr_un
+
+#include <cstddef>  // Для offsetof
+#include <cstring>  // Для memcpy, strlen
+
+namespace logger {
+
+namespace {
+
+// Префиксы схем строки адреса
+struct Scheme {
+  const char *prefix;
+  Transport transport;
+};
+constexpr Scheme kSchemes[] = {
+  {"tcp://", Transport::Tcp},
+  {"udp://", Transport::Udp},
+  {"unix:", Transport::UnixStream},
+  {"unixgram:", Transport::UnixDatagram},
+};
+
+// Разбирает "host:port"; порт обязателен
+bool parseHostPort(const std::string &s, Endpoint &out) {
+  std::size_t colon = s.rfind(':');
+  if (colon == std::string::npos || colon == 0
+      || colon + 1 == s.size())
+    return false;
+  int port = 0;
+  for (std::size_t i = colon + 1; i < s.size(); ++i) {
+    if (s[i] < '0' || s[i] > '9')
+      return false;
+    port = port * 10 + (s[i] - '0');
+    if (port > 65535)
+      return false;
+  }
+  out.host = s.substr(0, colon);
+  out.port = port;
+  return true;
+}
+
+}  // namespace
+
+Endpoint Endpoint::tcp(const std::string &host, int port) {
+  Endpoint e;
+  e.host = host;
+  e.port = port;
+  return e;
+}
+
+Endpoint Endpoint::udp(const std::string &host, int port) {
+  Endpoint e = tcp(host, port);
+  e.transport = Transport::Udp;
+  return e;
+}
+
+Endpoint Endpoint::unixStream(const std::string &path) {
+  Endpoint e;
+  e.transport = Transport::UnixStream;
+  e.path = path;
+  return e;
+}
+
+Endpoint Endpoint::unixDatagram(const std::string &path) {
+  Endpoint e = unixStream(path);
+  e.transport = Transport::UnixDatagram;
+  return e;
+}
+
+// Разбор строки адреса по префиксу схемы
+bool parseEndpoint(const std::string &spec, Endpoint &out) {
+  for (const Scheme &scheme : kSchemes) {
+    std::size_t len = std::strlen(scheme.prefix);
+    if (spec.compare(0, len, scheme.prefix) != 0)
+      continue;
+    Endpoint parsed;
+    parsed.transport = scheme.transport;
+    std::string rest = spec.substr(len);
+    if (parsed.isInet()) {
+      if (!parseHostPort(rest, parsed))
+        return false;
+    } else {
+      if (rest.empty())
+        return false;
+      parsed.path = rest;
+    }
+    out = parsed;
+    return true;
+  }
+  return false;
+}
+
+std::string toString(const Endpoint &endpoint) {
+  switch (endpoint.transport) {
+    case Transport::Tcp:
+      return "tcp://" + endpoint.host + ":"
+             + std::to_string(endpoint.port);
+    case Transport::Udp:
+      return "udp://" + endpoint.host + ":"
+             + std::to_string(endpoint.port);
+    case Transport::UnixStream:
+      return "unix:" + endpoint.path;
+    case Transport::UnixDatagram:
+      return "unixgram:" + endpoint.path;
+  }
+  return "";
+}
+
+// Адрес IPv4 или AF_UNIX в общей структуре
+bool toSockaddr(const Endpoint &endpoint,
+                sockaddr_storage &addr, socklen_t &len) {
+  addr = sockaddr_storage{};
+  if (endpoint.isInet()) {
+    auto *in = reinterpret_cast<sockaddr_in *>(&addr);
+    in->sin_family = AF_INET;
+    in->sin_port
+      = htons(static_cast<uint16_t>(endpoint.port));
+    if (inet_pton(AF_INET, endpoint.host.c_str(),
+                  &in->sin_addr)
+        != 1)
+      return false;
+    len = sizeof(sockaddr_in);
+    return true;
+  }
+
+  auto *un = reinterpret_cast<sockaddr_un *>(&addr);
+  un->sun_family = AF_UNIX;
+  if (endpoint.path.empty()
+      || endpoint.path.size() >= sizeof(un->sun_path))
+    return false;  // Путь не помещается в sun_path
+  std::memcpy(un->sun_path, endpoint.path.data(),
+              endpoint.path.size());
+  len = static_cast<socklen_t>(
+    offsetof(sockaddr_un, sun_path) + endpoint.path.size()
+    + 1);
+  return true;
+}
+
+int openSocket(const Endpoint &endpoint, bool nonBlocking) {
+  int type = endpoint.isStream() ? SOCK_STREAM : SOCK_DGRAM;
+  type |= SOCK_CLOEXEC;
+  if (nonBlocking)
+    type |= SOCK_NONBLOCK;
+  return socket(endpoint.isInet() ? AF_INET : AF_UNIX,
+                type, 0);
+}
+
+}  // namespace logger
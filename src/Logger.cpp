@@ -1,25 +1,189 @@
 #include "logger/Logger.h"
 
+#include <sys/stat.h>  // Для stat (размер и возраст файлов)
+
+#include <algorithm>  // Для std::sort
+#include <cctype>  // Для std::isdigit
+#include <charconv>  // Для std::to_chars
+#include <cstdio>  // Для std::rename, std::remove
+#include <filesystem>  // Для перечисления сегментов
+
+#ifdef LOGGER_HAVE_ZLIB
+#include <zlib.h>  // Для сжатия сегментов в gzip
+#endif
+
 namespace logger {
 
+namespace {
+
+// Источник уникальных номеров логгеров: по номеру поток
+// находит свой буфер (адрес логгера может быть
+// переиспользован после его уничтожения)
+std::atomic<std::uint64_t> nextLoggerId{1};
+
+// Сколько освобождённых строк хранить для повторного
+// использования
+constexpr std::size_t kMaxSpareBuffers = 64;
+
+// Возвращает размер файла или 0, если его нет
+std::size_t fileSize(const std::string &path) {
+  struct stat st {};
+  if (stat(path.c_str(), &st) != 0)
+    return 0;
+  return static_cast<std::size_t>(st.st_size);
+}
+
+#ifdef LOGGER_HAVE_ZLIB
+// Сжимает src в dst (gzip) и удаляет src при успехе
+bool compressFile(const std::string &src,
+                  const std::string &dst) {
+  std::ifstream in(src, std::ios::binary);
+  gzFile out = gzopen(dst.c_str(), "wb6");
+  if (!in.is_open() || out == nullptr) {
+    if (out != nullptr)
+      gzclose(out);
+    return false;
+  }
+
+  char chunk[64 * 1024];
+  bool ok = true;
+  while (ok && in) {
+    in.read(chunk, sizeof(chunk));
+    auto got = static_cast<unsigned>(in.gcount());
+    if (got > 0)
+      ok = gzwrite(out, chunk, got) == static_cast<int>(got);
+  }
+  ok = gzclose(out) == Z_OK && ok;
+  if (ok)
+    std::remove(src.c_str());
+  else
+    std::remove(dst.c_str());
+  return ok;
+}
+#endif
+
+// Удаляет сегменты сверх maxFiles и старше maxAge.
+// Сегменты — файлы "<имя>.<цифры>..." рядом с лог-файлом;
+// имена сортируются по времени ротации.
+void pruneSegments(const std::string &filename,
+                   const RotationPolicy &policy) {
+  if (policy.maxFiles == 0 && policy.maxAge.count() == 0)
+    return;
+
+  namespace fs = std::filesystem;
+  fs::path logPath(filename);
+  fs::path dir = logPath.parent_path();
+  if (dir.empty())
+    dir = ".";
+  std::string prefix = logPath.filename().string() + ".";
+
+  std::vector<std::string> segments;
+  std::error_code ec;
+  for (fs::directory_iterator it(dir, ec), endIt;
+       !ec && it != endIt; it.increment(ec)) {
+    std::string name = it->path().filename().string();
+    if (name.size() > prefix.size()
+        && name.compare(0, prefix.size(), prefix) == 0
+        && std::isdigit(static_cast<unsigned char>(
+          name[prefix.size()]))) {
+      segments.push_back(it->path().string());
+    }
+  }
+  std::sort(segments.begin(), segments.end());
+
+  std::time_t now = std::time(nullptr);
+  std::size_t keep = segments.size();
+  for (std::size_t i = 0; i < segments.size(); ++i) {
+    bool tooMany = policy.maxFiles > 0
+                   && keep > policy.maxFiles;
+    bool tooOld = false;
+    struct stat st {};
+    if (policy.maxAge.count() > 0
+        && stat(segments[i].c_str(), &st) == 0) {
+      tooOld = now - st.st_mtime > policy.maxAge.count();
+    }
+    if (tooMany || tooOld) {
+      std::remove(segments[i].c_str());
+      --keep;
+    }
+  }
+}
+
+}  // namespace
+
 // Конструктор: открывает файл лога в режиме добавления
 // (append) И устанавливает уровень логирования по умолчанию
-Logger::Logger(const std::string &filename, LogLevel level)
-    : currentLevel_(level) {
-  logFile_.open(filename, std::ios::app);
-  if (!logFile_.is_open()) {
+Logger::Logger(const std::string &filename, LogLevel level,
+               LoggerOptions options)
+    : ILogger(level),
+      id_(nextLoggerId.fetch_add(1,
+                                 std::memory_order_relaxed)),
+      filename_(filename),
+      bufferSize_(options.bufferSize),
+      flushPolicy_(options.flush),
+      rotation_(options.rotation),
+      timestamp_(options.timestamp),
+      staging_(options.staging),
+      sequenceNumbers_(options.sequenceNumbers) {
+  file_ = openFile();
+  if (!file_->stream.is_open()) {
     // Если не удалось открыть файл — выводим ошибку в
     // stderr, но не бросаем исключение
     fprintf(stderr, "Failed to open log file: %s\n",
             filename.c_str());
   }
+  fileBytes_ = fileSize(filename_);
+
+  if (flushPolicy_.interval.count() > 0) {
+    ticker_ = std::thread(&Logger::runFlushTicker, this);
+  }
+  if (rotation_.maxBytes > 0
+      || rotation_.interval.count() > 0) {
+    rotator_ = std::thread(&Logger::runRotator, this);
+  }
+  if (staging_.enabled) {
+    stagingWriter_
+      = std::thread(&Logger::runStagingWriter, this);
+  }
 }
 
-// Деструктор: закрывает файл лога, если он открыт
+// Деструктор: дописывает поточные буферы, останавливает
+// фоновые потоки и закрывает файл лога (закрытие потока
+// сбрасывает буфер)
 Logger::~Logger() {
-  if (logFile_.is_open()) {
-    logFile_.close();
+  if (stagingWriter_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(handoffMutex_);
+      stopStaging_ = true;
+    }
+    stagedCv_.notify_all();
+    stagingWriter_.join();
+
+    collectStages();
+    writeStaged();
+    // Буферы потоков переживают логгер (их держат
+    // thread_local-списки) — помечаем их закрытыми
+    std::lock_guard<std::mutex> lock(stagesMutex_);
+    for (auto &st : stages_)
+      st->closed.store(true, std::memory_order_relaxed);
   }
+  if (rotator_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(rotatorMutex_);
+      stopRotator_ = true;
+    }
+    rotatorCv_.notify_all();
+    rotator_.join();
+  }
+  if (ticker_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(tickerMutex_);
+      stopTicker_ = true;
+    }
+    tickerCv_.notify_all();
+    ticker_.join();
+  }
+  file_.reset();
 }
 
 // Метод записи сообщения в лог
@@ -27,44 +191,472 @@ void Logger::log(const std::string &message,
                  LogLevel level) {
   // Если уровень сообщения выше (меньше важен), чем текущий
   // уровень — игнорируем сообщение
-  if (level > currentLevel_) {
+  if (!isEnabled(level)) {
+    return;
+  }
+
+  if (staging_.enabled) {
+    // Общая блокировка не берётся: строка дописывается в
+    // буфер потока
+    Stage &st = stage();
+    std::lock_guard<std::mutex> lock(st.mutex);
+    appendLine(st.data, message, level);
+    if (level < st.mostSevere)
+      st.mostSevere = level;
+    if (st.data.size() >= staging_.bufferBytes
+        || (flushPolicy_.onError
+            && level == LogLevel::Error))
+      handOff(st);
     return;
   }
 
+  // Строку формата "[время] [уровень] сообщение"
+  // собираем до взятия блокировки
+  std::string line;
+  appendLine(line, message, level);
+
   // Блокируем мьютекс для потокобезопасного доступа к файлу
   std::lock_guard<std::mutex> lock(logMutex_);
+  writeLocked(line, level);
+}
+
+// Запись пачки сообщений: строки форматируются вне
+// блокировки, затем выполняется одна запись и не больше
+// одного сброса
+void Logger::logBatch(const LogMessage *messages,
+                      std::size_t count) {
+  LogLevel current = loadLevel();
+
+  if (staging_.enabled) {
+    Stage &st = stage();
+    std::lock_guard<std::mutex> lock(st.mutex);
+    for (std::size_t i = 0; i < count; ++i) {
+      if (messages[i].level > current)
+        continue;  // Сообщение ниже текущего уровня
+      appendLine(st.data, messages[i].text,
+                 messages[i].level);
+      if (messages[i].level < st.mostSevere)
+        st.mostSevere = messages[i].level;
+    }
+    if (st.data.size() >= staging_.bufferBytes
+        || (flushPolicy_.onError
+            && st.mostSevere == LogLevel::Error))
+      handOff(st);
+    return;
+  }
 
-  if (logFile_.is_open()) {
-    // Записываем строку лога в формате: [время] [уровень]
-    // сообщение
-    logFile_ << "[" << getCurrentTime() << "] "
-             << "[" << Logger::logLevelToString(level)
-             << "] " << message << std::endl;
+  std::string out;
+  LogLevel mostSevere = LogLevel::Info;
+  for (std::size_t i = 0; i < count; ++i) {
+    if (messages[i].level > current)
+      continue;  // Сообщение ниже текущего уровня
+    appendLine(out, messages[i].text, messages[i].level);
+    if (messages[i].level < mostSevere)
+      mostSevere = messages[i].level;
   }
+  if (out.empty())
+    return;
+
+  std::lock_guard<std::mutex> lock(logMutex_);
+  writeLocked(out, mostSevere);
 }
 
-// Установка текущего уровня логирования с защитой мьютексом
-void Logger::setLogLevel(LogLevel level) {
+// Буфер текущего потока. Поток хранит ссылки на буферы
+// всех логгеров, в которые писал; буферы уничтоженных
+// логгеров удаляются при поиске
+Logger::Stage &Logger::stage() {
+  thread_local std::vector<
+    std::pair<std::uint64_t, std::shared_ptr<Stage>>>
+    owned;
+  for (auto &entry : owned) {
+    if (entry.first == id_)
+      return *entry.second;
+  }
+
+  owned.erase(
+    std::remove_if(owned.begin(), owned.end(),
+                   [](const auto &entry) {
+                     return entry.second->closed.load(
+                       std::memory_order_relaxed);
+                   }),
+    owned.end());
+
+  auto st = std::make_shared<Stage>();
+  st->data.reserve(staging_.bufferBytes);
+  {
+    std::lock_guard<std::mutex> lock(stagesMutex_);
+    stages_.push_back(st);
+  }
+  owned.emplace_back(id_, st);
+  return *st;
+}
+
+// Передача буфера писателю: под общим мьютексом только
+// перемещается строка, взамен берётся свободная
+void Logger::handOff(Stage &st) {
+  if (st.data.empty())
+    return;
+
+  bool wake = false;
+  {
+    std::lock_guard<std::mutex> lock(handoffMutex_);
+    wake = staged_.empty();
+    staged_.push_back(
+      StagedChunk{std::move(st.data), st.mostSevere});
+    if (!spare_.empty()) {
+      st.data = std::move(spare_.back());
+      spare_.pop_back();
+    } else {
+      st.data = std::string();
+    }
+  }
+  st.data.clear();
+  st.mostSevere = LogLevel::Info;
+  if (wake)
+    stagedCv_.notify_one();
+}
+
+// Сбор недозаполненных буферов. Буферы потоков, которые
+// завершились (ссылку держит только логгер), после сбора
+// удаляются из списка
+void Logger::collectStages() {
+  std::lock_guard<std::mutex> lock(stagesMutex_);
+  for (auto &st : stages_) {
+    std::lock_guard<std::mutex> stageLock(st->mutex);
+    handOff(*st);
+  }
+  stages_.erase(
+    std::remove_if(stages_.begin(), stages_.end(),
+                   [](const std::shared_ptr<Stage> &st) {
+                     return st.use_count() == 1;
+                   }),
+    stages_.end());
+}
+
+// Запись переданных блоков. Блоки забираются и пишутся под
+// logMutex_, поэтому параллельные вызовы (писатель и
+// flush()) не нарушают их порядок
+void Logger::writeStaged() {
   std::lock_guard<std::mutex> lock(logMutex_);
-  currentLevel_ = level;
+  {
+    std::lock_guard<std::mutex> handoffLock(handoffMutex_);
+    writing_.swap(staged_);
+  }
+  if (writing_.empty())
+    return;
+
+  for (auto &chunk : writing_)
+    writeLocked(chunk.text, chunk.mostSevere);
+
+  std::lock_guard<std::mutex> handoffLock(handoffMutex_);
+  for (auto &chunk : writing_) {
+    if (spare_.size() >= kMaxSpareBuffers)
+      break;
+    chunk.text.clear();
+    spare_.push_back(std::move(chunk.text));
+  }
+  writing_.clear();
 }
 
-// Получение текущего уровня логирования с защитой мьютексом
-LogLevel Logger::getLogLevel() const {
+// Фоновый писатель: пишет переданные блоки по мере
+// поступления и раз в collectInterval забирает
+// недозаполненные буферы
+void Logger::runStagingWriter() {
+  using Clock = std::chrono::steady_clock;
+  Clock::time_point nextCollect
+    = Clock::now() + staging_.collectInterval;
+
+  std::unique_lock<std::mutex> lock(handoffMutex_);
+  while (!stopStaging_) {
+    stagedCv_.wait_until(lock, nextCollect, [this] {
+      return !staged_.empty() || stopStaging_;
+    });
+    lock.unlock();
+    if (Clock::now() >= nextCollect) {
+      collectStages();
+      nextCollect = Clock::now() + staging_.collectInterval;
+    }
+    writeStaged();
+    lock.lock();
+  }
+}
+
+// Принудительный сброс буфера на диск
+void Logger::flush() {
+  if (staging_.enabled) {
+    collectStages();
+    writeStaged();
+  }
+
   std::lock_guard<std::mutex> lock(logMutex_);
-  return currentLevel_;
-}
-
-// Вспомогательный метод для получения текущего времени в
-// строковом формате
-std::string Logger::getCurrentTime() const {
-  auto now = std::chrono::system_clock::now();
-  std::time_t t = std::chrono::system_clock::to_time_t(now);
-  char buf[64];
-  // Форматируем время в строку вида "YYYY-MM-DD HH:MM:SS"
-  std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S",
-                std::localtime(&t));
-  return buf;
+  if (file_->stream.is_open()) {
+    file_->stream.flush();
+    unflushedBytes_ = 0;
+  }
+}
+
+// Запись текста в буфер потока и сброс по политике
+void Logger::writeLocked(const std::string &text,
+                         LogLevel mostSevere) {
+  std::ofstream &stream = file_->stream;
+  if (!stream.is_open())
+    return;
+
+  stream.write(text.data(),
+               static_cast<std::streamsize>(text.size()));
+  unflushedBytes_ += text.size();
+  fileBytes_ += text.size();
+
+  // Превышение размера только будит поток ротации: подмена
+  // файла происходит не на пути вызывающего
+  if (rotation_.maxBytes > 0
+      && fileBytes_ >= rotation_.maxBytes
+      && !rotationPending_) {
+    rotationPending_ = true;
+    {
+      std::lock_guard<std::mutex> lock(rotatorMutex_);
+      rotationRequested_ = true;
+    }
+    rotatorCv_.notify_all();
+  }
+
+  bool needFlush
+    = flushPolicy_.eachMessage
+      || (flushPolicy_.onError
+          && mostSevere == LogLevel::Error)
+      || (flushPolicy_.everyBytes > 0
+          && unflushedBytes_ >= flushPolicy_.everyBytes);
+  if (needFlush) {
+    stream.flush();
+    unflushedBytes_ = 0;
+  }
+}
+
+// Фоновый поток: раз в interval сбрасывает накопленные
+// данные, если они есть
+void Logger::runFlushTicker() {
+  std::unique_lock<std::mutex> lock(tickerMutex_);
+  while (!tickerCv_.wait_for(lock, flushPolicy_.interval,
+                             [this] { return stopTicker_; })) {
+    std::lock_guard<std::mutex> logLock(logMutex_);
+    if (unflushedBytes_ > 0 && file_->stream.is_open()) {
+      file_->stream.flush();
+      unflushedBytes_ = 0;
+    }
+  }
+}
+
+// Немедленная ротация с ожиданием её завершения
+bool Logger::rotate() {
+  if (!rotator_.joinable())
+    return false;
+
+  std::unique_lock<std::mutex> lock(rotatorMutex_);
+  // Если ротация уже идёт, она могла начаться до вызова —
+  // ждём следующую попытку
+  std::uint64_t target
+    = rotationAttempts_ + (rotationInProgress_ ? 2 : 1);
+  rotationRequested_ = true;
+  rotatorCv_.notify_all();
+  rotatorCv_.wait(lock, [this, target] {
+    return rotationAttempts_ >= target || stopRotator_;
+  });
+  return rotationAttempts_ >= target && lastRotationOk_;
+}
+
+// Признак сборки с поддержкой сжатия
+bool Logger::compressionSupported() {
+#ifdef LOGGER_HAVE_ZLIB
+  return true;
+#else
+  return false;
+#endif
+}
+
+// Открытие лог-файла с собственным буфером потока
+std::unique_ptr<Logger::LogFile> Logger::openFile() const {
+  auto file = std::make_unique<LogFile>();
+  file->buffer.resize(bufferSize_);
+  // Буфер потока должен быть установлен до открытия файла
+  if (!file->buffer.empty()) {
+    file->stream.rdbuf()->pubsetbuf(
+      file->buffer.data(),
+      static_cast<std::streamsize>(file->buffer.size()));
+  }
+  file->stream.open(filename_, std::ios::app);
+  return file;
+}
+
+// Фоновый поток ротации: ждёт запроса по размеру, вызова
+// rotate() или наступления интервала. После неудачи
+// ротация по размеру остаётся запрошенной (записи не будят
+// поток) до retryAt; пауза удваивается до минуты и
+// сбрасывается после удачной ротации
+void Logger::runRotator() {
+  using Clock = std::chrono::steady_clock;
+  constexpr Clock::time_point kNever
+    = Clock::time_point::max();
+  const Clock::duration maxRetry
+    = std::max<Clock::duration>(rotation_.retryDelay,
+                                std::chrono::minutes(1));
+  bool timed = rotation_.interval.count() > 0;
+  Clock::time_point deadline
+    = timed ? Clock::now() + rotation_.interval : kNever;
+  Clock::time_point retryAt = kNever;
+  Clock::duration retryDelay = rotation_.retryDelay;
+
+  std::unique_lock<std::mutex> lock(rotatorMutex_);
+  while (true) {
+    auto wakeUp
+      = [this] { return rotationRequested_ || stopRotator_; };
+    Clock::time_point until = std::min(deadline, retryAt);
+    if (until != kNever)
+      rotatorCv_.wait_until(lock, until, wakeUp);
+    else
+      rotatorCv_.wait(lock, wakeUp);
+    if (stopRotator_)
+      break;
+
+    if (Clock::now() >= retryAt) {
+      retryAt = kNever;
+      // logMutex_ берётся без rotatorMutex_: запись держит
+      // их в обратном порядке
+      lock.unlock();
+      rearmRotation();
+      lock.lock();
+    }
+    bool due = Clock::now() >= deadline;
+    if (!rotationRequested_ && !due)
+      continue;
+
+    rotationRequested_ = false;
+    rotationInProgress_ = true;
+    lock.unlock();
+    bool ok = rotateNow();
+    lock.lock();
+    rotationInProgress_ = false;
+    ++rotationAttempts_;
+    if (ok) {
+      ++rotations_;
+      retryDelay = rotation_.retryDelay;
+      retryAt = kNever;
+    } else if (retryAt == kNever) {
+      retryAt = Clock::now() + retryDelay;
+      retryDelay = std::min(retryDelay * 2, maxRetry);
+    }
+    lastRotationOk_ = ok;
+    if (timed)
+      deadline = Clock::now() + rotation_.interval;
+    rotatorCv_.notify_all();
+  }
+}
+
+// Ротация: переименование, открытие нового файла вне
+// блокировки, подмена указателя под блокировкой, затем
+// закрытие, сжатие и очистка старых сегментов. При ошибке
+// файл остаётся прежним, а повтор назначает runRotator
+bool Logger::rotateNow() {
+  // Пустой сегмент не нужен (ротация по интервалу без
+  // записей)
+  {
+    std::lock_guard<std::mutex> lock(logMutex_);
+    if (fileBytes_ == 0) {
+      rotationPending_ = false;
+      return true;
+    }
+  }
+
+  // Имя сегмента: <файл>.<ГГГГММДД-ЧЧММСС>-<N>
+  char stamp[32];
+  std::time_t now = std::time(nullptr);
+  std::tm tm{};
+  localtime_r(&now, &tm);
+  std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &tm);
+  char seq[16];
+  std::snprintf(seq, sizeof(seq), "-%04llu",
+                static_cast<unsigned long long>(
+                  segmentSeq_++ % 10000));
+  std::string segment = filename_ + "." + stamp + seq;
+
+  // После неудачи записи сверх maxBytes не будят поток
+  // ротации, пока runRotator не назначит повтор
+  auto fail = [this] {
+    std::lock_guard<std::mutex> lock(logMutex_);
+    rotationPending_ = true;
+    return false;
+  };
+
+  // Открытый поток продолжает писать в переименованный
+  // файл, пока указатель не подменён
+  if (std::rename(filename_.c_str(), segment.c_str()) != 0) {
+    perror("rename");
+    return fail();
+  }
+
+  auto fresh = openFile();
+  if (!fresh->stream.is_open()) {
+    fprintf(stderr, "Failed to open log file: %s\n",
+            filename_.c_str());
+    std::rename(segment.c_str(), filename_.c_str());
+    return fail();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(logMutex_);
+    file_.swap(fresh);
+    fileBytes_ = 0;
+    unflushedBytes_ = 0;
+    rotationPending_ = false;
+  }
+  fresh.reset();  // Закрываем старый сегмент (со сбросом)
+
+#ifdef LOGGER_HAVE_ZLIB
+  if (rotation_.compress)
+    compressFile(segment, segment + ".gz");
+#endif
+  pruneSegments(filename_, rotation_);
+  return true;
+}
+
+// Снимает флаг запрошенной ротации по размеру: следующая
+// запись сверх maxBytes снова будит поток ротации
+void Logger::rearmRotation() {
+  std::lock_guard<std::mutex> lock(logMutex_);
+  rotationPending_ = false;
+}
+
+// Установка текущего уровня логирования (атомарно, без
+// блокировки записи)
+void Logger::setLogLevel(LogLevel level) {
+  storeLevel(level);
+}
+
+// Получение текущего уровня логирования
+LogLevel Logger::getLogLevel() const {
+  return loadLevel();
+}
+
+// Форматирует одну строку лога в конец буфера out
+void Logger::appendLine(std::string &out,
+                        const std::string &message,
+                        LogLevel level) const {
+  if (sequenceNumbers_) {
+    char digits[24];
+    auto seq
+      = sequence_.fetch_add(1, std::memory_order_relaxed);
+    auto res
+      = std::to_chars(digits, digits + sizeof(digits), seq);
+    out += '#';
+    out.append(digits, res.ptr);
+    out += ' ';
+  }
+  out += '[';
+  timestamp_.append(out);
+  out += "] [";
+  out += logLevelToString(level);
+  out += "] ";
+  out += message;
+  out += '\n';
 }
 
 // Преобразование значения LogLevel в строку для вывода в
@@ -0,0 +1,297 @@
+#include "logger/MmapFileLogger.h"
+
+#include <fcntl.h>  // Для open и posix_fallocate
+#include <sys/mman.h>  // Для mmap, munmap, msync
+#include <sys/stat.h>  // Для fstat
+#include <unistd.h>  // Для pread, ftruncate, close
+
+#include <algorithm>  // Для std::min
+#include <cstdio>  // Для perror
+#include <cstring>  // Для memcpy, memchr
+
+namespace logger {
+
+namespace {
+
+// Размер блока чтения при восстановлении префикса
+constexpr std::size_t kScanChunk = 64 * 1024;
+
+// Буфер форматирования строки (свой в каждом потоке,
+// ёмкость переиспользуется между вызовами)
+thread_local std::string lineBuffer;
+
+}  // namespace
+
+// Конструктор: открываем файл, восстанавливаем корректный
+// префикс и выделяем таблицу экстентов
+MmapFileLogger::MmapFileLogger(const std::string &filename,
+                               LogLevel level,
+                               MmapLoggerOptions options)
+    : ILogger(level),
+      maxExtents_(options.maxExtents),
+      timestamp_(options.timestamp),
+      extents_(new std::atomic<char *>[options.maxExtents]) {
+  // Экстент должен быть кратен размеру страницы, чтобы его
+  // можно было отобразить по смещению в файле
+  auto page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  extentSize_
+    = std::max(page, (options.extentSize + page - 1) / page
+                       * page);
+  for (std::size_t i = 0; i < maxExtents_; ++i) {
+    extents_[i].store(nullptr, std::memory_order_relaxed);
+  }
+
+  fd_ = open(filename.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd_ < 0) {
+    // Как и Logger, сообщаем об ошибке в stderr без
+    // исключений
+    fprintf(stderr, "Failed to open log file: %s\n",
+            filename.c_str());
+    return;
+  }
+  next_.store(recoverValidPrefix(),
+              std::memory_order_relaxed);
+}
+
+// Деструктор: снимаем отображения и обрезаем файл до
+// фактической длины записанных данных
+MmapFileLogger::~MmapFileLogger() {
+  if (fd_ < 0)
+    return;
+
+  for (std::size_t i = 0; i < maxExtents_; ++i) {
+    char *addr = extents_[i].load(std::memory_order_acquire);
+    if (addr != nullptr)
+      munmap(addr, extentSize_);
+  }
+  if (ftruncate(fd_, static_cast<off_t>(size())) < 0)
+    perror("ftruncate");
+  close(fd_);
+}
+
+// Запись одного сообщения
+void MmapFileLogger::log(const std::string &message,
+                         LogLevel level) {
+  if (!isEnabled(level) || fd_ < 0)
+    return;
+
+  lineBuffer.clear();
+  appendLine(lineBuffer, message, level);
+  write(lineBuffer);
+}
+
+// Запись пачки: строки собираются в один буфер и
+// резервируются одним fetch_add
+void MmapFileLogger::logBatch(const LogMessage *messages,
+                              std::size_t count) {
+  if (fd_ < 0)
+    return;
+
+  LogLevel current = loadLevel();
+  lineBuffer.clear();
+  for (std::size_t i = 0; i < count; ++i) {
+    if (messages[i].level > current)
+      continue;  // Сообщение ниже текущего уровня
+    appendLine(lineBuffer, messages[i].text,
+               messages[i].level);
+  }
+  if (!lineBuffer.empty())
+    write(lineBuffer);
+}
+
+// Установка текущего уровня логирования
+void MmapFileLogger::setLogLevel(LogLevel level) {
+  storeLevel(level);
+}
+
+// Получение текущего уровня логирования
+LogLevel MmapFileLogger::getLogLevel() const {
+  return loadLevel();
+}
+
+// Синхронный сброс всех отображённых экстентов. Экстенты
+// отображает писатель, занявший в них место, поэтому
+// следующий может быть уже отображён, а предыдущий ещё нет
+void MmapFileLogger::flush() {
+  for (std::size_t i = 0; i < maxExtents_; ++i) {
+    char *addr = extents_[i].load(std::memory_order_acquire);
+    if (addr == nullptr)
+      continue;
+    msync(addr, extentSize_, MS_SYNC);
+  }
+}
+
+// Логическая длина файла (без учёта преаллоцированного
+// хвоста)
+std::size_t MmapFileLogger::size() const {
+  return std::min(next_.load(std::memory_order_acquire),
+                  extentSize_ * maxExtents_);
+}
+
+// Число отброшенных сообщений
+std::uint64_t MmapFileLogger::droppedCount() const {
+  return dropped_.load(std::memory_order_relaxed);
+}
+
+// Восстановление после аварийного завершения: хвост файла
+// заполнен нулями, незавершённые записи оставляют нулевые
+// «дыры». Находим последний ненулевой байт, затем первый
+// нулевой байт в последнем экстенте перед ним и обрезаем
+// файл по последней полной строке.
+std::size_t MmapFileLogger::recoverValidPrefix() {
+  struct stat st {};
+  if (fstat(fd_, &st) < 0 || st.st_size == 0)
+    return 0;
+  auto fileSize = static_cast<std::size_t>(st.st_size);
+
+  char chunk[kScanChunk];
+
+  // Последний ненулевой байт (сканируем с конца)
+  std::size_t end = fileSize;
+  while (end > 0) {
+    std::size_t from
+      = end > kScanChunk ? end - kScanChunk : 0;
+    ssize_t got = pread(fd_, chunk, end - from,
+                        static_cast<off_t>(from));
+    if (got <= 0)
+      break;
+    auto n = static_cast<std::size_t>(got);
+    std::size_t i = n;
+    while (i > 0 && chunk[i - 1] == '\0')
+      --i;
+    if (i > 0) {
+      end = from + i;
+      break;
+    }
+    end = from;
+  }
+
+  // Незавершённые записи могут быть только рядом с концом
+  // записанных данных — ищем первый нулевой байт там
+  std::size_t scanFrom
+    = end > extentSize_ ? end - extentSize_ : 0;
+  std::size_t valid = end;
+  for (std::size_t pos = scanFrom; pos < end;) {
+    std::size_t len = std::min(kScanChunk, end - pos);
+    ssize_t got
+      = pread(fd_, chunk, len, static_cast<off_t>(pos));
+    if (got <= 0)
+      break;
+    auto n = static_cast<std::size_t>(got);
+    const void *zero = std::memchr(chunk, '\0', n);
+    if (zero != nullptr) {
+      valid = pos
+              + static_cast<std::size_t>(
+                static_cast<const char *>(zero) - chunk);
+      break;
+    }
+    pos += n;
+  }
+
+  // Если префикс обрезан нулём, отбрасываем неполную
+  // строку перед ним
+  if (valid < end) {
+    while (valid > 0) {
+      char c = 0;
+      if (pread(fd_, &c, 1, static_cast<off_t>(valid - 1))
+            != 1
+          || c == '\n')
+        break;
+      --valid;
+    }
+  }
+
+  if (valid != fileSize
+      && ftruncate(fd_, static_cast<off_t>(valid)) < 0) {
+    perror("ftruncate");
+  }
+  return valid;
+}
+
+// Резервирование места и копирование текста по экстентам
+void MmapFileLogger::write(const std::string &text) {
+  std::size_t len = text.size();
+  std::size_t offset
+    = next_.fetch_add(len, std::memory_order_acq_rel);
+  if (offset + len > extentSize_ * maxExtents_) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return;  // Файл достиг предельного размера
+  }
+
+  const char *src = text.data();
+  while (len > 0) {
+    std::size_t index = offset / extentSize_;
+    std::size_t inExtent = offset % extentSize_;
+    std::size_t part = std::min(len, extentSize_ - inExtent);
+
+    char *base = extent(index);
+    if (base == nullptr) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    std::memcpy(base + inExtent, src, part);
+
+    src += part;
+    offset += part;
+    len -= part;
+  }
+}
+
+// Отображение экстента: быстрый путь — атомарное чтение
+// адреса, медленный путь — расширение файла под мьютексом
+char *MmapFileLogger::extent(std::size_t index) {
+  char *addr
+    = extents_[index].load(std::memory_order_acquire);
+  if (addr != nullptr)
+    return addr;
+
+  std::lock_guard<std::mutex> lock(growMutex_);
+  addr = extents_[index].load(std::memory_order_acquire);
+  if (addr != nullptr)
+    return addr;  // Другой поток уже отобразил экстент
+
+  auto start = static_cast<off_t>(index * extentSize_);
+  auto length = static_cast<off_t>(extentSize_);
+  // Преаллокация блоков; если ФС её не поддерживает —
+  // достаточно увеличить длину файла
+  if (posix_fallocate(fd_, start, length) != 0
+      && ftruncate(fd_, start + length) < 0) {
+    perror("ftruncate");
+    return nullptr;
+  }
+
+  void *mapped = mmap(nullptr, extentSize_,
+                      PROT_READ | PROT_WRITE, MAP_SHARED,
+                      fd_, start);
+  if (mapped == MAP_FAILED) {
+    perror("mmap");
+    return nullptr;
+  }
+  addr = static_cast<char *>(mapped);
+  extents_[index].store(addr, std::memory_order_release);
+  return addr;
+}
+
+// Форматирование строки лога. Нулевые байты в сообщении
+// заменяются пробелами: ноль служит признаком конца
+// корректных данных при восстановлении
+void MmapFileLogger::appendLine(std::string &out,
+                                const std::string &message,
+                                LogLevel level) const {
+  out += '[';
+  timestamp_.append(out);
+  out += "] [";
+  out += logLevelName(level);
+  out += "] ";
+  std::size_t start = out.size();
+  out += message;
+  if (std::memchr(message.data(), '\0', message.size())
+      != nullptr) {
+    std::replace(out.begin()
+                   + static_cast<std::ptrdiff_t>(start),
+                 out.end(), '\0', ' ');
+  }
+  out += '\n';
+}
+
+}  // namespace logger
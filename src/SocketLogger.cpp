@@ -1,119 +1,560 @@
 #include "logger/SocketLogger.h"
 
-#include <arpa/inet.h>  // Для функций работы с IP (inet_pton)
+#include <netinet/in.h>  // Для IPPROTO_TCP
+#include <netinet/tcp.h>  // Для TCP_NODELAY
+#include <poll.h>  // Для ожидания готовности сокета
+#include <sys/socket.h>  // Для socket, connect, send
 #include <unistd.h>  // Для системных вызовов close, shutdown
 
-#include <chrono>  // Для работы со временем
-#include <cstring>  // Для memset и др.
-#include <ctime>  // Для преобразования времени
-#include <iomanip>   // Для std::put_time
-#include <iostream>  // Для perror
-#include <sstream>   // Для std::ostringstream
+#include <cerrno>  // Для errno
+#include <cstdio>  // Для fprintf
+#include <cstring>  // Для strerror, memcpy
+
+#include "logger/FrameProtocol.h"  // Кадры и рукопожатие
 
 namespace logger {
 
-// Конструктор: создаёт TCP-сокет и подключается к
-// указанному хосту и порту
+namespace {
+
+// Сколько байт поток ввода-вывода забирает из кольца за раз
+constexpr std::size_t kMaxChunk = 64 * 1024;
+
+// Сколько ждать готовности сокета к записи за один шаг
+// (чтобы периодически проверять остановку)
+constexpr std::chrono::milliseconds kSendWait{100};
+
+// Заголовок записи кольца: уровень и время
+constexpr std::size_t kRecordHeader
+  = 1 + sizeof(std::int64_t);
+
+// Буфер сборки записи (свой в каждом потоке)
+thread_local std::string lineBuffer;
+
+// Ожидание события на сокете; true — событие наступило
+bool waitFor(int fd, short events,
+             std::chrono::milliseconds timeout) {
+  pollfd pfd{fd, events, 0};
+  int rc = 0;
+  do {
+    rc = poll(&pfd, 1, static_cast<int>(timeout.count()));
+  } while (rc < 0 && errno == EINTR);
+  return rc > 0;
+}
+
+}  // namespace
+
+// Конструктор: запоминает адрес и запускает поток
+// ввода-вывода, который сам подключается к серверу
+SocketLogger::SocketLogger(const Endpoint &endpoint,
+                           LogLevel defaultLevel,
+                           SocketLoggerOptions options)
+    : ILogger(defaultLevel),
+      endpoint_(endpoint),
+      options_(options),
+      spill_(options.spillBytes) {
+  io_ = std::thread(&SocketLogger::run, this);
+}
+
 SocketLogger::SocketLogger(const std::string &host,
-                           int port, LogLevel defaultLevel)
-    : logLevel_(defaultLevel) {
-  sock_ = socket(AF_INET, SOCK_STREAM, 0);
-  if (sock_ < 0) {
-    perror("socket");  // Вывод ошибки при создании сокета
-    return;
+                           int port, LogLevel defaultLevel,
+                           SocketLoggerOptions options)
+    : SocketLogger(Endpoint::tcp(host, port), defaultLevel,
+                   options) {}
+
+// Деструктор: поток ввода-вывода дописывает буфер (не
+// дольше lingerTimeout) и закрывает сокет
+SocketLogger::~SocketLogger() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  dataCv_.notify_all();
+  io_.join();
+}
+
+// Постановка сообщения в буфер отправки: строка
+// форматируется до взятия блокировки, под блокировкой —
+// только копирование в кольцо
+void SocketLogger::log(const std::string &message,
+                       LogLevel level) {
+  if (!isEnabled(level))
+    return;  // Отсекаем до взятия блокировки
+
+  lineBuffer.clear();
+  appendRecord(lineBuffer, message, level);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  bool wake = enqueueLocked(lineBuffer) && ioWaiting_;
+  lock.unlock();
+  if (wake)
+    dataCv_.notify_one();
+}
+
+// Постановка пачки сообщений: каждое сообщение остаётся
+// отдельной записью кольца
+void SocketLogger::logBatch(const LogMessage *messages,
+                            std::size_t count) {
+  LogLevel current = loadLevel();
+  std::vector<std::size_t> ends;
+  lineBuffer.clear();
+  for (std::size_t i = 0; i < count; ++i) {
+    if (messages[i].level > current)
+      continue;  // Сообщение ниже текущего уровня
+    appendRecord(lineBuffer, messages[i].text,
+                 messages[i].level);
+    ends.push_back(lineBuffer.size());
   }
+  if (ends.empty())
+    return;
 
-  sockaddr_in serverAddr{};
-  serverAddr.sin_family = AF_INET;  // Используем IPv4
-  serverAddr.sin_port = htons(
-    static_cast<uint16_t>(port));  // Устанавливаем порт (в сетевом порядке байт)
-  inet_pton(
-    AF_INET, host.c_str(),
-    &serverAddr
-       .sin_addr);  // Преобразуем IP-адрес из строки
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (stopping_) {
+    // Как в log(): поток ввода-вывода уже завершается
+    dropped_ += ends.size();
+    return;
+  }
+  bool queued = false;
+  std::size_t begin = 0;
+  for (std::size_t end : ends) {
+    if (spill_.push(lineBuffer.data() + begin, end - begin))
+      queued = true;
+    else
+      ++dropped_;
+    begin = end;
+  }
+  bool wake = queued && ioWaiting_;
+  lock.unlock();
+  if (wake)
+    dataCv_.notify_one();
+}
 
-  // Пытаемся подключиться к серверу
-  if (connect(sock_, (sockaddr *)&serverAddr,
-              sizeof(serverAddr))
-      < 0) {
-    perror("connect");  // Ошибка подключения
-    close(sock_);  // Закрываем сокет при ошибке
-    sock_ = -1;  // Помечаем сокет как невалидный
+// Копирование записи в кольцо
+bool SocketLogger::enqueueLocked(
+  const std::string &record) {
+  if (stopping_
+      || !spill_.push(record.data(), record.size())) {
+    ++dropped_;
+    return false;
   }
+  return true;
 }
 
-// Деструктор: закрывает сокет, если он был открыт
-SocketLogger::~SocketLogger() {
+// Ожидание отправки всех принятых сообщений
+bool SocketLogger::flush(std::chrono::milliseconds timeout) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return drainedCv_.wait_for(lock, timeout, [this] {
+    return spill_.empty() && !sending_;
+  });
+}
+
+// Признак установленного соединения
+bool SocketLogger::isConnected() const {
+  return connected_.load(std::memory_order_relaxed);
+}
+
+// Признак соединения в протоколе кадров
+bool SocketLogger::isFramed() const {
+  return framed_.load(std::memory_order_relaxed);
+}
+
+// Число отброшенных сообщений
+std::uint64_t SocketLogger::droppedCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return dropped_;
+}
+
+// Цикл потока ввода-вывода: забирает из кольца пачку
+// целых записей, при необходимости подключается и
+// отправляет её. Пауза между неудачными подключениями
+// удваивается от reconnectMin до reconnectMax
+void SocketLogger::run() {
+  using Clock = std::chrono::steady_clock;
+  auto backoff = options_.reconnectMin;
+  Clock::time_point deadline = Clock::time_point::max();
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    if (stopping_ && deadline == Clock::time_point::max())
+      deadline = Clock::now() + options_.lingerTimeout;
+    if (stopping_ && Clock::now() >= deadline)
+      break;  // Остаток не успели отправить
+
+    if (!sending_) {
+      if (spill_.empty()) {
+        drainedCv_.notify_all();
+        if (stopping_)
+          break;
+        ioWaiting_ = true;
+        dataCv_.wait(lock, [this] {
+          return !spill_.empty() || stopping_;
+        });
+        ioWaiting_ = false;
+        continue;
+      }
+      raw_.clear();
+      rawEnds_.clear();
+      next_ = 0;
+      spill_.popInto(raw_, rawEnds_, kMaxChunk);
+      wire_.clear();  // Кодируется после подключения
+      sending_ = true;
+    }
+    lock.unlock();
+
+    if (sock_ < 0 && !connectNow()) {
+      auto pause = backoff;
+      backoff = std::min(backoff * 2, options_.reconnectMax);
+      lock.lock();
+      if (!stopping_) {
+        // Остановка прерывает паузу
+        dataCv_.wait_for(lock, pause,
+                         [this] { return stopping_; });
+      } else {
+        lock.unlock();
+        std::this_thread::sleep_for(std::min(
+          std::chrono::duration_cast<Clock::duration>(pause),
+          deadline - Clock::now()));
+        lock.lock();
+      }
+      continue;
+    }
+    backoff = options_.reconnectMin;
+
+    if (wire_.empty())
+      encodeWire();
+    bool alive = endpoint_.isStream()
+                   ? sendPending(kSendWait)
+                   : sendDatagrams(kSendWait);
+    if (!alive)
+      disconnect();
+    lock.lock();
+    if (alive && sent_ == wire_.size())
+      sending_ = false;
+  }
+  lock.unlock();
+
   if (sock_ >= 0) {
     close(sock_);
+    sock_ = -1;
+    connected_.store(false, std::memory_order_relaxed);
   }
 }
 
-// Метод для отправки лог-сообщения по сокету
-void SocketLogger::log(const std::string &message,
-                       LogLevel level) {
-  std::lock_guard<std::mutex> lock(
-    mutex_);  // Потокобезопасность
-  if (level > logLevel_ || sock_ < 0)
-    return;  // Игнорируем, если уровень ниже или сокет не
-             // валиден
-
-  std::ostringstream oss;
-
-  // Получаем текущее время для таймстампа
-  auto now = std::chrono::system_clock::now();
-  auto now_c = std::chrono::system_clock::to_time_t(now);
-
-  // Формируем строку времени в формате "YYYY-MM-DD
-  // HH:MM:SS"
-  oss << "["
-      << std::put_time(std::localtime(&now_c), "%F %T")
-      << "] ";
-
-  // Добавляем строковое представление уровня логирования
-  switch (level) {
-    case LogLevel::Error:
-      oss << "[ERROR] ";
-      break;
-    case LogLevel::Warning:
-      oss << "[WARNING] ";
-      break;
-    case LogLevel::Info:
-      oss << "[INFO] ";
-      break;
+// Подключение неблокирующим сокетом с таймаутом. Об
+// ошибке сообщаем один раз на каждый обрыв, а не на каждую
+// попытку. Датаграммный сокет connect() только привязывает
+// к адресу сервера (для AF_UNIX — если сокет сервера
+// существует)
+bool SocketLogger::connectNow() {
+  sockaddr_storage serverAddr{};
+  socklen_t addrLen = 0;
+  if (!toSockaddr(endpoint_, serverAddr, addrLen)) {
+    if (!reportedDown_) {
+      fprintf(stderr, "SocketLogger: bad address %s\n",
+              toString(endpoint_).c_str());
+      reportedDown_ = true;
+    }
+    return false;
   }
 
-  oss << message
-      << "\n";  // Добавляем текст сообщения и символ новой
-                // строки для разделения сообщений
+  int fd = openSocket(endpoint_);
+  if (fd < 0) {
+    perror("socket");
+    return false;
+  }
 
-  std::string out = oss.str();
-  size_t totalSent = 0;
-  size_t toSend = out.size();
+  int rc = connect(
+    fd, reinterpret_cast<sockaddr *>(&serverAddr), addrLen);
+  if (rc < 0 && errno == EINPROGRESS) {
+    int err = ETIMEDOUT;
+    if (waitFor(fd, POLLOUT, options_.connectTimeout)) {
+      socklen_t len = sizeof(err);
+      getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len);
+    }
+    errno = err;
+    rc = err == 0 ? 0 : -1;
+  }
+  if (rc < 0) {
+    if (!reportedDown_) {
+      fprintf(stderr, "SocketLogger: connect to %s: %s\n",
+              toString(endpoint_).c_str(), strerror(errno));
+      reportedDown_ = true;
+    }
+    close(fd);
+    return false;
+  }
 
-  // Цикл, отправляющий все данные по сокету (send может
-  // отправить не все сразу)
-  while (totalSent < toSend) {
-    ssize_t sent = send(sock_, out.data() + totalSent,
-                        toSend - totalSent, 0);
-    if (sent == -1) {
-      perror("send");  // Вывод ошибки при отправке
-      break;
+  // Записи уже собраны в пачки — алгоритм Нейгла только
+  // добавил бы задержку
+  if (endpoint_.transport == Transport::Tcp) {
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one,
+               sizeof(one));
+  }
+  sock_ = fd;
+  bool framed = false;
+  if (options_.protocol == WireProtocol::Framed
+      && endpoint_.isStream()) {
+    if (!textOnce_) {
+      framed = handshake();
+    } else {
+      textOnce_ = false;
     }
-    totalSent += sent;
   }
+  if (sock_ < 0) {
+    // Приветствие ушло, а подтверждения нет: сервер мог
+    // уже перейти на кадры, поэтому текст — только на
+    // новом соединении
+    if (textOnce_)
+      return connectNow();
+    return false;  // Соединение оборвалось при рукопожатии
+  }
+  framed_.store(framed, std::memory_order_relaxed);
+  reportedDown_ = false;
+  connected_.store(true, std::memory_order_relaxed);
+  return true;
 }
 
-// Установка текущего уровня логирования с защитой мьютексом
+// Рукопожатие протокола кадров: приветствие с версией и
+// ожидание подтверждения. Старый сервер не отвечает, а
+// медленный может ответить позже срока, уже переключив
+// соединение на кадры. Поэтому, если приветствие ушло
+// целиком, а подтверждения за handshakeTimeout нет (или
+// ответ другой), сокет закрывается и textOnce_ велит
+// следующему подключению сразу перейти на текст
+bool SocketLogger::handshake() {
+  using Clock = std::chrono::steady_clock;
+  auto deadline = Clock::now() + options_.handshakeTimeout;
+  auto remaining = [deadline] {
+    return std::chrono::duration_cast<
+      std::chrono::milliseconds>(
+      std::max(deadline - Clock::now(),
+               Clock::duration(0)));
+  };
+
+  std::string hello = frame::helloLine();
+  std::size_t done = 0;
+  while (done < hello.size()) {
+    ssize_t n = send(sock_, hello.data() + done,
+                     hello.size() - done,
+                     MSG_NOSIGNAL | MSG_DONTWAIT);
+    if (n > 0) {
+      done += static_cast<std::size_t>(n);
+    } else if (n < 0
+               && (errno == EAGAIN || errno == EINTR)) {
+      if (waitFor(sock_, POLLOUT, remaining()))
+        continue;
+      if (done == 0)
+        return false;  // Ничего не ушло — остаёмся на тексте
+      // Обрывок приветствия склеился бы с первой строкой
+      // текста — соединение открывается заново
+      close(sock_);
+      sock_ = -1;
+      return false;
+    } else {
+      close(sock_);
+      sock_ = -1;
+      return false;
+    }
+  }
+
+  std::string reply;
+  char buf[64];
+  while (reply.find('\n') == std::string::npos
+         && reply.size() < sizeof(buf)) {
+    if (!waitFor(sock_, POLLIN, remaining()))
+      break;  // Ответа нет
+    ssize_t n = recv(sock_, buf, sizeof(buf), MSG_DONTWAIT);
+    if (n > 0) {
+      reply.append(buf, static_cast<std::size_t>(n));
+    } else if (n == 0
+               || (errno != EAGAIN && errno != EINTR)) {
+      close(sock_);
+      sock_ = -1;
+      return false;
+    }
+  }
+  // Сравнивается только первая строка ответа
+  if (reply.find('\n') != std::string::npos
+      && reply.compare(0, reply.find('\n') + 1,
+                       frame::ackLine())
+           == 0)
+    return true;
+  close(sock_);
+  sock_ = -1;
+  textOnce_ = true;
+  return false;
+}
+
+// Кодирование записей с next_ в протоколе текущего
+// соединения
+void SocketLogger::encodeWire() {
+  bool framed = framed_.load(std::memory_order_relaxed);
+  wire_.clear();
+  wireEnds_.clear();
+  sent_ = 0;
+
+  std::size_t begin = next_ == 0 ? 0 : rawEnds_[next_ - 1];
+  for (std::size_t i = next_; i < rawEnds_.size(); ++i) {
+    const char *record = raw_.data() + begin;
+    auto level = static_cast<LogLevel>(record[0]);
+    std::int64_t ticks = 0;
+    std::memcpy(&ticks, record + 1, sizeof(ticks));
+    std::string_view message(record + kRecordHeader,
+                             rawEnds_[i] - begin
+                               - kRecordHeader);
+
+    if (framed) {
+      frame::appendFrame(wire_, level, ticks, message);
+    } else {
+      // Строка "[время] [уровень] сообщение\n"
+      char stamp[TimestampFormatter::kMaxLength];
+      std::size_t len = options_.timestamp.format(
+        stamp, std::chrono::system_clock::time_point(
+                 std::chrono::duration_cast<
+                   std::chrono::system_clock::duration>(
+                   std::chrono::nanoseconds(ticks))));
+      wire_ += '[';
+      wire_.append(stamp, len);
+      wire_ += "] [";
+      wire_ += logLevelName(level);
+      wire_ += "] ";
+      wire_.append(message.data(), message.size());
+      wire_ += '\n';
+    }
+    wireEnds_.push_back(wire_.size());
+    begin = rawEnds_[i];
+  }
+}
+
+// Отправка wire_ с позиции sent_. Если сокет не готов
+// к записи дольше wait, возвращает управление, чтобы цикл
+// мог проверить остановку
+bool SocketLogger::sendPending(
+  std::chrono::milliseconds wait) {
+  // Перед новой пачкой проверяем, не закрыл ли сервер
+  // соединение: иначе первая запись в мёртвое соединение
+  // «успешно» уйдёт в никуда
+  if (sent_ == 0
+      && waitFor(sock_, POLLIN, std::chrono::milliseconds(0))) {
+    char probe;
+    ssize_t got
+      = recv(sock_, &probe, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (got == 0
+        || (got < 0 && errno != EAGAIN
+            && errno != EWOULDBLOCK))
+      return false;
+  }
+
+  while (sent_ < wire_.size()) {
+    ssize_t n = send(sock_, wire_.data() + sent_,
+                     wire_.size() - sent_,
+                     MSG_NOSIGNAL | MSG_DONTWAIT);
+    if (n > 0) {
+      sent_ += static_cast<std::size_t>(n);
+      continue;
+    }
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      // Сервер не успевает читать — ждём, но не дольше wait
+      if (!waitFor(sock_, POLLOUT, wait))
+        return true;
+      continue;
+    }
+    return false;
+  }
+  return true;
+}
+
+// Отправка датаграмм: каждая запись wire_ целиком, с
+// начала записи sent_. Слишком большая запись
+// отбрасывается (EMSGSIZE); отказ сервера (ECONNREFUSED,
+// ENOENT) обрабатывается как обрыв соединения
+bool SocketLogger::sendDatagrams(
+  std::chrono::milliseconds wait) {
+  std::size_t record = 0;
+  while (record < wireEnds_.size()
+         && wireEnds_[record] <= sent_)
+    ++record;
+
+  while (sent_ < wire_.size()) {
+    std::size_t end = wireEnds_[record];
+    std::size_t len = end - sent_;
+    if (len > 0 && wire_[end - 1] == '\n')
+      --len;  // Граница сообщения — сама датаграмма
+    ssize_t n = send(sock_, wire_.data() + sent_, len,
+                     MSG_NOSIGNAL | MSG_DONTWAIT);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK
+                  || errno == ENOBUFS)) {
+      if (!waitFor(sock_, POLLOUT, wait))
+        return true;
+      continue;
+    }
+    if (n < 0 && errno == EMSGSIZE) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++dropped_;
+    } else if (n < 0) {
+      return false;
+    }
+    sent_ = end;
+    ++record;
+  }
+  return true;
+}
+
+// Разрыв соединения: сокет закрывается, отправка
+// продолжится с начала недоотправленной записи (запись
+// может дойти дважды, но не обрезанной). Записи
+// перекодируются под протокол нового соединения
+void SocketLogger::disconnect() {
+  if (!reportedDown_) {
+    fprintf(stderr,
+            "SocketLogger: connection to %s lost\n",
+            toString(endpoint_).c_str());
+    reportedDown_ = true;
+  }
+  close(sock_);
+  sock_ = -1;
+  connected_.store(false, std::memory_order_relaxed);
+  framed_.store(false, std::memory_order_relaxed);
+
+  for (std::size_t end : wireEnds_) {
+    if (end > sent_)
+      break;
+    ++next_;  // Запись отправлена целиком
+  }
+  wire_.clear();
+  wireEnds_.clear();
+  sent_ = 0;
+}
+
+// Запись кольца: уровень, время (наносекунды от эпохи) и
+// текст. Метка времени фиксируется в момент вызова log(),
+// а форматируется при отправке
+void SocketLogger::appendRecord(std::string &out,
+                                const std::string &message,
+                                LogLevel level) const {
+  std::int64_t ticks
+    = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        options_.timestamp.now().time_since_epoch())
+        .count();
+  out += static_cast<char>(level);
+  char bytes[sizeof(ticks)];
+  std::memcpy(bytes, &ticks, sizeof(ticks));
+  out.append(bytes, sizeof(bytes));
+  out += message;
+}
+
+// Установка текущего уровня логирования
 void SocketLogger::setLogLevel(LogLevel level) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  logLevel_ = level;
+  storeLevel(level);
 }
 
-// Получение текущего уровня логирования с защитой мьютексом
+// Получение текущего уровня логирования
 LogLevel SocketLogger::getLogLevel() const {
-  std::lock_guard<std::mutex> lock(mutex_);
-  return logLevel_;
+  return loadLevel();
 }
 
 }  // namespace logger
@@ -0,0 +1,122 @@
+#include "logger/Timestamp.h"
+
+#include <time.h>  // Для clock_gettime и localtime_r
+
+#include <cstring>  // Для memcpy
+#include <ctime>  // Для std::time_t, std::strftime
+
+namespace logger {
+
+namespace {
+
+// Длина префикса "YYYY-MM-DD HH:MM:SS"
+constexpr std::size_t kSecondsLength = 19;
+
+// Кэш префикса текущей секунды (свой в каждом потоке,
+// поэтому не нужна синхронизация)
+struct SecondCache {
+  std::time_t second = -1;  // Закэшированная секунда
+  char text[kSecondsLength + 1];  // Отформатированный
+                                  // префикс
+};
+
+thread_local SecondCache secondCache;
+
+// Показания грубых монотонных часов в наносекундах
+std::chrono::nanoseconds coarseMonotonic() {
+  timespec ts{};
+  clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+  return std::chrono::seconds(ts.tv_sec)
+         + std::chrono::nanoseconds(ts.tv_nsec);
+}
+
+// Записывает value в buf ровно digits десятичными цифрами
+void writeDigits(char *buf, long value, int digits) {
+  for (int i = digits - 1; i >= 0; --i) {
+    buf[i] = static_cast<char>('0' + value % 10);
+    value /= 10;
+  }
+}
+
+}  // namespace
+
+// Конструктор: для быстрых часов фиксируем смещение
+// монотонного времени относительно системного
+TimestampFormatter::TimestampFormatter(
+  TimePrecision precision, ClockSource source)
+    : precision_(precision), source_(source) {
+  if (source_ == ClockSource::Fast) {
+    fastOffset_ = std::chrono::duration_cast<
+                    std::chrono::nanoseconds>(
+                    std::chrono::system_clock::now()
+                      .time_since_epoch())
+                  - coarseMonotonic();
+  }
+}
+
+// Текущее время: системное или монотонное со смещением
+std::chrono::system_clock::time_point
+TimestampFormatter::now() const {
+  if (source_ == ClockSource::Fast) {
+    return std::chrono::system_clock::time_point(
+      std::chrono::duration_cast<
+        std::chrono::system_clock::duration>(
+        coarseMonotonic() + fastOffset_));
+  }
+  return std::chrono::system_clock::now();
+}
+
+// Форматирование метки времени с кэшированием префикса
+std::size_t TimestampFormatter::format(
+  char *buf, std::chrono::system_clock::time_point tp) const {
+  auto sinceEpoch = tp.time_since_epoch();
+  auto seconds
+    = std::chrono::duration_cast<std::chrono::seconds>(
+      sinceEpoch);
+  std::time_t t = static_cast<std::time_t>(seconds.count());
+
+  // Пересобираем префикс только при смене секунды
+  if (secondCache.second != t) {
+    std::tm tm{};
+    localtime_r(&t, &tm);
+    std::strftime(secondCache.text,
+                  sizeof(secondCache.text),
+                  "%Y-%m-%d %H:%M:%S", &tm);
+    secondCache.second = t;
+  }
+  std::memcpy(buf, secondCache.text, kSecondsLength);
+
+  auto micros
+    = std::chrono::duration_cast<std::chrono::microseconds>(
+        sinceEpoch - seconds)
+        .count();
+  switch (precision_) {
+    case TimePrecision::Seconds:
+      return kSecondsLength;
+    case TimePrecision::Milliseconds:
+      buf[kSecondsLength] = '.';
+      writeDigits(buf + kSecondsLength + 1,
+                  static_cast<long>(micros / 1000), 3);
+      return kSecondsLength + 4;
+    case TimePrecision::Microseconds:
+      buf[kSecondsLength] = '.';
+      writeDigits(buf + kSecondsLength + 1,
+                  static_cast<long>(micros), 6);
+      return kSecondsLength + 7;
+  }
+  return kSecondsLength;
+}
+
+// Дописывает текущую метку времени в строку
+void TimestampFormatter::append(std::string &out) const {
+  char buf[kMaxLength];
+  out.append(buf, format(buf, now()));
+}
+
+// Текущая метка времени строкой
+std::string TimestampFormatter::current() const {
+  char buf[kMaxLength];
+  return std::string(buf, format(buf, now()));
+}
+
+}  // namespace logger
@@ -0,0 +1,519 @@
+#include "EntryStore.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+#include "logger/FrameProtocol.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+namespace frame = logger::frame;
+
+// Новый блок индекса начинается каждые kBlockBytes
+constexpr uint64_t kBlockBytes = 64 * 1024;
+
+// Сегмент пишется кусками не меньше kWriteBuffer
+constexpr size_t kWriteBuffer = 64 * 1024;
+
+// Сообщение в кольце не держит буфер заметно больше себя,
+// иначе одно длинное сообщение раздует память навсегда
+constexpr size_t kSlackBytes = 4096;
+
+// Имя сегмента: "seg-" + 20 цифр номера + расширение, так
+// что имена сортируются в порядке номеров
+constexpr size_t kIdDigits = 20;
+
+namespace {
+
+// Дописывает запись сегмента: длина, уровень, время, текст
+void appendRecord(string &out, const StoredEntry &entry) {
+  frame::appendBigEndian(
+    out, static_cast<uint32_t>(frame::kFixedBody
+                               + entry.message.size()));
+  out += static_cast<char>(entry.level);
+  frame::appendBigEndian(
+    out, static_cast<int64_t>(entry.timestamp));
+  out += entry.message;
+}
+
+// Разбирает запись с позиции pos; false — запись неполная
+// или повреждена
+bool readRecord(const string &data, size_t &pos,
+                StoredEntry &out) {
+  if (data.size() - pos < 4)
+    return false;
+  auto body = static_cast<uint32_t>(
+    frame::readBigEndian(data.data() + pos, 4));
+  if (body < frame::kFixedBody
+      || body > frame::kMaxFrameBody
+      || data.size() - pos - 4 < body)
+    return false;
+  const char *p = data.data() + pos + 4;
+  auto level = static_cast<unsigned char>(p[0]);
+  if (level >= kStatsLevels)
+    return false;
+  out.level = static_cast<StatsLevel>(level);
+  out.timestamp = static_cast<time_t>(
+    static_cast<int64_t>(frame::readBigEndian(p + 1, 8)));
+  out.message.assign(p + frame::kFixedBody,
+                     body - frame::kFixedBody);
+  pos += 4 + body;
+  return true;
+}
+
+// Читает до len байт файла с offset (меньше — если файл
+// короче); false при ошибке
+bool readAt(int fd, uint64_t offset, size_t len,
+            string &out) {
+  out.resize(len);
+  size_t done = 0;
+  while (done < len) {
+    ssize_t n = pread(fd, &out[done], len - done,
+                      static_cast<off_t>(offset + done));
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n < 0) {
+      perror("pread");
+      return false;
+    }
+    if (n == 0)
+      break;
+    done += static_cast<size_t>(n);
+  }
+  out.resize(done);
+  return true;
+}
+
+}  // namespace
+
+EntryStore::EntryStore(EntryStoreOptions options)
+    : options_(move(options)),
+      ring_(options_.memoryEntries) {}
+
+EntryStore::~EntryStore() {
+  lock_guard<mutex> lock(mutex_);
+  for (size_t i = 0; i < count_; ++i)
+    spillLocked(ring_[(head_ + i) % ring_.size()]);
+  count_ = 0;
+  sealLocked();
+}
+
+string EntryStore::segmentPath(uint64_t id,
+                               const char *ext) const {
+  string number = to_string(id);
+  number.insert(0, kIdDigits - number.size(), '0');
+  return (fs::path(options_.directory)
+          / ("seg-" + number + ext))
+    .string();
+}
+
+// Сегменты прошлого запуска становятся закрытыми, новые
+// записи пойдут в следующий по номеру
+bool EntryStore::open() {
+  if (options_.directory.empty())
+    return true;
+
+  error_code ec;
+  fs::create_directories(options_.directory, ec);
+  if (ec) {
+    fprintf(stderr,
+            "Failed to create store directory %s: %s\n",
+            options_.directory.c_str(),
+            ec.message().c_str());
+    return false;
+  }
+
+  auto isDigit = [](char c) {
+    return c >= '0' && c <= '9';
+  };
+  vector<uint64_t> ids;
+  for (fs::directory_iterator it(options_.directory, ec),
+       endIt;
+       !ec && it != endIt; it.increment(ec)) {
+    string name = it->path().filename().string();
+    if (name.size() != 4 + kIdDigits + 4
+        || name.compare(0, 4, "seg-") != 0
+        || name.compare(4 + kIdDigits, 4, ".log") != 0
+        || !all_of(name.begin() + 4,
+                   name.begin() + 4 + kIdDigits, isDigit))
+      continue;
+    ids.push_back(stoull(name.substr(4, kIdDigits)));
+  }
+  sort(ids.begin(), ids.end());
+
+  lock_guard<mutex> lock(mutex_);
+  for (uint64_t id : ids) {
+    Segment segment;
+    segment.id = id;
+    vector<Block> blocks;
+    nextId_ = id + 1;
+    if (!loadIndex(segment, blocks))
+      continue;
+    if (segment.bytes == 0) {
+      remove(segmentPath(id, ".log").c_str());
+      remove(segmentPath(id, ".idx").c_str());
+      continue;
+    }
+    segments_.push_back(segment);
+  }
+  pruneLocked(time(nullptr));
+  return true;
+}
+
+// Запись длиннее кадра не прочиталась бы обратно, а после
+// перезапуска сегмент был бы отрезан на ней как оборванный
+void EntryStore::append(time_t timestamp, StatsLevel level,
+                        string_view message) {
+  message = message.substr(0, kMaxMessage);
+  lock_guard<mutex> lock(mutex_);
+  if (ring_.empty()) {
+    spillLocked({timestamp, level, string(message)});
+    return;
+  }
+
+  // Полное кольцо вытесняет самое старое сообщение на диск
+  // и переиспользует его буфер
+  StoredEntry *slot = nullptr;
+  if (count_ < ring_.size()) {
+    slot = &ring_[(head_ + count_++) % ring_.size()];
+  } else {
+    slot = &ring_[head_];
+    spillLocked(*slot);
+    head_ = (head_ + 1) % ring_.size();
+  }
+  slot->timestamp = timestamp;
+  slot->level = level;
+  slot->message.assign(message.data(), message.size());
+  if (slot->message.capacity()
+      > slot->message.size() * 2 + kSlackBytes)
+    slot->message.shrink_to_fit();
+}
+
+// Метаданные и кольцо копируются под мьютексом (буфер
+// записи при этом дописывается в файл), а сегменты
+// читаются уже без него, чтобы запрос не задерживал приём
+void EntryStore::query(time_t from, time_t to,
+                       const Visitor &visit) {
+  vector<Segment> segments;
+  vector<Block> active;
+  bool hasActive = false;
+  vector<StoredEntry> recent;
+  {
+    lock_guard<mutex> lock(mutex_);
+    flushLocked();
+    segments = segments_;
+    active = blocks_;
+    hasActive = fd_ >= 0;
+    for (size_t i = 0; i < count_; ++i) {
+      const StoredEntry &entry
+        = ring_[(head_ + i) % ring_.size()];
+      if (entry.timestamp >= from && entry.timestamp <= to)
+        recent.push_back(entry);
+    }
+  }
+
+  for (size_t i = 0; i < segments.size(); ++i) {
+    Segment &segment = segments[i];
+    if (segment.maxTime < from || segment.minTime > to)
+      continue;
+    vector<Block> blocks;
+    if (hasActive && i + 1 == segments.size()) {
+      blocks = active;
+    } else if (!readIndex(segment, blocks)) {
+      // Без индекса сегмент читается целиком
+      blocks.assign(
+        1, Block{0, segment.minTime, segment.maxTime});
+    }
+    if (!visitSegment(segment, blocks, from, to, visit))
+      return;
+  }
+  for (const StoredEntry &entry : recent) {
+    if (!visit(entry))
+      return;
+  }
+}
+
+void EntryStore::prune(time_t now) {
+  lock_guard<mutex> lock(mutex_);
+  pruneLocked(now);
+}
+
+bool EntryStore::flush() {
+  lock_guard<mutex> lock(mutex_);
+  return flushLocked();
+}
+
+EntryStoreUsage EntryStore::usage() const {
+  lock_guard<mutex> lock(mutex_);
+  EntryStoreUsage result;
+  result.memoryEntries = count_;
+  result.segments = segments_.size();
+  for (const Segment &segment : segments_)
+    result.diskBytes += segment.bytes;
+  result.prunedSegments = pruned_;
+  return result;
+}
+
+void EntryStore::spillLocked(const StoredEntry &entry) {
+  if (options_.directory.empty() || diskFailed_)
+    return;  // Хранится только кольцо
+  if (fd_ >= 0
+      && segments_.back().bytes >= options_.segmentBytes) {
+    sealLocked();
+    pruneLocked(time(nullptr));
+  }
+  if (fd_ < 0 && !startSegmentLocked())
+    return;
+
+  Segment &segment = segments_.back();
+  indexRecord(segment, blocks_, segment.bytes,
+              static_cast<int64_t>(entry.timestamp));
+  size_t before = pending_.size();
+  appendRecord(pending_, entry);
+  segment.bytes += pending_.size() - before;
+  if (pending_.size() >= kWriteBuffer)
+    flushLocked();
+}
+
+bool EntryStore::startSegmentLocked() {
+  Segment segment;
+  segment.id = nextId_++;
+  string path = segmentPath(segment.id, ".log");
+  fd_ = ::open(path.c_str(),
+               O_WRONLY | O_CREAT | O_TRUNC | O_APPEND
+                 | O_CLOEXEC,
+               0644);
+  if (fd_ < 0) {
+    perror("open");
+    fprintf(stderr, "Entry store: segments disabled\n");
+    diskFailed_ = true;
+    return false;
+  }
+  segments_.push_back(segment);
+  blocks_.clear();
+  return true;
+}
+
+void EntryStore::sealLocked() {
+  if (fd_ < 0)
+    return;
+  if (flushLocked())
+    writeIndex(segments_.back(), blocks_);
+  if (fd_ >= 0)
+    close(fd_);
+  fd_ = -1;
+  blocks_.clear();
+}
+
+// После ошибки записи сегмент закрывается без индекса
+// (при следующем запуске он будет перечитан и обрезан),
+// и дальше хранится только кольцо
+bool EntryStore::flushLocked() {
+  size_t done = 0;
+  while (fd_ >= 0 && done < pending_.size()) {
+    ssize_t n = ::write(fd_, pending_.data() + done,
+                        pending_.size() - done);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n < 0) {
+      perror("write");
+      fprintf(stderr, "Entry store: segments disabled\n");
+      Segment &segment = segments_.back();
+      segment.bytes -= pending_.size() - done;
+      while (!blocks_.empty()
+             && blocks_.back().offset >= segment.bytes)
+        blocks_.pop_back();
+      pending_.clear();
+      close(fd_);
+      fd_ = -1;
+      diskFailed_ = true;
+      return false;
+    }
+    done += static_cast<size_t>(n);
+  }
+  pending_.clear();
+  return true;
+}
+
+// Удаляются только закрытые сегменты, от старых к новым
+void EntryStore::pruneLocked(time_t now) {
+  uint64_t total = 0;
+  for (const Segment &segment : segments_)
+    total += segment.bytes;
+  size_t sealed = fd_ >= 0 ? segments_.size() - 1
+                           : segments_.size();
+  size_t drop = 0;
+  for (; drop < sealed; ++drop) {
+    const Segment &segment = segments_[drop];
+    bool tooBig = options_.retentionBytes > 0
+                  && total > options_.retentionBytes;
+    bool tooOld = options_.retentionSeconds > 0
+                  && segment.maxTime
+                       < static_cast<int64_t>(now)
+                           - options_.retentionSeconds;
+    if (!tooBig && !tooOld)
+      break;
+    total -= segment.bytes;
+    remove(segmentPath(segment.id, ".log").c_str());
+    remove(segmentPath(segment.id, ".idx").c_str());
+  }
+  segments_.erase(segments_.begin(),
+                  segments_.begin()
+                    + static_cast<ptrdiff_t>(drop));
+  pruned_ += drop;
+}
+
+void EntryStore::indexRecord(Segment &segment,
+                             vector<Block> &blocks,
+                             uint64_t offset,
+                             int64_t time) {
+  if (blocks.empty()
+      || offset - blocks.back().offset >= kBlockBytes)
+    blocks.push_back(Block{offset, time, time});
+  Block &block = blocks.back();
+  block.minTime = min(block.minTime, time);
+  block.maxTime = max(block.maxTime, time);
+  segment.minTime = min(segment.minTime, time);
+  segment.maxTime = max(segment.maxTime, time);
+}
+
+// Формат .idx (текст): "размер мин макс", затем по
+// строке "смещение мин макс" на блок
+bool EntryStore::readIndex(Segment &segment,
+                           vector<Block> &blocks) const {
+  struct stat st {};
+  if (stat(segmentPath(segment.id, ".log").c_str(), &st)
+      < 0)
+    return false;
+  ifstream in(segmentPath(segment.id, ".idx"));
+  uint64_t bytes = 0;
+  Segment parsed = segment;
+  if (!(in >> bytes >> parsed.minTime >> parsed.maxTime)
+      || bytes != static_cast<uint64_t>(st.st_size))
+    return false;
+  blocks.clear();
+  Block block;
+  while (in >> block.offset >> block.minTime
+         >> block.maxTime)
+    blocks.push_back(block);
+  parsed.bytes = bytes;
+  segment = parsed;
+  return true;
+}
+
+bool EntryStore::loadIndex(Segment &segment,
+                           vector<Block> &blocks) const {
+  if (readIndex(segment, blocks))
+    return true;
+  if (!scanSegment(segment, blocks))
+    return false;
+  writeIndex(segment, blocks);
+  return true;
+}
+
+bool EntryStore::scanSegment(Segment &segment,
+                             vector<Block> &blocks) const {
+  string path = segmentPath(segment.id, ".log");
+  int fd = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+  if (fd < 0) {
+    perror("open");
+    return false;
+  }
+  struct stat st {};
+  string data;
+  bool ok = fstat(fd, &st) == 0
+            && readAt(fd, 0,
+                      static_cast<size_t>(st.st_size),
+                      data);
+
+  segment.bytes = 0;
+  segment.minTime = INT64_MAX;
+  segment.maxTime = INT64_MIN;
+  blocks.clear();
+  size_t pos = 0;
+  StoredEntry entry;
+  while (ok) {
+    size_t start = pos;
+    if (!readRecord(data, pos, entry))
+      break;
+    indexRecord(segment, blocks, start,
+                static_cast<int64_t>(entry.timestamp));
+  }
+  // Оборванная при аварийном завершении запись отрезается,
+  // чтобы файл снова состоял из целых записей
+  if (ok && pos < data.size()
+      && ftruncate(fd, static_cast<off_t>(pos)) < 0) {
+    perror("ftruncate");
+  }
+  segment.bytes = pos;
+  close(fd);
+  return ok;
+}
+
+// Индекс пишется во временный файл и переименовывается,
+// чтобы .idx никогда не был записан наполовину
+bool EntryStore::writeIndex(
+  const Segment &segment,
+  const vector<Block> &blocks) const {
+  string path = segmentPath(segment.id, ".idx");
+  string temp = path + ".tmp";
+  {
+    ofstream out(temp, ios::trunc);
+    out << segment.bytes << " " << segment.minTime << " "
+        << segment.maxTime << "\n";
+    for (const Block &block : blocks)
+      out << block.offset << " " << block.minTime << " "
+          << block.maxTime << "\n";
+    if (!out) {
+      fprintf(stderr, "Failed to write index: %s\n",
+              temp.c_str());
+      return false;
+    }
+  }
+  if (rename(temp.c_str(), path.c_str()) < 0) {
+    perror("rename");
+    return false;
+  }
+  return true;
+}
+
+bool EntryStore::visitSegment(const Segment &segment,
+                              const vector<Block> &blocks,
+                              time_t from, time_t to,
+                              const Visitor &visit) const {
+  int fd = ::open(segmentPath(segment.id, ".log").c_str(),
+                  O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return true;  // Сегмент уже удалён по ограничению
+
+  string data;
+  StoredEntry entry;
+  bool more = true;
+  for (size_t b = 0; more && b < blocks.size(); ++b) {
+    const Block &block = blocks[b];
+    if (block.maxTime < from || block.minTime > to)
+      continue;
+    uint64_t end = b + 1 < blocks.size()
+                     ? blocks[b + 1].offset
+                     : segment.bytes;
+    if (end <= block.offset
+        || !readAt(fd, block.offset,
+                   static_cast<size_t>(end - block.offset),
+                   data))
+      continue;
+    size_t pos = 0;
+    while (more && readRecord(data, pos, entry)) {
+      if (entry.timestamp >= from && entry.timestamp <= to)
+        more = visit(entry);
+    }
+  }
+  close(fd);
+  return more;
+}
@@ -0,0 +1,178 @@
+#pragma once  // Защита от повторного включения
+              // заголовочного файла
+
+#include <cstddef>  // Для std::size_t
+#include <cstdint>  // Для целых фиксированной ширины
+#include <ctime>  // Для time_t
+#include <functional>  // Для обхода записей
+#include <mutex>  // Для мьютекса хранилища
+#include <string>  // Для сообщений и путей
+#include <string_view>  // Для сообщений без копирования
+#include <vector>  // Для кольца и списка сегментов
+
+#include "Stats.h"  // Уровни статистики
+#include "logger/FrameProtocol.h"  // Формат записей
+
+// Сохранённое сообщение
+struct StoredEntry {
+  time_t timestamp = 0;  // Время записи
+  StatsLevel level = StatsLevel::Unknown;  // Уровень
+  std::string message;  // Текст
+};
+
+// Параметры хранилища сообщений
+struct EntryStoreOptions {
+  std::string directory;  // Каталог сегментов; пустой —
+                          // хранится только кольцо
+  std::size_t memoryEntries
+    = 10000;  // Последних сообщений в памяти
+  std::uint64_t segmentBytes
+    = 16 * 1024 * 1024;  // Размер сегмента, после которого
+                         // начинается следующий
+  std::uint64_t retentionBytes
+    = 0;  // Предел сегментов на диске; 0 — без предела
+  std::int64_t retentionSeconds
+    = 0;  // Предел возраста сегмента; 0 — без предела
+};
+
+// Занятое хранилищем место (для отчёта)
+struct EntryStoreUsage {
+  std::size_t memoryEntries = 0;  // Сообщений в кольце
+  std::size_t segments = 0;  // Сегментов на диске
+  std::uint64_t diskBytes = 0;  // Байт в сегментах
+  std::uint64_t prunedSegments = 0;  // Удалено по
+                                     // ограничению хранения
+};
+
+// Хранилище принятых сообщений с ограниченной памятью.
+// Последние memoryEntries сообщений лежат в кольце;
+// вытесняемые из него дописываются в сегментные файлы
+// каталога (только добавление, запись — как кадр
+// FrameProtocol: длина, уровень, время, текст). Для
+// каждого сегмента ведётся индекс блоков по 64 КиБ с
+// диапазоном времени записей, он сохраняется рядом
+// (.idx) при закрытии сегмента, так что запрос за период
+// читает только подходящие блоки. Сегменты сверх
+// retentionBytes или старше retentionSeconds удаляются,
+// начиная со старых. Писатель — поток реактора;
+// запросы можно выполнять из любого потока.
+class EntryStore {
+ public:
+  // Обход записей: false — остановить
+  using Visitor = std::function<bool(const StoredEntry &)>;
+
+  // Предел длины сообщения: запись не длиннее кадра,
+  // более длинное сообщение обрезается
+  static constexpr std::size_t kMaxMessage
+    = logger::frame::kMaxFrameBody
+      - logger::frame::kFixedBody;
+
+  explicit EntryStore(EntryStoreOptions options);
+
+  // Сбрасывает кольцо на диск и закрывает сегмент
+  ~EntryStore();
+
+  EntryStore(const EntryStore &) = delete;
+  EntryStore &operator=(const EntryStore &) = delete;
+
+  // Создаёт каталог и подхватывает сегменты прошлого
+  // запуска (оборванная запись в конце отрезается).
+  // Без каталога ничего не делает. false при ошибке
+  bool open();
+
+  // Добавляет сообщение (не длиннее kMaxMessage)
+  void append(time_t timestamp, StatsLevel level,
+              std::string_view message);
+
+  // Передаёт visit сообщения со временем в [from, to]:
+  // сначала с диска, потом из кольца, в порядке приёма.
+  // Диск читается без блокировки хранилища
+  void query(time_t from, time_t to, const Visitor &visit);
+
+  // Удаляет сегменты сверх ограничений хранения
+  void prune(time_t now);
+
+  // Дописывает буфер записи в текущий сегмент
+  bool flush();
+
+  // Занятое место
+  EntryStoreUsage usage() const;
+
+ private:
+  // Блок сегмента в индексе: начало и диапазон времени
+  struct Block {
+    std::uint64_t offset = 0;  // Смещение первой записи
+    std::int64_t minTime = 0;  // Самая ранняя запись
+    std::int64_t maxTime = 0;  // Самая поздняя запись
+  };
+
+  // Сегментный файл
+  struct Segment {
+    std::uint64_t id = 0;  // Номер (имя файла)
+    std::uint64_t bytes = 0;  // Размер с учётом буфера
+    std::int64_t minTime = INT64_MAX;  // Диапазон времени
+    std::int64_t maxTime = INT64_MIN;  // записей
+  };
+
+  // Путь файла сегмента с расширением ext
+  std::string segmentPath(std::uint64_t id,
+                          const char *ext) const;
+
+  // Дописывает вытесненную из кольца запись в сегмент
+  void spillLocked(const StoredEntry &entry);
+
+  // Открывает новый сегмент
+  bool startSegmentLocked();
+
+  // Дописывает буфер и сохраняет индекс текущего сегмента
+  void sealLocked();
+
+  bool flushLocked();
+  void pruneLocked(time_t now);
+
+  // Учитывает в индексе запись со смещением offset
+  static void indexRecord(Segment &segment,
+                          std::vector<Block> &blocks,
+                          std::uint64_t offset,
+                          std::int64_t time);
+
+  // Читает .idx сегмента; false — его нет или он не
+  // совпадает с файлом
+  bool readIndex(Segment &segment,
+                 std::vector<Block> &blocks) const;
+
+  // Индекс из .idx или, если он не подходит,
+  // перечитыванием файла (с сохранением нового .idx)
+  bool loadIndex(Segment &segment,
+                 std::vector<Block> &blocks) const;
+
+  // Перечитывает файл сегмента, отрезая оборванную запись
+  bool scanSegment(Segment &segment,
+                   std::vector<Block> &blocks) const;
+
+  bool writeIndex(const Segment &segment,
+                  const std::vector<Block> &blocks) const;
+
+  // Читает подходящие блоки сегмента; false — visit
+  // попросил остановиться
+  bool visitSegment(const Segment &segment,
+                    const std::vector<Block> &blocks,
+                    time_t from, time_t to,
+                    const Visitor &visit) const;
+
+  EntryStoreOptions options_;  // Параметры
+  mutable std::mutex mutex_;  // Мьютекс хранилища
+  std::vector<StoredEntry> ring_;  // Последние сообщения
+  std::size_t head_ = 0;  // Самое старое в кольце
+  std::size_t count_ = 0;  // Сообщений в кольце
+  std::vector<Segment> segments_;  // Сегменты по порядку;
+                                   // последний — текущий,
+                                   // если fd_ открыт
+  std::vector<Block> blocks_;  // Индекс текущего сегмента
+  int fd_ = -1;  // Текущий сегмент
+  std::string pending_;  // Ещё не записанные байты
+  std::uint64_t nextId_ = 0;  // Номер следующего сегмента
+  std::uint64_t pruned_ = 0;  // Удалено сегментов
+  bool diskFailed_ = false;  // Ошибка записи: сегменты
+                             // больше не пишутся
+};
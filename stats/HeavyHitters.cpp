@@ -0,0 +1,198 @@
+#include "HeavyHitters.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+using namespace std;
+
+namespace {
+
+constexpr uint64_t kFnvOffset = 14695981039346656037ull;
+constexpr uint64_t kFnvPrime = 1099511628211ull;
+
+inline uint64_t fnv(uint64_t hash, unsigned char c) {
+  return (hash ^ c) * kFnvPrime;
+}
+
+inline bool isWordChar(unsigned char c) {
+  return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z')
+         || (c >= 'A' && c <= 'Z') || c == '_' || c >= 0x80;
+}
+
+// По убыванию оценки, при равенстве — по отпечатку
+bool byCount(const HeavyHitter &a, const HeavyHitter &b) {
+  if (a.count != b.count)
+    return a.count > b.count;
+  return a.fingerprint < b.fingerprint;
+}
+
+}  // namespace
+
+HeavyHitters::HeavyHitters(size_t capacity)
+    : sketch_(make_unique<Counter[]>(kDepth * kWidth)),
+      slots_(make_unique<Slot[]>(max<size_t>(capacity, 1))),
+      capacity_(max<size_t>(capacity, 1)) {
+  for (size_t i = 0; i < kDepth * kWidth; ++i)
+    sketch_[i].store(0, memory_order_relaxed);
+  for (size_t i = 0; i < capacity_; ++i)
+    slots_[i].sample.reserve(kSampleBytes);
+}
+
+// Один проход: слово копится до разделителя и хешируется
+// как есть, а если в нём была цифра — как '#'
+uint64_t HeavyHitters::fingerprint(string_view line) {
+  uint64_t hash = kFnvOffset;
+  size_t word = 0;  // Начало текущего слова
+  bool digits = false;  // В слове есть цифра
+  for (size_t i = 0; i <= line.size(); ++i) {
+    auto c = i < line.size()
+               ? static_cast<unsigned char>(line[i])
+               : static_cast<unsigned char>(' ');
+    if (isWordChar(c)) {
+      digits = digits || (c >= '0' && c <= '9');
+      continue;
+    }
+    if (digits) {
+      hash = fnv(hash, '#');
+    } else {
+      for (size_t j = word; j < i; ++j)
+        hash
+          = fnv(hash, static_cast<unsigned char>(line[j]));
+    }
+    if (i < line.size())
+      hash = fnv(hash, c);
+    word = i + 1;
+    digits = false;
+  }
+  return hash;
+}
+
+// Строки скетча — двойное хеширование одного отпечатка
+// (h1 + row * h2), нечётный h2 обходит все счётчики
+size_t HeavyHitters::cell(size_t row,
+                          uint64_t fingerprint) const {
+  uint64_t h1 = fingerprint;
+  uint64_t h2 = (fingerprint >> 32) | 1;
+  return row * kWidth
+         + static_cast<size_t>((h1 + row * h2)
+                               & (kWidth - 1));
+}
+
+// Консервативное обновление: растут только счётчики,
+// равные минимуму, — оценка та же, а завышение от
+// коллизий меньше
+void HeavyHitters::add(string_view line) {
+  uint64_t key = fingerprint(line);
+  size_t cells[kDepth];
+  uint64_t least = UINT64_MAX;
+  for (size_t row = 0; row < kDepth; ++row) {
+    cells[row] = cell(row, key);
+    least = min(least, sketch_[cells[row]].load(
+                         memory_order_relaxed));
+  }
+  uint64_t count = least + 1;
+  for (size_t cellIndex : cells) {
+    Counter &counter = sketch_[cellIndex];
+    if (counter.load(memory_order_relaxed) == least)
+      counter.store(count, memory_order_relaxed);
+  }
+
+  // Оценка лидера только растёт, поэтому лидер всегда
+  // проходит эту проверку, а остальные — редко
+  if (used_ == capacity_ && count <= minCount_)
+    return;
+  for (size_t i = 0; i < used_; ++i) {
+    if (slots_[i].fingerprint == key) {
+      slots_[i].count.store(count, memory_order_relaxed);
+      return;
+    }
+  }
+
+  // Новый лидер: свободная ячейка или вытеснение
+  // наименьшего
+  size_t target = used_;
+  if (used_ == capacity_) {
+    target = 0;
+    for (size_t i = 1; i < used_; ++i) {
+      if (slots_[i].count.load(memory_order_relaxed)
+          < slots_[target].count.load(memory_order_relaxed))
+        target = i;
+    }
+    uint64_t smallest
+      = slots_[target].count.load(memory_order_relaxed);
+    if (count <= smallest) {
+      minCount_ = smallest;  // Минимум был устаревшим
+      return;
+    }
+  }
+  {
+    lock_guard<mutex> lock(mutex_);
+    Slot &slot = slots_[target];
+    slot.fingerprint = key;
+    slot.count.store(count, memory_order_relaxed);
+    // Пример — первая строка сообщения (кадр может быть
+    // многострочным)
+    slot.sample.assign(
+      line.substr(0, min(line.find('\n'), kSampleBytes)));
+    if (target == used_)
+      ++used_;
+  }
+  if (used_ == capacity_) {
+    minCount_ = UINT64_MAX;
+    for (size_t i = 0; i < used_; ++i)
+      minCount_
+        = min(minCount_,
+              slots_[i].count.load(memory_order_relaxed));
+  }
+}
+
+uint64_t HeavyHitters::estimate(
+  uint64_t fingerprint) const {
+  uint64_t least = UINT64_MAX;
+  for (size_t row = 0; row < kDepth; ++row)
+    least = min(least, sketch_[cell(row, fingerprint)].load(
+                         memory_order_relaxed));
+  return least;
+}
+
+vector<HeavyHitter> HeavyHitters::top() const {
+  vector<HeavyHitter> result;
+  {
+    lock_guard<mutex> lock(mutex_);
+    result.reserve(used_);
+    for (size_t i = 0; i < used_; ++i) {
+      const Slot &slot = slots_[i];
+      result.push_back(
+        {slot.fingerprint,
+         slot.count.load(memory_order_relaxed),
+         slot.sample});
+    }
+  }
+  sort(result.begin(), result.end(), byCount);
+  return result;
+}
+
+vector<HeavyHitter> mergeHeavyHitters(
+  const vector<const HeavyHitters *> &shards, size_t k) {
+  // Кандидат одного шарда мог попасть в другие шарды, не
+  // став там лидером, — его оценка берётся из скетча
+  // каждого шарда
+  unordered_map<uint64_t, HeavyHitter> candidates;
+  for (const HeavyHitters *shard : shards) {
+    for (HeavyHitter &hitter : shard->top())
+      candidates.emplace(hitter.fingerprint, move(hitter));
+  }
+  vector<HeavyHitter> result;
+  result.reserve(candidates.size());
+  for (auto &candidate : candidates) {
+    HeavyHitter &hitter = candidate.second;
+    hitter.count = 0;
+    for (const HeavyHitters *shard : shards)
+      hitter.count += shard->estimate(hitter.fingerprint);
+    result.push_back(move(hitter));
+  }
+  sort(result.begin(), result.end(), byCount);
+  if (result.size() > k)
+    result.resize(k);
+  return result;
+}
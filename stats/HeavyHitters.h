@@ -0,0 +1,94 @@
+#pragma once  // Защита от повторного включения
+              // заголовочного файла
+
+#include <atomic>  // Для счётчиков скетча
+#include <cstddef>  // Для std::size_t
+#include <cstdint>  // Для std::uint64_t
+#include <memory>  // Для таблицы скетча
+#include <mutex>  // Для мьютекса лидеров
+#include <string>  // Для примеров сообщений
+#include <string_view>  // Для сообщений без копирования
+#include <vector>  // Для лидеров
+
+// Часто повторяющееся сообщение
+struct HeavyHitter {
+  std::uint64_t fingerprint = 0;  // Отпечаток
+  std::uint64_t count = 0;  // Оценка числа (не меньше
+                            // настоящего)
+  std::string sample;  // Пример (начало первой строки
+                       // сообщения)
+};
+
+// Поиск самых частых сообщений в ограниченной памяти.
+// Сообщения сравниваются по отпечатку: хеш текста, в
+// котором каждое слово с цифрами (числа, время, id)
+// заменено на '#', поэтому "disk 91% full" и "disk 92%
+// full" — одно сообщение. Частоты считает Count-Min
+// Sketch (kDepth строк по kWidth счётчиков, консервативное
+// обновление), а оценки capacity лидеров хранятся в
+// маленькой таблице: сообщение, оценка которого превысила
+// наименьшую в ней, вытесняет наименьшее. На строку —
+// один хеш, kDepth счётчиков и, если оценка не меньше
+// минимума лидеров, просмотр таблицы; память не зависит от
+// числа разных сообщений.
+//
+// Писатель один — поток своего реактора; счётчики атомарны
+// (relaxed), а состав лидеров меняется под мьютексом,
+// который берётся только при вытеснении. Отчёт читает из
+// любого потока.
+class HeavyHitters {
+ public:
+  static constexpr std::size_t kDepth = 4;  // Строк скетча
+  static constexpr std::size_t kWidth
+    = 4096;  // Счётчиков в строке (степень двойки)
+  static constexpr std::size_t kSampleBytes
+    = 120;  // Длина примера
+
+  // capacity — число отслеживаемых лидеров
+  explicit HeavyHitters(std::size_t capacity);
+
+  HeavyHitters(const HeavyHitters &) = delete;
+  HeavyHitters &operator=(const HeavyHitters &) = delete;
+
+  // Отпечаток сообщения (FNV-1a нормализованного текста)
+  static std::uint64_t fingerprint(std::string_view line);
+
+  // Учитывает сообщение. Только из потока-владельца
+  void add(std::string_view line);
+
+  // Оценка числа сообщений с отпечатком fingerprint
+  std::uint64_t estimate(std::uint64_t fingerprint) const;
+
+  // Текущие лидеры по убыванию оценки
+  std::vector<HeavyHitter> top() const;
+
+ private:
+  using Counter = std::atomic<std::uint64_t>;
+
+  // Лидер: отпечаток и пример меняются под мьютексом,
+  // оценка — атомарно
+  struct Slot {
+    std::uint64_t fingerprint = 0;  // Отпечаток
+    Counter count{0};  // Оценка
+    std::string sample;  // Пример
+  };
+
+  // Счётчик строки row для отпечатка
+  std::size_t cell(std::size_t row,
+                   std::uint64_t fingerprint) const;
+
+  std::unique_ptr<Counter[]> sketch_;  // kDepth * kWidth
+  std::unique_ptr<Slot[]> slots_;  // Лидеры
+  std::size_t capacity_;  // Размер таблицы лидеров
+  std::size_t used_ = 0;  // Занято в таблице
+  std::uint64_t minCount_ = 0;  // Не больше наименьшей
+                                // оценки лидеров
+  mutable std::mutex mutex_;  // Состав лидеров
+};
+
+// Общие лидеры нескольких шардов: кандидаты всех шардов,
+// оценки которых сложены по шардам, — не больше k по
+// убыванию
+std::vector<HeavyHitter> mergeHeavyHitters(
+  const std::vector<const HeavyHitters *> &shards,
+  std::size_t k);
@@ -0,0 +1,48 @@
+#include "Histogram.h"
+
+#include <cmath>
+
+using namespace std;
+
+uint64_t Histogram::bucketLow(size_t index) {
+  if (index < 2 * kSubBuckets)
+    return index;
+  size_t shift = index / kSubBuckets - 1;
+  return static_cast<uint64_t>(index - shift * kSubBuckets)
+         << shift;
+}
+
+uint64_t Histogram::bucketHigh(size_t index) {
+  if (index + 1 >= kBuckets)
+    return UINT64_MAX;
+  return bucketLow(index + 1) - 1;
+}
+
+void Histogram::merge(const Histogram &other) {
+  for (size_t i = 0; i < kBuckets; ++i)
+    counts_[i] += other.counts_[i];
+  total_ += other.total_;
+}
+
+// Номер значения по порядку округляется к ближайшему,
+// как в HdrHistogram (ceil спотыкается о погрешность
+// 99.9 / 100); ищется корзина, где накопленная сумма его
+// достигает
+uint64_t Histogram::percentile(double percent) const {
+  if (total_ == 0)
+    return 0;
+  auto rank = static_cast<uint64_t>(
+    floor(percent / 100.0 * static_cast<double>(total_)
+          + 0.5));
+  if (rank < 1)
+    rank = 1;  // p0 — наименьшее значение
+  if (rank > total_)
+    rank = total_;
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBuckets; ++i) {
+    seen += counts_[i];
+    if (seen >= rank)
+      return bucketHigh(i);
+  }
+  return bucketHigh(kBuckets - 1);
+}
@@ -0,0 +1,72 @@
+#pragma once  // Защита от повторного включения
+              // заголовочного файла
+
+#include <array>  // Для счётчиков корзин
+#include <cstddef>  // Для std::size_t
+#include <cstdint>  // Для std::uint64_t
+
+// Лог-линейная гистограмма (как HdrHistogram) значений
+// uint64: каждая степень двойки делится на kSubBuckets
+// равных корзин, поэтому значения до 2 * kSubBuckets
+// считаются точно, а остальные — с относительной
+// погрешностью не больше 1 / kSubBuckets (~3%). Память
+// фиксирована (kBuckets счётчиков), запись — сдвиг и
+// инкремент, а гистограммы шардов сливаются сложением
+// счётчиков без потери точности.
+class Histogram {
+ public:
+  // Корзин на степень двойки: 2^kSubBits
+  static constexpr unsigned kSubBits = 5;
+  static constexpr std::size_t kSubBuckets = std::size_t{1}
+                                             << kSubBits;
+
+  // Всего корзин: точный отрезок [0, 2 * kSubBuckets) и по
+  // kSubBuckets на каждую следующую степень до 2^64
+  static constexpr std::size_t kBuckets
+    = (64 - kSubBits + 1) * kSubBuckets;
+
+  // Номер корзины значения
+  static std::size_t bucketOf(std::uint64_t value) {
+    if (value < 2 * kSubBuckets)
+      return static_cast<std::size_t>(value);
+    auto shift = static_cast<unsigned>(
+      63 - __builtin_clzll(value) - kSubBits);
+    return shift * kSubBuckets
+           + static_cast<std::size_t>(value >> shift);
+  }
+
+  // Наименьшее и наибольшее значения корзины
+  static std::uint64_t bucketLow(std::size_t index);
+  static std::uint64_t bucketHigh(std::size_t index);
+
+  // Учитывает count значений value
+  void record(std::uint64_t value,
+              std::uint64_t count = 1) {
+    counts_[bucketOf(value)] += count;
+    total_ += count;
+  }
+
+  // Добавляет count значений в корзину index (снимок
+  // счётчиков шарда)
+  void recordBucket(std::size_t index,
+                    std::uint64_t count) {
+    counts_[index] += count;
+    total_ += count;
+  }
+
+  // Добавляет значения другой гистограммы
+  void merge(const Histogram &other);
+
+  // Всего значений
+  std::uint64_t count() const { return total_; }
+
+  // Значение, не больше которого percent процентов
+  // значений (верхняя граница его корзины, как в
+  // HdrHistogram); 0, если значений нет
+  std::uint64_t percentile(double percent) const;
+
+ private:
+  std::array<std::uint64_t, kBuckets>
+    counts_{};  // Значений по корзинам
+  std::uint64_t total_ = 0;  // Всего значений
+};
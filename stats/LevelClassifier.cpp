@@ -0,0 +1,163 @@
+#include "LevelClassifier.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+using namespace std;
+
+namespace {
+
+// Ключевое слово уровня (заглавными)
+struct Keyword {
+  string_view word;  // Слово
+  StatsLevel level;  // Уровень
+};
+
+// Имена поля уровня: совпадение целиком
+constexpr Keyword kNames[] = {
+  {"ERROR", StatsLevel::Error},
+  {"ERR", StatsLevel::Error},
+  {"FATAL", StatsLevel::Error},
+  {"WARNING", StatsLevel::Warning},
+  {"WARN", StatsLevel::Warning},
+  {"WRN", StatsLevel::Warning},
+  {"INFO", StatsLevel::Info},
+  {"INFORMATION", StatsLevel::Info},
+  {"DEBUG", StatsLevel::Debug},
+  {"DBG", StatsLevel::Debug},
+  {"TRACE", StatsLevel::Debug}};
+
+// Подстроки для просмотра всей строки. Более длинные имена
+// (ERROR, WARNING, INFORMATION) начинаются с этих и
+// отдельно не ищутся
+constexpr Keyword kPatterns[] = {
+  {"ERR", StatsLevel::Error},
+  {"FATAL", StatsLevel::Error},
+  {"WARN", StatsLevel::Warning},
+  {"WRN", StatsLevel::Warning},
+  {"INFO", StatsLevel::Info},
+  {"DEBUG", StatsLevel::Debug},
+  {"DBG", StatsLevel::Debug},
+  {"TRACE", StatsLevel::Debug}};
+
+constexpr size_t kShortestPattern = 3;
+
+constexpr char toUpper(char c) {
+  return c >= 'a' && c <= 'z'
+           ? static_cast<char>(c - 'a' + 'A')
+           : c;
+}
+
+// Для каждого байта — маска подстрок, начинающихся с него
+// (в любом регистре); для остальных байтов 0, и проход
+// по строке на них не задерживается
+constexpr array<uint8_t, 256> firstByteTable() {
+  array<uint8_t, 256> table{};
+  for (size_t p = 0; p < size(kPatterns); ++p) {
+    char first = kPatterns[p].word[0];
+    auto bit = static_cast<uint8_t>(1u << p);
+    table[static_cast<unsigned char>(first)] |= bit;
+    table[static_cast<unsigned char>(first - 'A' + 'a')]
+      |= bit;
+  }
+  return table;
+}
+
+constexpr array<uint8_t, 256> kFirstByte = firstByteTable();
+
+// Текст (любой регистр) совпадает со словом (заглавные)
+bool equalsUpper(const char *text, string_view word) {
+  for (size_t i = 0; i < word.size(); ++i) {
+    if (toUpper(text[i]) != word[i])
+      return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+StatsLevel levelFromName(string_view name) {
+  for (const Keyword &keyword : kNames) {
+    if (name.size() == keyword.word.size()
+        && equalsUpper(name.data(), keyword.word))
+      return keyword.level;
+  }
+  return StatsLevel::Unknown;
+}
+
+// Уровни упорядочены по приоритету (Error = 0), поэтому
+// лучший найденный — минимальный; ERROR завершает проход
+StatsLevel scanLevel(string_view line) {
+  StatsLevel best = StatsLevel::Unknown;
+  const char *data = line.data();
+  size_t size = line.size();
+  for (size_t i = 0; i + kShortestPattern <= size; ++i) {
+    unsigned mask = kFirstByte[static_cast<unsigned char>(
+      data[i])];
+    for (size_t p = 0; mask != 0; ++p, mask >>= 1) {
+      const Keyword &pattern = kPatterns[p];
+      if (!(mask & 1u) || pattern.level >= best
+          || size - i < pattern.word.size()
+          || !equalsUpper(data + i, pattern.word))
+        continue;
+      best = pattern.level;
+      if (best == StatsLevel::Error)
+        return best;
+    }
+  }
+  return best;
+}
+
+StatsLevel classifyLevel(string_view line) {
+  string_view message;
+  return classifyMessage(line, message);
+}
+
+StatsLevel classifyMessage(string_view line,
+                           string_view &message) {
+  message = line;
+  string_view rest = line;
+
+  // Номер записи "#123 " (LoggerOptions::sequenceNumbers)
+  if (!rest.empty() && rest[0] == '#') {
+    size_t space = rest.find(' ');
+    if (space != string_view::npos)
+      rest.remove_prefix(space + 1);
+  }
+
+  // Текст после поля уровня, закрытого в end
+  auto after = [&rest, &message](size_t end) {
+    message = rest.substr(end + 1);
+    if (!message.empty() && message[0] == ' ')
+      message.remove_prefix(1);
+  };
+
+  if (!rest.empty() && rest[0] == '[') {
+    size_t close = rest.find(']');
+    if (close != string_view::npos) {
+      // "[УРОВЕНЬ] сообщение"
+      StatsLevel level
+        = levelFromName(rest.substr(1, close - 1));
+      if (level != StatsLevel::Unknown) {
+        after(close);
+        return level;
+      }
+
+      // "[время] [УРОВЕНЬ] сообщение"
+      if (rest.substr(close + 1, 2) == " [") {
+        size_t start = close + 3;
+        size_t end = rest.find(']', start);
+        if (end != string_view::npos) {
+          level = levelFromName(
+            rest.substr(start, end - start));
+          if (level != StatsLevel::Unknown) {
+            after(end);
+            return level;
+          }
+        }
+      }
+    }
+  }
+  return scanLevel(line);
+}
@@ -0,0 +1,33 @@
+#pragma once  // Защита от повторного включения
+              // заголовочного файла
+
+#include <string_view>  // Для строк без копирования
+
+#include "Stats.h"  // Уровни статистики
+
+// Определение уровня текстовой строки лога без выделения
+// памяти и за один проход.
+//
+// Строки Logger и SocketLogger имеют вид
+// "[#номер ][время] [УРОВЕНЬ] сообщение", поэтому сначала
+// проверяется поле уровня во вторых скобках (или в первых —
+// "[УРОВЕНЬ] сообщение"), и слово "error" в тексте
+// сообщения уровень не меняет. Только если поля уровня нет,
+// строка просматривается целиком: ключевые слова ищутся без
+// учёта регистра одним проходом с выбором кандидатов по
+// первой букве, приоритет — ERROR, WARNING, INFO, DEBUG.
+StatsLevel classifyLevel(std::string_view line);
+
+// Как classifyLevel, а в message — текст сообщения после
+// поля уровня (без "[#номер ][время] [УРОВЕНЬ] "); без
+// поля уровня — вся строка
+StatsLevel classifyMessage(std::string_view line,
+                           std::string_view &message);
+
+// Уровень по имени поля (без скобок, без учёта регистра):
+// ERROR/ERR/FATAL, WARNING/WARN/WRN, INFO/INFORMATION,
+// DEBUG/DBG/TRACE; иначе Unknown
+StatsLevel levelFromName(std::string_view name);
+
+// Поиск ключевых слов уровня по всей строке
+StatsLevel scanLevel(std::string_view line);
@@ -0,0 +1,70 @@
+#include "LineReader.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+// Больше kMaxLine буфер не бывает: иначе строка без '\n'
+// заполнила бы его целиком, не дойдя до выдачи частями,
+// и места для recv не осталось бы
+LineReader::LineReader(size_t capacity)
+    : capacity_(clamp<size_t>(capacity, 1, kMaxLine)) {}
+
+char *LineReader::space(size_t &len) {
+  if (buffer_.empty())
+    buffer_.resize(capacity_);
+  if (end_ == buffer_.size()) {
+    if (begin_ > 0) {
+      // Неполная строка дошла до конца — сдвигаем её
+      memmove(buffer_.data(), buffer_.data() + begin_,
+              end_ - begin_);
+      scan_ -= begin_;
+      end_ -= begin_;
+      begin_ = 0;
+    } else if (buffer_.size() < kMaxLine) {
+      // Строка длиннее буфера
+      buffer_.resize(min(buffer_.size() * 2, kMaxLine));
+    }
+  }
+  len = buffer_.size() - end_;
+  return buffer_.data() + end_;
+}
+
+bool LineReader::next(string_view &line) {
+  const char *data = buffer_.data();
+  const void *found
+    = scan_ < end_
+        ? memchr(data + scan_, '\n', end_ - scan_)
+        : nullptr;
+  if (found == nullptr) {
+    scan_ = end_;
+    // Строка без '\n' во весь буфер, которому некуда
+    // расти, отдаётся как есть
+    if (begin_ == 0 && end_ == buffer_.size()
+        && buffer_.size() >= kMaxLine) {
+      line = string_view(data, end_);
+      clear();
+      return true;
+    }
+    return false;
+  }
+
+  auto pos = static_cast<size_t>(
+    static_cast<const char *>(found) - data);
+  line = string_view(data + begin_, pos - begin_);
+  begin_ = scan_ = pos + 1;
+  if (begin_ == end_)
+    clear();  // Всё разобрано — пишем снова с начала
+  return true;
+}
+
+vector<char> LineReader::release() {
+  clear();
+  return move(buffer_);
+}
+
+void LineReader::adopt(vector<char> &&buffer) {
+  buffer_ = move(buffer);
+  clear();
+}
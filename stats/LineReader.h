@@ -0,0 +1,69 @@
+#pragma once  // Защита от повторного включения
+              // заголовочного файла
+
+#include <cstddef>  // Для std::size_t
+#include <string_view>  // Для строк без копирования
+#include <vector>  // Для буфера
+
+// Разбор потока на строки без копирования. recv пишет
+// прямо в свободное место буфера (space/commit), next()
+// находит '\n' через memchr и отдаёт строку как
+// string_view внутрь буфера. Строки не переносятся:
+// неполная строка сдвигается в начало только когда
+// упирается в конец буфера, а если она занимает весь
+// буфер — он удваивается (до kMaxLine). Буфер можно
+// отдать (release) и вернуть (adopt), чтобы простаивающие
+// соединения не держали память.
+class LineReader {
+ public:
+  // Размер буфера по умолчанию
+  static constexpr std::size_t kDefaultCapacity = 64 * 1024;
+
+  // Предел длины строки: более длинная отдаётся частями
+  static constexpr std::size_t kMaxLine = 16 * 1024 * 1024;
+
+  // capacity приводится к [1, kMaxLine]
+  explicit LineReader(
+    std::size_t capacity = kDefaultCapacity);
+
+  // Свободное место для записи (не пустое); len — его
+  // размер. Может сдвинуть или увеличить буфер, строки,
+  // выданные next(), после этого недействительны
+  char *space(std::size_t &len);
+
+  // Отмечает n байт, записанных в space()
+  void commit(std::size_t n) { end_ += n; }
+
+  // Следующая целая строка без '\n'; false — целых строк
+  // нет. Строка действительна до вызова space()
+  bool next(std::string_view &line);
+
+  // Необработанные байты (неполная строка)
+  std::string_view pending() const {
+    return std::string_view(buffer_.data() + begin_,
+                            end_ - begin_);
+  }
+
+  // Отбрасывает необработанные байты
+  void clear() { begin_ = scan_ = end_ = 0; }
+
+  // Необработанных байт нет
+  bool empty() const { return begin_ == end_; }
+
+  // Забирает буфер (reader должен быть пуст)
+  std::vector<char> release();
+
+  // Отдаёт reader буфер (например, из пула); пустой
+  // вектор — выделить при первом space()
+  void adopt(std::vector<char> &&buffer);
+
+  // Есть ли у reader выделенный буфер
+  bool hasBuffer() const { return !buffer_.empty(); }
+
+ private:
+  std::size_t capacity_;  // Размер нового буфера
+  std::vector<char> buffer_;  // Буфер
+  std::size_t begin_ = 0;  // Начало неполной строки
+  std::size_t scan_ = 0;  // До сюда '\n' уже искали
+  std::size_t end_ = 0;  // Конец принятых данных
+};
@@ -0,0 +1,80 @@
+#include "Listener.h"
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <iostream>
+
+using namespace std;
+
+// Очередь ещё не принятых соединений: при тысячах
+// подключающихся клиентов 10 мест не хватает
+constexpr int kBacklog = 1024;
+
+int openListener(const logger::Endpoint &endpoint,
+                 bool reusePort) {
+  sockaddr_storage address{};
+  socklen_t addrlen = 0;
+  if (!logger::toSockaddr(endpoint, address, addrlen)) {
+    cerr << "Bad address: " << logger::toString(endpoint)
+         << "\n";
+    return -1;
+  }
+
+  int fd = logger::openSocket(endpoint);
+  if (fd == -1) {
+    perror("socket");
+    return -1;
+  }
+
+  if (endpoint.isInet()) {
+    // Позволяем переиспользовать адрес, чтобы избежать
+    // ошибки "Address already in use"
+    int opt = 1;
+    bool failed = setsockopt(fd, SOL_SOCKET, SO_REUSEADDR,
+                             &opt, sizeof(opt))
+                  < 0;
+    if (!failed && reusePort)
+      failed = setsockopt(fd, SOL_SOCKET, SO_REUSEPORT,
+                          &opt, sizeof(opt))
+               < 0;
+    if (failed) {
+      perror("setsockopt");
+      close(fd);
+      return -1;
+    }
+  } else {
+    unlink(endpoint.path.c_str());  // Файл прошлого запуска
+  }
+
+  if (::bind(fd, reinterpret_cast<sockaddr *>(&address),
+             addrlen)
+      < 0) {
+    perror("bind");
+    close(fd);
+    return -1;
+  }
+
+  if (endpoint.isStream() && listen(fd, kBacklog) < 0) {
+    perror("listen");
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+int boundPort(int fd) {
+  sockaddr_in address{};
+  socklen_t addrlen = sizeof(address);
+  auto *raw = reinterpret_cast<sockaddr *>(&address);
+  if (getsockname(fd, raw, &addrlen) < 0)
+    return -1;
+  return ntohs(address.sin_port);
+}
+
+void removeListener(const logger::Endpoint &endpoint) {
+  if (!endpoint.isInet())
+    unlink(endpoint.path.c_str());
+}
@@ -0,0 +1,19 @@
+#pragma once  // Защита от повторного включения
+              // заголовочного файла
+
+#include "logger/Endpoint.h"  // Адрес и транспорт
+
+// Открывает неблокирующий слушающий сокет: bind и, для
+// потоковых транспортов, listen. Файл сокета AF_UNIX от
+// прошлого запуска удаляется. reusePort (только TCP/UDP)
+// включает SO_REUSEPORT: несколько сокетов на одном порту,
+// ядро распределяет между ними соединения и датаграммы.
+// -1 при ошибке (причина выводится в stderr)
+int openListener(const logger::Endpoint &endpoint,
+                 bool reusePort = false);
+
+// Порт, к которому привязан сокет TCP/UDP (для порта 0)
+int boundPort(int fd);
+
+// Удаляет файл сокета AF_UNIX после закрытия слушателя
+void removeListener(const logger::Endpoint &endpoint);
@@ -0,0 +1,489 @@
+#include "LogIndex.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <iterator>
+#include <unordered_map>
+
+#include "LevelClassifier.h"
+
+using namespace std;
+
+namespace {
+
+// Предел limit= в запросе
+constexpr int64_t kMaxLimit = 10000;
+
+inline unsigned char byteAt(string_view text, size_t i) {
+  return static_cast<unsigned char>(text[i]);
+}
+
+// Буква, цифра, '_' или байт UTF-8 — часть слова
+inline bool isWordChar(unsigned char c) {
+  return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z')
+         || (c >= 'A' && c <= 'Z') || c == '_' || c >= 0x80;
+}
+
+inline unsigned char lower(unsigned char c) {
+  return c >= 'A' && c <= 'Z'
+           ? static_cast<unsigned char>(c - 'A' + 'a')
+           : c;
+}
+
+// Вызывает visit для каждого слова текста
+template <typename Visit>
+void forEachWord(string_view text, Visit visit) {
+  size_t i = 0;
+  while (i < text.size()) {
+    while (i < text.size() && !isWordChar(byteAt(text, i)))
+      ++i;
+    size_t start = i;
+    while (i < text.size() && isWordChar(byteAt(text, i)))
+      ++i;
+    if (i > start)
+      visit(text.substr(start, i - start));
+  }
+}
+
+// FNV-1a слова в нижнем регистре
+uint64_t termHash(string_view word) {
+  uint64_t hash = 14695981039346656037ull;
+  for (size_t i = 0; i < word.size(); ++i)
+    hash = (hash ^ lower(byteAt(word, i)))
+           * 1099511628211ull;
+  return hash;
+}
+
+// Слово текста равно слову запроса (уже в нижнем
+// регистре) без учёта регистра
+bool sameWord(string_view word, string_view term) {
+  if (word.size() != term.size())
+    return false;
+  for (size_t i = 0; i < word.size(); ++i) {
+    if (lower(byteAt(word, i)) != byteAt(term, i))
+      return false;
+  }
+  return true;
+}
+
+// В тексте есть все слова группы
+bool containsAll(string_view text,
+                 const vector<string> &terms) {
+  for (const string &term : terms) {
+    bool found = false;
+    forEachWord(text, [&](string_view word) {
+      found = found || sameWord(word, term);
+    });
+    if (!found)
+      return false;
+  }
+  return true;
+}
+
+void appendVarint(vector<uint8_t> &out, uint32_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<uint8_t>(value));
+}
+
+// Список номеров из разностей varint
+void decodePostings(const vector<uint8_t> &bytes,
+                    vector<uint32_t> &out) {
+  out.clear();
+  uint32_t id = 0;
+  uint32_t value = 0;
+  unsigned shift = 0;
+  for (uint8_t byte : bytes) {
+    value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+    if (byte & 0x80) {
+      shift += 7;
+      continue;
+    }
+    id += value;
+    out.push_back(id);
+    value = 0;
+    shift = 0;
+  }
+}
+
+// Неотрицательное десятичное число на всё значение
+bool parseNumber(string_view text, int64_t &out) {
+  string value(text);
+  if (value.empty() || value[0] < '0' || value[0] > '9')
+    return false;
+  errno = 0;
+  char *end = nullptr;
+  long long number = strtoll(value.c_str(), &end, 10);
+  if (errno != 0 || *end != '\0')
+    return false;
+  out = static_cast<int64_t>(number);
+  return true;
+}
+
+}  // namespace
+
+// Сегмент индекса: тексты сообщений подряд в одной
+// строке, их время и уровни и списки номеров (внутри
+// сегмента) по хешам слов. Пополняется только до
+// публикации, потом неизменяем
+class IndexSegment {
+ public:
+  explicit IndexSegment(uint64_t firstId)
+      : firstId_(firstId) {}
+
+  uint64_t firstId() const { return firstId_; }
+  size_t size() const { return entries_.size(); }
+  uint64_t bytes() const { return bytes_; }
+
+  void add(time_t timestamp, StatsLevel level,
+           string_view message) {
+    auto local = static_cast<uint32_t>(entries_.size());
+    entries_.push_back(
+      {text_.size(), message.size(), timestamp, level});
+    text_.append(message);
+    minTime_ = min(minTime_, timestamp);
+    maxTime_ = max(maxTime_, timestamp);
+    forEachWord(message, [&](string_view word) {
+      Posting &posting = postings_[termHash(word)];
+      if (posting.any && posting.last == local)
+        return;  // Слово уже было в этом сообщении
+      appendVarint(posting.ids, local - posting.last);
+      posting.last = local;
+      posting.any = true;
+    });
+  }
+
+  // Дописывает все сообщения в другой сегмент (слияние)
+  void appendTo(IndexSegment &other) const {
+    for (const Entry &entry : entries_)
+      other.add(entry.timestamp, entry.level, text(entry));
+  }
+
+  // Перед публикацией: лишняя ёмкость освобождается, а
+  // размер запоминается для отчёта
+  void seal() {
+    text_.shrink_to_fit();
+    entries_.shrink_to_fit();
+    bytes_ = text_.capacity()
+             + entries_.capacity() * sizeof(Entry);
+    for (auto &term : postings_) {
+      term.second.ids.shrink_to_fit();
+      bytes_ += term.second.ids.capacity()
+                + sizeof(term) + 2 * sizeof(void *);
+    }
+  }
+
+  // Дописывает в hits подходящие сообщения от новых к
+  // старым, пока их меньше query.limit
+  void search(const IndexQuery &query,
+              vector<IndexHit> &hits) const {
+    if (entries_.empty() || maxTime_ < query.from
+        || minTime_ > query.to)
+      return;
+
+    bool all = query.any.empty();
+    vector<uint32_t> candidates;
+    if (!all) {
+      vector<uint32_t> group, list, merged;
+      for (const vector<string> &terms : query.any) {
+        group.clear();
+        for (size_t t = 0; t < terms.size(); ++t) {
+          auto found = postings_.find(termHash(terms[t]));
+          if (found == postings_.end()) {
+            group.clear();
+            break;
+          }
+          decodePostings(found->second.ids, list);
+          if (t == 0) {
+            group.swap(list);
+          } else {
+            merged.clear();
+            set_intersection(group.begin(), group.end(),
+                             list.begin(), list.end(),
+                             back_inserter(merged));
+            group.swap(merged);
+          }
+          if (group.empty())
+            break;
+        }
+        merged.clear();
+        set_union(candidates.begin(), candidates.end(),
+                  group.begin(), group.end(),
+                  back_inserter(merged));
+        candidates.swap(merged);
+      }
+    }
+
+    size_t count
+      = all ? entries_.size() : candidates.size();
+    for (size_t k = count;
+         k-- > 0 && hits.size() < query.limit;) {
+      uint32_t local
+        = all ? static_cast<uint32_t>(k) : candidates[k];
+      const Entry &entry = entries_[local];
+      // Перепроверка и по тексту: хеши слов могли совпасть
+      string_view message = text(entry);
+      if (!matchesQuery(query, entry.timestamp, entry.level,
+                        message))
+        continue;
+      hits.push_back({firstId_ + local, entry.timestamp,
+                      entry.level, string(message)});
+    }
+  }
+
+ private:
+  // Сообщение сегмента
+  struct Entry {
+    size_t offset;  // Начало текста в text_
+    size_t length;  // Длина текста
+    time_t timestamp;  // Время записи
+    StatsLevel level;  // Уровень
+  };
+
+  // Список номеров сообщений одного слова
+  struct Posting {
+    vector<uint8_t> ids;  // Разности номеров (varint)
+    uint32_t last = 0;  // Последний номер
+    bool any = false;  // Список не пуст
+  };
+
+  string_view text(const Entry &entry) const {
+    return string_view(text_).substr(entry.offset,
+                                     entry.length);
+  }
+
+  uint64_t firstId_;  // Номер первого сообщения
+  string text_;  // Тексты подряд
+  vector<Entry> entries_;  // Сообщения
+  unordered_map<uint64_t, Posting>
+    postings_;  // Списки по хешу слова
+  time_t minTime_
+    = numeric_limits<time_t>::max();  // Самое раннее
+  time_t maxTime_
+    = numeric_limits<time_t>::min();  // Самое позднее
+  uint64_t bytes_ = 0;  // Размер после seal()
+};
+
+bool parseIndexQuery(string_view text, time_t now,
+                     IndexQuery &out, string &error) {
+  IndexQuery query;
+  query.any.emplace_back();
+  size_t pos = 0;
+  while (pos < text.size()) {
+    size_t end = text.find_first_of(" \t\r\n", pos);
+    if (end == string_view::npos)
+      end = text.size();
+    string_view word = text.substr(pos, end - pos);
+    pos = end + 1;
+    if (word.empty() || word == "AND")
+      continue;
+    if (word == "OR") {
+      if (query.any.back().empty()) {
+        error = "empty OR branch";
+        return false;
+      }
+      query.any.emplace_back();
+      continue;
+    }
+
+    size_t eq = word.find('=');
+    string_view key = word.substr(0, eq);
+    string_view value = eq == string_view::npos
+                          ? string_view()
+                          : word.substr(eq + 1);
+    int64_t number = 0;
+    if (key == "level" && eq != string_view::npos) {
+      query.levels = 0;
+      size_t start = 0;
+      while (start <= value.size()) {
+        size_t comma = value.find(',', start);
+        if (comma == string_view::npos)
+          comma = value.size();
+        string_view name
+          = value.substr(start, comma - start);
+        start = comma + 1;
+        StatsLevel level = levelFromName(name);
+        if (level == StatsLevel::Unknown
+            && !sameWord(name, "unknown")) {
+          error = "unknown level: " + string(name);
+          return false;
+        }
+        query.levels |= 1u << static_cast<unsigned>(level);
+      }
+    } else if (key == "source" && eq != string_view::npos) {
+      if (value == "index") {
+        query.source = QuerySource::Index;
+      } else if (value == "store") {
+        query.source = QuerySource::Store;
+      } else {
+        error = "unknown source: " + string(value);
+        return false;
+      }
+    } else if (key == "from" || key == "to" || key == "last"
+               || key == "limit") {
+      if (!parseNumber(value, number)) {
+        error = "invalid " + string(key) + ": "
+                + string(value);
+        return false;
+      }
+      if (key == "from") {
+        query.from = static_cast<time_t>(number);
+      } else if (key == "to") {
+        query.to = static_cast<time_t>(number);
+      } else if (key == "last") {
+        query.from = now - static_cast<time_t>(number);
+      } else if (number < 1 || number > kMaxLimit) {
+        error = "limit must be 1.."
+                + to_string(kMaxLimit);
+        return false;
+      } else {
+        query.limit = static_cast<size_t>(number);
+      }
+    } else {
+      // Обычные слова; "user=bob" — два слова
+      forEachWord(word, [&](string_view term) {
+        string lowered(term);
+        for (char &c : lowered)
+          c = static_cast<char>(
+            lower(static_cast<unsigned char>(c)));
+        query.any.back().push_back(move(lowered));
+      });
+    }
+  }
+  if (query.any.back().empty()) {
+    if (query.any.size() > 1) {
+      error = "empty OR branch";
+      return false;
+    }
+    query.any.clear();  // Только фильтры
+  }
+  out = move(query);
+  return true;
+}
+
+LogIndex::LogIndex(size_t maxEntries)
+    : maxEntries_(max<size_t>(maxEntries, 1)),
+      active_(make_unique<IndexSegment>(0)),
+      lastPublish_(chrono::steady_clock::now()),
+      published_(make_shared<const Segments>()) {}
+
+LogIndex::~LogIndex() = default;
+
+void LogIndex::add(time_t timestamp, StatsLevel level,
+                   string_view message) {
+  active_->add(timestamp, level, message);
+  ++nextId_;
+  if (active_->size() >= kSegmentEntries)
+    publish();
+}
+
+void LogIndex::publishIfDue() {
+  if (active_->size() > 0
+      && chrono::steady_clock::now() - lastPublish_
+           >= kPublishInterval)
+    publish();
+}
+
+// Маленький сегмент сливается с предыдущим, пока тот не
+// больше чем вдвое крупнее (как уровни LSM-дерева): при
+// редких сообщениях сегменты не мельчают, а каждое
+// сообщение копируется O(log) раз
+void LogIndex::publish() {
+  lastPublish_ = chrono::steady_clock::now();
+  if (active_->size() == 0)
+    return;
+  unique_ptr<IndexSegment> segment = move(active_);
+  active_ = make_unique<IndexSegment>(nextId_);
+  while (!sealed_.empty()) {
+    const IndexSegment &last = *sealed_.back();
+    if (last.size() > 2 * segment->size()
+        || last.size() + segment->size() > kSegmentEntries)
+      break;
+    auto merged = make_unique<IndexSegment>(last.firstId());
+    last.appendTo(*merged);
+    segment->appendTo(*merged);
+    sealedEntries_ -= last.size();
+    sealed_.pop_back();
+    segment = move(merged);
+  }
+  segment->seal();
+  sealedEntries_ += segment->size();
+  sealed_.push_back(move(segment));
+
+  // Старые сегменты сверх предела отбрасываются; запросы,
+  // которые их ещё держат, дочитают их
+  while (sealed_.size() > 1
+         && sealedEntries_ - sealed_.front()->size()
+              >= maxEntries_) {
+    sealedEntries_ -= sealed_.front()->size();
+    sealed_.erase(sealed_.begin());
+  }
+  atomic_store(&published_,
+               make_shared<const Segments>(sealed_));
+}
+
+vector<IndexHit> LogIndex::search(
+  const IndexQuery &query) const {
+  shared_ptr<const Segments> snapshot
+    = atomic_load(&published_);
+  vector<IndexHit> hits;
+  for (auto it = snapshot->rbegin();
+       it != snapshot->rend() && hits.size() < query.limit;
+       ++it)
+    (*it)->search(query, hits);
+  reverse(hits.begin(), hits.end());
+  return hits;
+}
+
+LogIndexUsage LogIndex::usage() const {
+  shared_ptr<const Segments> snapshot
+    = atomic_load(&published_);
+  LogIndexUsage result;
+  result.segments = snapshot->size();
+  for (const auto &segment : *snapshot) {
+    result.entries += segment->size();
+    result.bytes += segment->bytes();
+  }
+  return result;
+}
+
+bool matchesQuery(const IndexQuery &query,
+                  time_t timestamp, StatsLevel level,
+                  string_view message) {
+  auto bit = static_cast<unsigned>(level);
+  if (((query.levels >> bit) & 1) == 0
+      || timestamp < query.from || timestamp > query.to)
+    return false;
+  auto matches = [message](const vector<string> &terms) {
+    return containsAll(message, terms);
+  };
+  return query.any.empty()
+         || any_of(query.any.begin(), query.any.end(),
+                   matches);
+}
+
+void keepNewestHits(vector<IndexHit> &hits, size_t limit) {
+  stable_sort(hits.begin(), hits.end(),
+              [](const IndexHit &a, const IndexHit &b) {
+                return a.timestamp < b.timestamp;
+              });
+  if (hits.size() > limit)
+    hits.erase(hits.begin(),
+               hits.end() - static_cast<ptrdiff_t>(limit));
+}
+
+vector<IndexHit> searchIndexes(
+  const vector<const LogIndex *> &indexes,
+  const IndexQuery &query) {
+  vector<IndexHit> hits;
+  for (const LogIndex *index : indexes) {
+    vector<IndexHit> found = index->search(query);
+    move(found.begin(), found.end(), back_inserter(hits));
+  }
+  keepNewestHits(hits, query.limit);
+  return hits;
+}
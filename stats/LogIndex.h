@@ -0,0 +1,151 @@
+#pragma once  // Защита от повторного включения
+              // заголовочного файла
+
+#include <chrono>  // Для интервала публикации
+#include <cstddef>  // Для std::size_t
+#include <cstdint>  // Для целых фиксированной ширины
+#include <ctime>  // Для time_t
+#include <limits>  // Для границ времени
+#include <memory>  // Для сегментов и снимков
+#include <string>  // Для сообщений и слов запроса
+#include <string_view>  // Для сообщений без копирования
+#include <vector>  // Для сегментов и результатов
+
+#include "Stats.h"  // Уровни статистики
+
+// Найденное сообщение
+struct IndexHit {
+  std::uint64_t id = 0;  // Номер сообщения в индексе (0 —
+                         // найдено в хранилище)
+  time_t timestamp = 0;  // Время записи
+  StatsLevel level = StatsLevel::Unknown;  // Уровень
+  std::string message;  // Текст
+};
+
+// Где искать: в индексе последних сообщений или во всей
+// истории хранилища (кольцо и сегменты на диске)
+enum class QuerySource { Index, Store };
+
+// Запрос к индексу: группы слов через ИЛИ, слова группы —
+// через И; слова сравниваются без учёта регистра
+struct IndexQuery {
+  std::vector<std::vector<std::string>>
+    any;  // Группы слов; пусто — все сообщения
+  std::uint32_t levels = ~0u;  // Маска уровней (бит
+                               // StatsLevel)
+  time_t from = 0;  // Не раньше
+  time_t to
+    = std::numeric_limits<time_t>::max();  // Не позже
+  std::size_t limit = 100;  // Не больше стольких (самые
+                            // новые)
+  QuerySource source = QuerySource::Index;  // Где искать
+};
+
+// Разбирает строку запроса:
+//   timeout db OR refused level=error,warning last=3600
+// Слова до OR — группа (AND можно писать, он
+// подразумевается), level= — уровни через запятую,
+// from= / to= — время в секундах Unix, last= — последние
+// столько секунд от now, limit= — число результатов,
+// source=index|store — где искать. false и причина в
+// error при ошибке
+bool parseIndexQuery(std::string_view text, time_t now,
+                     IndexQuery &out, std::string &error);
+
+// Занятое индексом место (опубликованные сегменты)
+struct LogIndexUsage {
+  std::size_t entries = 0;  // Сообщений
+  std::size_t segments = 0;  // Сегментов
+  std::uint64_t bytes = 0;  // Примерно байт памяти
+};
+
+class IndexSegment;
+
+// Инвертированный индекс последних принятых сообщений в
+// памяти. Сообщение делится на слова (буквы, цифры, '_'),
+// и номер сообщения дописывается в список каждого слова
+// разностью с предыдущим номером (varint), поэтому списки
+// компактны. Слова хранятся по 64-битному хешу, без
+// копирования строк; найденные сообщения перепроверяются
+// по тексту, так что коллизия хешей не даёт лишних
+// результатов.
+//
+// Писатель — поток своего реактора — пополняет активный
+// сегмент и публикует его (замораживает), когда в нём
+// kSegmentEntries сообщений или прошло kPublishInterval.
+// Соседние маленькие сегменты при публикации сливаются,
+// а самые старые отбрасываются сверх maxEntries
+// сообщений. Запрос берёт снимок списка опубликованных
+// (неизменяемых) сегментов и ищет по нему без
+// блокировок: приём не ждёт запросов, а сегменты живут,
+// пока их держит хоть один снимок. Новые сообщения
+// видны запросам с задержкой до kPublishInterval.
+class LogIndex {
+ public:
+  // Сообщений в сегменте, после которого он публикуется
+  static constexpr std::size_t kSegmentEntries = 4096;
+
+  // Наибольшая задержка публикации
+  static constexpr std::chrono::milliseconds
+    kPublishInterval{100};
+
+  explicit LogIndex(std::size_t maxEntries);
+  ~LogIndex();
+
+  LogIndex(const LogIndex &) = delete;
+  LogIndex &operator=(const LogIndex &) = delete;
+
+  // Добавляет сообщение. Только из потока-владельца
+  void add(time_t timestamp, StatsLevel level,
+           std::string_view message);
+
+  // Публикует активный сегмент, если прошло
+  // kPublishInterval. Только из потока-владельца
+  void publishIfDue();
+
+  // Публикует активный сегмент сразу. Только из
+  // потока-владельца
+  void publish();
+
+  // Сообщения, подходящие под запрос, — не больше
+  // query.limit самых новых, по возрастанию номера. Из
+  // любого потока
+  std::vector<IndexHit> search(
+    const IndexQuery &query) const;
+
+  // Занятое место. Из любого потока
+  LogIndexUsage usage() const;
+
+ private:
+  using Segments
+    = std::vector<std::shared_ptr<const IndexSegment>>;
+
+  std::size_t maxEntries_;  // Предел сообщений
+  std::unique_ptr<IndexSegment> active_;  // Пополняемый
+  Segments sealed_;  // Опубликованные (копия писателя)
+  std::size_t sealedEntries_ = 0;  // Сообщений в них
+  std::uint64_t nextId_ = 0;  // Номер следующего
+  std::chrono::steady_clock::time_point
+    lastPublish_;  // Время последней публикации
+  std::shared_ptr<const Segments>
+    published_;  // Снимок для запросов (atomic_load)
+};
+
+// Подходит ли сообщение под слова, уровни и время
+// запроса (без индекса — проверкой текста)
+bool matchesQuery(const IndexQuery &query,
+                  time_t timestamp, StatsLevel level,
+                  std::string_view message);
+
+// Оставляет не больше limit самых новых по времени записи
+// сообщений, по возрастанию времени (при равном времени
+// порядок сохраняется)
+void keepNewestHits(std::vector<IndexHit> &hits,
+                    std::size_t limit);
+
+// Поиск по индексам всех реакторов: не больше
+// query.limit самых новых по времени записи, по
+// возрастанию времени
+std::vector<IndexHit> searchIndexes(
+  const std::vector<const LogIndex *> &indexes,
+  const IndexQuery &query);
@@ -0,0 +1,140 @@
+#include "QueryServer.h"
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <utility>
+
+using namespace std;
+
+QueryServer::QueryServer(int listenFd, Handler handler)
+    : listen_(listenFd), handler_(move(handler)) {
+  wake_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (wake_ < 0)
+    perror("eventfd");
+}
+
+QueryServer::~QueryServer() {
+  if (listen_ >= 0)
+    close(listen_);
+  if (wake_ >= 0)
+    close(wake_);
+}
+
+// Безопасно из любого потока
+void QueryServer::stop() {
+  uint64_t one = 1;
+  ssize_t rc = write(wake_, &one, sizeof(one));
+  (void)rc;  // Переполнение счётчика eventfd не важно
+}
+
+void QueryServer::run() {
+  if (listen_ < 0 || wake_ < 0)
+    return;
+  pollfd fds[2]
+    = {{listen_, POLLIN, 0}, {wake_, POLLIN, 0}};
+  while (true) {
+    int n = poll(fds, 2, -1);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      perror("poll");
+      return;
+    }
+    if (fds[1].revents != 0)
+      return;  // stop()
+
+    // Слушающий сокет неблокирующий: принимаем всех
+    // ожидающих, принятые сокеты блокирующие
+    while (true) {
+      int fd = accept4(listen_, nullptr, nullptr,
+                       SOCK_CLOEXEC);
+      if (fd < 0) {
+        if (errno == EINTR || errno == ECONNABORTED)
+          continue;
+        if (errno != EAGAIN && errno != EWOULDBLOCK)
+          perror("accept");
+        break;
+      }
+      serve(fd);
+    }
+  }
+}
+
+// eventfd после stop() остаётся взведённым, так что и
+// run() затем завершится
+bool QueryServer::waitFor(int fd, short events,
+                          Clock::time_point deadline) {
+  while (true) {
+    auto left = chrono::duration_cast<chrono::milliseconds>(
+      deadline - Clock::now());
+    if (left.count() <= 0)
+      return false;
+    pollfd fds[2] = {{fd, events, 0}, {wake_, POLLIN, 0}};
+    int timeout = static_cast<int>(left.count()) + 1;
+    int n = poll(fds, 2, timeout);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0 || fds[1].revents != 0)
+      return false;
+    return true;  // Готов или ошибка — её покажет recv/send
+  }
+}
+
+void QueryServer::serve(int fd) {
+  // Один срок на весь обмен: клиент, присылающий по
+  // байту, не займёт сервер дольше kClientTimeoutMs
+  auto deadline = Clock::now()
+                  + chrono::milliseconds(kClientTimeoutMs);
+
+  // Запрос — до '\n' или конца потока
+  string query;
+  char buffer[1024];
+  while (query.find('\n') == string::npos
+         && query.size() <= kMaxQuery) {
+    if (!waitFor(fd, POLLIN, deadline)) {
+      close(fd);  // Не успел или остановка — без ответа
+      return;
+    }
+    ssize_t bytes
+      = recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+    if (bytes < 0
+        && (errno == EINTR || errno == EAGAIN
+            || errno == EWOULDBLOCK))
+      continue;
+    if (bytes <= 0)
+      break;  // Конец потока или ошибка
+    query.append(buffer, static_cast<size_t>(bytes));
+  }
+  query = query.substr(0, query.find('\n'));
+  if (!query.empty() && query.back() == '\r')
+    query.pop_back();
+
+  string response = query.size() > kMaxQuery
+                      ? string("# error: query too long\n")
+                      : handler_(query);
+  size_t sent = 0;
+  while (sent < response.size()) {
+    ssize_t bytes = send(fd, response.data() + sent,
+                         response.size() - sent,
+                         MSG_NOSIGNAL | MSG_DONTWAIT);
+    if (bytes < 0
+        && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      if (waitFor(fd, POLLOUT, deadline))
+        continue;
+      break;  // Клиент не читает или остановка
+    }
+    if (bytes < 0 && errno == EINTR)
+      continue;
+    if (bytes <= 0)
+      break;  // Клиент ушёл
+    sent += static_cast<size_t>(bytes);
+  }
+  close(fd);
+}
@@ -0,0 +1,62 @@
+#pragma once  // Защита от повторного включения
+              // заголовочного файла
+
+#include <chrono>  // Для срока обмена с клиентом
+#include <cstddef>  // Для std::size_t
+#include <functional>  // Для обработчика запросов
+#include <string>  // Для ответа
+#include <string_view>  // Для строки запроса
+
+// Сервер запросов к принятым сообщениям: клиент
+// подключается, отправляет одну строку запроса и
+// получает ответ, после чего соединение закрывается
+// (удобно для nc). Запросы обслуживаются по одному в
+// собственном потоке сервера, поэтому ни медленный
+// клиент, ни тяжёлый запрос не задерживают циклы
+// событий приёма. На весь обмен — отправку запроса и
+// чтение ответа — клиенту даётся kClientTimeoutMs, а
+// stop() прерывает и обмен, который идёт.
+class QueryServer {
+ public:
+  // Ответ на строку запроса (без '\n')
+  using Handler
+    = std::function<std::string(std::string_view)>;
+
+  // Предел длины запроса
+  static constexpr std::size_t kMaxQuery = 4096;
+
+  // Срок на чтение запроса и отправку ответа вместе
+  static constexpr int kClientTimeoutMs = 2000;
+
+  // listenFd — неблокирующий слушающий потоковый сокет,
+  // сервер становится его владельцем
+  QueryServer(int listenFd, Handler handler);
+
+  // Закрывает слушающий сокет
+  ~QueryServer();
+
+  QueryServer(const QueryServer &) = delete;
+  QueryServer &operator=(const QueryServer &) = delete;
+
+  // Обслуживает запросы, пока не вызван stop()
+  void run();
+
+  // Просит run() завершиться; можно вызывать из любого
+  // потока
+  void stop();
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  // Ждёт events на fd до deadline; false — время вышло
+  // или вызван stop()
+  bool waitFor(int fd, short events,
+               Clock::time_point deadline);
+
+  // Читает запрос клиента, отвечает и закрывает fd
+  void serve(int fd);
+
+  int listen_;  // Слушающий сокет
+  int wake_ = -1;  // eventfd для stop()
+  Handler handler_;  // Обработчик запросов
+};
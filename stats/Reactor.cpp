@@ -0,0 +1,341 @@
+#include "Reactor.h"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+
+namespace {
+
+// Сколько событий забирать за один epoll_wait
+constexpr int kMaxEvents = 256;
+
+// Размер буфера одного recv (не меньше датаграммы UDP)
+constexpr size_t kChunk = 64 * 1024;
+
+// Сколько свободных буферов строк держать в пуле
+constexpr size_t kSpareBuffers = 64;
+
+// Строка без завершающих '\r' и '\n'
+string_view trimLine(string_view line) {
+  while (!line.empty()
+         && (line.back() == '\n' || line.back() == '\r'))
+    line.remove_suffix(1);
+  return line;
+}
+
+}  // namespace
+
+void MessageSink::onNotice(string_view text, bool error) {
+  (void)error;
+  cout << text << "\n";
+}
+
+Reactor::Reactor(MessageSink &sink, size_t lineBuffer)
+    : sink_(sink), chunk_(kChunk), lineBuffer_(lineBuffer) {
+  epoll_ = epoll_create1(EPOLL_CLOEXEC);
+  if (epoll_ < 0)
+    perror("epoll_create1");
+  wake_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (wake_ < 0)
+    perror("eventfd");
+  if (epoll_ >= 0 && wake_ >= 0 && watch(wake_))
+    listeners_[wake_] = Kind::Wake;
+}
+
+Reactor::~Reactor() {
+  for (auto &[fd, conn] : connections_)
+    close(fd);
+  for (auto &[fd, kind] : listeners_)
+    close(fd);  // Включая wake_
+  if (epoll_ >= 0)
+    close(epoll_);
+}
+
+bool Reactor::watch(int fd) {
+  epoll_event ev{};
+  ev.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+  ev.data.fd = fd;
+  if (epoll_ctl(epoll_, EPOLL_CTL_ADD, fd, &ev) < 0) {
+    perror("epoll_ctl");
+    return false;
+  }
+  return true;
+}
+
+bool Reactor::addListener(int fd, bool stream) {
+  if (!watch(fd))
+    return false;
+  listeners_[fd] = stream ? Kind::StreamListener
+                         : Kind::DatagramListener;
+  return true;
+}
+
+// Безопасно из любого потока и из обработчика сигнала
+void Reactor::stop() {
+  uint64_t one = 1;
+  ssize_t rc = write(wake_, &one, sizeof(one));
+  (void)rc;  // Переполнение счётчика eventfd не важно
+}
+
+// Цикл событий: готовые сокеты, затем очередь сокетов,
+// у которых кончился бюджет чтения. Пока очередь не пуста,
+// epoll_wait не ждёт, иначе ждёт не дольше kTickMs, чтобы
+// получатель мог доделать отложенное в onTick
+void Reactor::run() {
+  if (epoll_ < 0 || wake_ < 0)
+    return;
+  epoll_event events[kMaxEvents];
+  bool stopping = false;
+  while (!stopping) {
+    sink_.onTick();
+    int timeout = backlog_.empty() ? kTickMs : 0;
+    int n = epoll_wait(epoll_, events, kMaxEvents, timeout);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      perror("epoll_wait");
+      break;
+    }
+
+    for (int i = 0; i < n; ++i) {
+      int fd = events[i].data.fd;
+      if (fd == wake_) {
+        stopping = true;
+        continue;
+      }
+      dispatch(fd);
+    }
+
+    vector<int> deferred;
+    deferred.swap(backlog_);
+    for (int fd : deferred)
+      dispatch(fd);
+  }
+}
+
+void Reactor::dispatch(int fd) {
+  auto listener = listeners_.find(fd);
+  if (listener != listeners_.end()) {
+    if (listener->second == Kind::StreamListener)
+      acceptAll(fd);
+    else if (readDatagrams(fd))
+      defer(fd);
+    return;
+  }
+
+  auto it = connections_.find(fd);
+  if (it == connections_.end())
+    return;  // Уже закрыто
+  bool more = false;
+  if (!readConnection(*it->second, more))
+    closeConnection(fd);
+  else if (more)
+    defer(fd);
+}
+
+void Reactor::defer(int fd) {
+  if (find(backlog_.begin(), backlog_.end(), fd)
+      == backlog_.end())
+    backlog_.push_back(fd);
+}
+
+// Edge-triggered: принимаем, пока очередь listen не пуста
+void Reactor::acceptAll(int listenFd) {
+  while (true) {
+    int fd = accept4(listenFd, nullptr, nullptr,
+                     SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) {
+      if (errno == EINTR || errno == ECONNABORTED)
+        continue;
+      if (errno != EAGAIN && errno != EWOULDBLOCK)
+        perror("accept");
+      return;
+    }
+    if (!watch(fd)) {
+      close(fd);
+      continue;
+    }
+    auto conn = make_unique<Connection>();
+    conn->fd = fd;
+    conn->lines = LineReader(lineBuffer_);
+    connections_[fd] = move(conn);
+    sink_.onConnect(fd);
+  }
+}
+
+bool Reactor::readDatagrams(int fd) {
+  size_t budget = kReadBudget;
+  while (budget > 0) {
+    ssize_t bytes
+      = recv(fd, chunk_.data(), chunk_.size(), 0);
+    if (bytes < 0) {
+      if (errno == EINTR)
+        continue;
+      if (errno != EAGAIN && errno != EWOULDBLOCK)
+        perror("recv");
+      return false;
+    }
+    budget -= min(budget, static_cast<size_t>(bytes));
+    // Одна датаграмма — одно сообщение
+    string_view line = trimLine(string_view(
+      chunk_.data(), static_cast<size_t>(bytes)));
+    if (!line.empty())
+      sink_.onLine(line);
+  }
+  return true;
+}
+
+// Соединение, у которого не осталось неполной строки,
+// возвращает буфер в пул
+bool Reactor::readConnection(Connection &conn, bool &more) {
+  if (!conn.framed && !conn.lines.hasBuffer())
+    conn.lines.adopt(takeBuffer());
+  bool open = readStream(conn, more);
+  if (open && conn.lines.hasBuffer() && conn.lines.empty())
+    returnBuffer(conn.lines.release());
+  return open;
+}
+
+// Текст читается прямо в буфер строк, кадры — через
+// общий буфер в декодер
+bool Reactor::readStream(Connection &conn, bool &more) {
+  size_t budget = kReadBudget;
+  while (true) {
+    if (budget == 0) {
+      more = true;
+      return true;
+    }
+    size_t room = chunk_.size();
+    char *dest = conn.framed ? chunk_.data()
+                             : conn.lines.space(room);
+    ssize_t bytes
+      = recv(conn.fd, dest, min(room, budget), 0);
+    if (bytes > 0) {
+      auto len = static_cast<size_t>(bytes);
+      budget -= len;
+      if (conn.framed) {
+        conn.frames.feed(dest, len);
+        if (!consumeFrames(conn))
+          return false;
+      } else {
+        conn.lines.commit(len);
+        if (!consumeLines(conn))
+          return false;
+      }
+      continue;
+    }
+    if (bytes == 0) {
+      sink_.onNotice(
+        "INFO: Client closed connection gracefully", false);
+      return false;
+    }
+    if (errno == EINTR)
+      continue;
+    if (errno == EAGAIN || errno == EWOULDBLOCK)
+      return true;
+    sink_.onNotice(
+      string("ERROR: recv failed: ") + strerror(errno),
+      true);
+    return false;
+  }
+}
+
+// Текст: целые строки отдаются прямо из буфера
+// соединения, хвост без '\n' остаётся до следующего recv
+bool Reactor::consumeLines(Connection &conn) {
+  string_view line;
+  while (conn.lines.next(line)) {
+    line = trimLine(line);
+    if (conn.firstLine) {
+      conn.firstLine = false;
+      if (acceptFramed(conn, line)) {
+        // Всё после приветствия — уже кадры
+        conn.framed = true;
+        string_view rest = conn.lines.pending();
+        conn.frames.feed(rest.data(), rest.size());
+        returnBuffer(conn.lines.release());
+        return consumeFrames(conn);
+      }
+    }
+    sink_.onLine(line);
+  }
+  return true;
+}
+
+vector<char> Reactor::takeBuffer() {
+  if (spare_.empty())
+    return {};
+  vector<char> buffer = move(spare_.back());
+  spare_.pop_back();
+  return buffer;
+}
+
+// Увеличенные длинной строкой буферы в пул не берутся
+void Reactor::returnBuffer(vector<char> &&buffer) {
+  if (buffer.size() == lineBuffer_
+      && spare_.size() < kSpareBuffers)
+    spare_.push_back(move(buffer));
+}
+
+bool Reactor::consumeFrames(Connection &conn) {
+  logger::frame::Frame frame;
+  while (conn.frames.next(frame))
+    sink_.onFrame(frame);
+  if (conn.frames.failed()) {
+    sink_.onNotice("ERROR: Corrupt frame stream", true);
+    return false;
+  }
+  return true;
+}
+
+bool Reactor::acceptFramed(Connection &conn,
+                           string_view line) {
+  if (logger::frame::parseHello(line)
+      != logger::frame::kVersion)
+    return false;
+  // Подтверждение короче любого буфера отправки, поэтому
+  // неблокирующий send отправляет его целиком
+  string ack = logger::frame::ackLine();
+  if (send(conn.fd, ack.data(), ack.size(), MSG_NOSIGNAL)
+      != static_cast<ssize_t>(ack.size()))
+    return false;
+  sink_.onNotice(
+    "INFO: Client switched to framed protocol v"
+      + to_string(logger::frame::kVersion),
+    false);
+  return true;
+}
+
+void Reactor::closeConnection(int fd) {
+  auto it = connections_.find(fd);
+  if (it == connections_.end())
+    return;
+  Connection &conn = *it->second;
+  if (conn.framed && conn.frames.pending() > 0)
+    sink_.onNotice("WARNING: Incomplete frame dropped",
+                   true);
+  // Обработка остатков данных, если есть
+  if (!conn.framed) {
+    string_view rest = trimLine(conn.lines.pending());
+    if (!rest.empty())
+      sink_.onLine(rest);
+  }
+
+  // Закрытие дескриптора удаляет его из epoll
+  close(fd);
+  connections_.erase(it);
+  backlog_.erase(
+    remove(backlog_.begin(), backlog_.end(), fd),
+    backlog_.end());
+  sink_.onDisconnect(fd);
+}
@@ -0,0 +1,167 @@
+#pragma once  // Защита от повторного включения
+              // заголовочного файла
+
+#include <cstddef>  // Для std::size_t
+#include <memory>  // Для std::unique_ptr
+#include <string_view>  // Для строк без копирования
+#include <unordered_map>  // Для соединений по дескриптору
+#include <vector>  // Для очереди недочитанных соединений
+
+#include "LineReader.h"  // Разбор строк без копирования
+#include "logger/FrameProtocol.h"  // Кадры и рукопожатие
+
+// Получатель сообщений, принятых реактором. Вызывается из
+// потока реактора; строки действительны только на время
+// вызова
+class MessageSink {
+ public:
+  virtual ~MessageSink() = default;
+
+  // Строка текстового протокола или датаграмма (без '\n')
+  virtual void onLine(std::string_view line) = 0;
+
+  // Кадр протокола кадров: уровень и время уже известны
+  virtual void onFrame(
+    const logger::frame::Frame &frame) = 0;
+
+  // Подключение и отключение клиента потокового сокета
+  virtual void onConnect(int fd) { (void)fd; }
+  virtual void onDisconnect(int fd) { (void)fd; }
+
+  // Сообщение реактора о соединении (строка без '\n');
+  // error — ошибка, а не обычное событие. По умолчанию
+  // выводится в std::cout
+  virtual void onNotice(std::string_view text, bool error);
+
+  // Каждый проход цикла событий и не реже чем раз в
+  // Reactor::kTickMs, даже без сообщений: для отложенной
+  // работы получателя (например, публикации индекса)
+  virtual void onTick() {}
+};
+
+// Цикл событий на epoll в режиме edge-triggered: один
+// поток обслуживает слушающие сокеты, все соединения и
+// датаграммные сокеты. Сокеты неблокирующие; у каждого
+// соединения свой буфер недочитанной строки или кадра.
+// Текст читается прямо в буфер строк соединения
+// (LineReader), буферы простаивающих соединений
+// возвращаются в общий пул реактора.
+// За одно событие из соединения читается не больше
+// kReadBudget байт, остаток дочитывается после других
+// готовых сокетов, чтобы быстрый клиент не задерживал
+// остальных.
+class Reactor {
+ public:
+  // Сколько байт читать из одного сокета за подход
+  static constexpr std::size_t kReadBudget = 256 * 1024;
+
+  // Наибольший интервал между вызовами onTick
+  static constexpr int kTickMs = 100;
+
+  // lineBuffer — размер буфера строк одного соединения
+  explicit Reactor(
+    MessageSink &sink,
+    std::size_t lineBuffer = LineReader::kDefaultCapacity);
+
+  // Закрывает все соединения и слушающие сокеты
+  ~Reactor();
+
+  Reactor(const Reactor &) = delete;
+  Reactor &operator=(const Reactor &) = delete;
+
+  // Добавляет неблокирующий слушающий сокет (потоковый —
+  // принимает соединения, датаграммный — читает
+  // датаграммы). Реактор становится владельцем fd.
+  // Вызывать до run()
+  bool addListener(int fd, bool stream);
+
+  // Обрабатывает события, пока не вызван stop()
+  void run();
+
+  // Просит run() завершиться; можно вызывать из любого
+  // потока
+  void stop();
+
+  // Число открытых соединений (для потока реактора)
+  std::size_t connections() const {
+    return connections_.size();
+  }
+
+ private:
+  // Принятое соединение потокового сокета
+  struct Connection {
+    int fd = -1;  // Дескриптор
+    LineReader lines;  // Принятые, ещё не разобранные
+                       // строки
+    bool firstLine = true;  // Ещё не было ни одной строки
+    bool framed = false;  // Клиент перешёл на кадры
+    logger::frame::FrameDecoder frames;  // Декодер кадров
+  };
+
+  // Что стоит за дескриптором в epoll
+  enum class Kind {
+    Wake,  // eventfd остановки
+    StreamListener,  // accept
+    DatagramListener  // recv датаграмм
+  };
+
+  // Регистрирует fd в epoll на чтение (edge-triggered)
+  bool watch(int fd);
+
+  // Принимает все ожидающие соединения
+  void acceptAll(int listenFd);
+
+  // Обрабатывает готовность сокета fd: слушателя или
+  // соединения
+  void dispatch(int fd);
+
+  // Читает ожидающие датаграммы, пока не кончится бюджет;
+  // true — данные ещё остались
+  bool readDatagrams(int fd);
+
+  // Читает из соединения до EAGAIN или исчерпания
+  // бюджета (тогда more = true). false — соединение
+  // закрыто или поток повреждён
+  bool readConnection(Connection &conn, bool &more);
+
+  // Цикл recv для readConnection
+  bool readStream(Connection &conn, bool &more);
+
+  // Выдаёт получателю все целые строки соединения
+  bool consumeLines(Connection &conn);
+
+  // Выдаёт получателю все целые кадры соединения
+  bool consumeFrames(Connection &conn);
+
+  // Первая строка — приветствие протокола кадров? Если
+  // версия поддерживается, отвечает подтверждением
+  bool acceptFramed(Connection &conn,
+                    std::string_view line);
+
+  // Буфер строк из пула (пустой — выделит LineReader)
+  std::vector<char> takeBuffer();
+
+  // Возвращает буфер строк в пул
+  void returnBuffer(std::vector<char> &&buffer);
+
+  // Ставит сокет в очередь недочитанных
+  void defer(int fd);
+
+  // Закрывает соединение (недочитанная строка
+  // обрабатывается как последняя)
+  void closeConnection(int fd);
+
+  MessageSink &sink_;  // Получатель сообщений
+  int epoll_ = -1;  // Дескриптор epoll
+  int wake_ = -1;  // eventfd для stop()
+  std::unordered_map<int, Kind> listeners_;  // Слушатели
+  std::unordered_map<int, std::unique_ptr<Connection>>
+    connections_;  // Соединения по дескриптору
+  std::vector<int> backlog_;  // Сокеты с недочитанными
+                              // данными
+  std::vector<char> chunk_;  // Буфер recv датаграмм и
+                            // кадров
+  std::size_t lineBuffer_;  // Размер буфера строк
+  std::vector<std::vector<char>>
+    spare_;  // Свободные буферы строк
+};
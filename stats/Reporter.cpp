@@ -0,0 +1,116 @@
+#include "Reporter.h"
+
+using namespace std;
+
+bool parseVerbosity(string_view text, Verbosity &out) {
+  if (text == "quiet")
+    out = Verbosity::Quiet;
+  else if (text == "normal")
+    out = Verbosity::Normal;
+  else if (text == "verbose")
+    out = Verbosity::Verbose;
+  else
+    return false;
+  return true;
+}
+
+Reporter::Reporter(Verbosity verbosity, size_t capacity,
+                   ostream &out)
+    : verbosity_(verbosity),
+      capacity_(capacity),
+      out_(out) {
+  thread_ = thread(&Reporter::run, this);
+}
+
+Reporter::~Reporter() {
+  {
+    lock_guard<mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  readyCv_.notify_one();
+  thread_.join();
+}
+
+// Эхо упирается в предел раньше событий соединений,
+// поэтому поток принятых сообщений не вытесняет их
+// целиком; отчёты и ошибки (Quiet) не отбрасываются
+size_t Reporter::limit(Verbosity level) const {
+  switch (level) {
+    case Verbosity::Quiet:
+      return SIZE_MAX;
+    case Verbosity::Normal:
+      return capacity_;
+    case Verbosity::Verbose:
+      break;
+  }
+  return capacity_ - capacity_ / 4;
+}
+
+// Сообщение, не помещающееся в свою часть буфера,
+// отбрасывается целиком, чтобы строки не обрывались
+void Reporter::append(Verbosity level,
+                      const string_view *parts,
+                      size_t count) {
+  size_t total = 0;
+  for (size_t i = 0; i < count; ++i)
+    total += parts[i].size();
+
+  bool wake = false;
+  {
+    lock_guard<mutex> lock(mutex_);
+    if (pending_.size() + total > limit(level)) {
+      ++dropped_;
+      return;
+    }
+    wake = pending_.empty();
+    for (size_t i = 0; i < count; ++i)
+      pending_.append(parts[i].data(), parts[i].size());
+  }
+  if (wake)
+    readyCv_.notify_one();
+}
+
+void Reporter::flush() {
+  unique_lock<mutex> lock(mutex_);
+  drainedCv_.wait(
+    lock, [this] { return pending_.empty() && !writing_; });
+}
+
+uint64_t Reporter::dropped() const {
+  lock_guard<mutex> lock(mutex_);
+  return dropped_;
+}
+
+// Буферы меняются местами: пока поток пишет одну пачку,
+// приём дописывает следующую, и память буферов
+// переиспользуется
+void Reporter::run() {
+  string batch;
+  unique_lock<mutex> lock(mutex_);
+  while (true) {
+    readyCv_.wait(lock, [this] {
+      return !pending_.empty() || stopping_;
+    });
+    if (pending_.empty())
+      break;  // Остановка, всё выведено
+
+    batch.swap(pending_);
+    uint64_t lost = dropped_ - reported_;
+    reported_ = dropped_;
+    writing_ = true;
+    lock.unlock();
+
+    if (lost > 0)
+      out_ << "⚠️ Console output dropped " << lost
+           << " messages\n";
+    out_.write(batch.data(),
+               static_cast<streamsize>(batch.size()));
+    out_.flush();
+    batch.clear();
+
+    lock.lock();
+    writing_ = false;
+    if (pending_.empty())
+      drainedCv_.notify_all();
+  }
+}
@@ -0,0 +1,99 @@
+#pragma once  // Защита от повторного включения
+              // заголовочного файла
+
+#include <condition_variable>  // Для пробуждения потока
+#include <cstddef>  // Для std::size_t
+#include <cstdint>  // Для std::uint64_t
+#include <iostream>  // Для std::ostream, std::cout
+#include <mutex>  // Для мьютекса буфера
+#include <string>  // Для буфера вывода
+#include <string_view>  // Для частей сообщения
+#include <thread>  // Для потока вывода
+
+// Подробность вывода log_stats
+enum class Verbosity {
+  Quiet,  // Только отчёты и ошибки
+  Normal,  // И события соединений
+  Verbose  // И эхо каждого принятого сообщения
+};
+
+// Разбирает "quiet", "normal" или "verbose"; false при
+// ошибке
+bool parseVerbosity(std::string_view text, Verbosity &out);
+
+// Асинхронный вывод на консоль. Потоки приёма только
+// дописывают текст в ограниченный буфер под коротким
+// мьютексом; записью в поток (по умолчанию std::cout)
+// занимается отдельный поток, поэтому медленный терминал
+// не тормозит приём. Если буфер полон, сообщение
+// отбрасывается, а число отброшенных выводится при
+// следующей записи. Первым отбрасывается эхо (Verbose):
+// ему доступны три четверти буфера, событиям соединений
+// (Normal) — весь буфер, а отчёты и ошибки (Quiet) не
+// отбрасываются никогда и могут ненадолго превысить
+// ёмкость.
+class Reporter {
+ public:
+  // Ёмкость буфера по умолчанию
+  static constexpr std::size_t kDefaultCapacity
+    = 1024 * 1024;
+
+  explicit Reporter(
+    Verbosity verbosity,
+    std::size_t capacity = kDefaultCapacity,
+    std::ostream &out = std::cout);
+
+  // Выводит остаток буфера и останавливает поток
+  ~Reporter();
+
+  Reporter(const Reporter &) = delete;
+  Reporter &operator=(const Reporter &) = delete;
+
+  // Выводится ли сообщение уровня level
+  bool enabled(Verbosity level) const {
+    return level <= verbosity_;
+  }
+
+  // Ставит в очередь сообщение из частей (строки
+  // склеиваются прямо в буфере, без промежуточной строки),
+  // если уровень level включён
+  template <typename... Parts>
+  void post(Verbosity level, const Parts &...parts) {
+    if (!enabled(level))
+      return;
+    const std::string_view views[]
+      = {std::string_view(parts)...};
+    append(level, views, sizeof...(Parts));
+  }
+
+  // Ждёт, пока всё поставленное не будет выведено
+  void flush();
+
+  // Число отброшенных из-за переполнения сообщений
+  std::uint64_t dropped() const;
+
+ private:
+  // Предел буфера для сообщений уровня level
+  std::size_t limit(Verbosity level) const;
+
+  void append(Verbosity level,
+              const std::string_view *parts,
+              std::size_t count);
+
+  // Цикл потока вывода
+  void run();
+
+  Verbosity verbosity_;  // Подробность
+  std::size_t capacity_;  // Предел буфера в байтах
+  std::ostream &out_;  // Куда выводить
+
+  mutable std::mutex mutex_;  // Мьютекс буфера
+  std::condition_variable readyCv_;  // Есть что выводить
+  std::condition_variable drainedCv_;  // Всё выведено
+  std::string pending_;  // Ещё не выведенный текст
+  bool writing_ = false;  // Поток выводит пачку
+  bool stopping_ = false;  // Флаг остановки
+  std::uint64_t dropped_ = 0;  // Отброшено всего
+  std::uint64_t reported_ = 0;  // Из них уже сообщено
+  std::thread thread_;  // Поток вывода
+};
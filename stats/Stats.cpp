@@ -0,0 +1,285 @@
+#include "Stats.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <thread>
+
+using namespace std;
+
+const char *statsLevelName(StatsLevel level) {
+  switch (level) {
+    case StatsLevel::Error:
+      return "ERROR";
+    case StatsLevel::Warning:
+      return "WARNING";
+    case StatsLevel::Info:
+      return "INFO";
+    case StatsLevel::Debug:
+      return "DEBUG";
+    case StatsLevel::Unknown:
+    case StatsLevel::Count:
+      break;
+  }
+  return "unknown";
+}
+
+StatsLevel statsLevel(logger::LogLevel level) {
+  switch (level) {
+    case logger::LogLevel::Error:
+      return StatsLevel::Error;
+    case logger::LogLevel::Warning:
+      return StatsLevel::Warning;
+    case logger::LogLevel::Info:
+      return StatsLevel::Info;
+  }
+  return StatsLevel::Unknown;
+}
+
+vector<RateWindow> defaultRateWindows() {
+  return {{60, 1}, {3600, 10}, {86400, 240}};
+}
+
+// Положительное десятичное число на всю строку; 0 при
+// ошибке
+static int64_t parseSeconds(const string &text) {
+  if (text.empty() || text[0] < '0' || text[0] > '9')
+    return 0;
+  errno = 0;
+  char *end = nullptr;
+  long long value = strtoll(text.c_str(), &end, 10);
+  if (errno != 0 || *end != '\0')
+    return 0;
+  return static_cast<int64_t>(value);
+}
+
+bool parseRateWindows(const string &spec,
+                      vector<RateWindow> &out) {
+  // Предел корзин одного окна (память шарда)
+  constexpr size_t kMaxBuckets = 100000;
+  vector<RateWindow> parsed;
+  size_t start = 0;
+  while (start <= spec.size()) {
+    size_t end = spec.find(',', start);
+    if (end == string::npos)
+      end = spec.size();
+    string item = spec.substr(start, end - start);
+    start = end + 1;
+
+    RateWindow window;
+    size_t slash = item.find('/');
+    window.seconds = parseSeconds(item.substr(0, slash));
+    if (slash == string::npos) {
+      window.step
+        = max<int64_t>(1, (window.seconds + 359) / 360);
+    } else {
+      window.step = parseSeconds(item.substr(slash + 1));
+    }
+    if (window.seconds <= 0 || window.step <= 0
+        || window.step > window.seconds
+        || window.buckets() > kMaxBuckets)
+      return false;
+    parsed.push_back(window);
+  }
+  out = parsed;
+  return true;
+}
+
+string rateWindowName(int64_t seconds) {
+  if (seconds % 86400 == 0)
+    return to_string(seconds / 86400) + "d";
+  if (seconds % 3600 == 0)
+    return to_string(seconds / 3600) + "h";
+  if (seconds % 60 == 0)
+    return to_string(seconds / 60) + "m";
+  return to_string(seconds) + "s";
+}
+
+uint64_t WindowCounts::total() const {
+  uint64_t sum = 0;
+  for (uint64_t count : levelCount)
+    sum += count;
+  return sum;
+}
+
+void StatsSnapshot::merge(const StatsSnapshot &other) {
+  totalMessages += other.totalMessages;
+  for (size_t i = 0; i < kStatsLevels; ++i)
+    levelCount[i] += other.levelCount[i];
+  minLen = min(minLen, other.minLen);
+  maxLen = max(maxLen, other.maxLen);
+  totalLen += other.totalLen;
+  lengths.merge(other.lengths);
+  latency.merge(other.latency);
+  if (windows.empty()) {
+    windows = other.windows;
+    return;
+  }
+  size_t common = min(windows.size(), other.windows.size());
+  for (size_t w = 0; w < common; ++w) {
+    for (size_t i = 0; i < kStatsLevels; ++i)
+      windows[w].levelCount[i]
+        += other.windows[w].levelCount[i];
+  }
+}
+
+StatsShard::StatsShard(vector<RateWindow> windows)
+    : minLen_(UINT64_MAX) {
+  for (Counter &level : levels_)
+    level.store(0, memory_order_relaxed);
+  for (size_t b = 0; b < Histogram::kBuckets; ++b) {
+    lengths_[b].store(0, memory_order_relaxed);
+    latency_[b].store(0, memory_order_relaxed);
+  }
+  for (const RateWindow &spec : windows) {
+    Window window;
+    window.spec = spec;
+    window.size = spec.buckets();
+    window.buckets = make_unique<Bucket[]>(window.size);
+    for (size_t b = 0; b < window.size; ++b) {
+      for (Counter &count : window.buckets[b].levels)
+        count.store(0, memory_order_relaxed);
+    }
+    windows_.push_back(move(window));
+  }
+}
+
+// Сначала корзины гистограмм и окон (вне seqlock: иначе
+// почти 8 тысяч счётчиков, которые копирует снимок, не
+// давали бы ему дочитать при непрерывном приёме), затем
+// итоги внутри seqlock: нечётная версия, release-барьер,
+// счётчики, чётная версия с release. Так всё, что учтено
+// в итогах, уже есть и в корзинах
+void StatsShard::add(StatsLevel level, size_t length,
+                     time_t timestamp, int64_t latencyUs) {
+  // Корзины гистограмм только растут
+  bump(lengths_[Histogram::bucketOf(length)], 1);
+  if (latencyUs >= 0)
+    bump(latency_[Histogram::bucketOf(
+           static_cast<uint64_t>(latencyUs))],
+         1);
+
+  // Корзины окон: устаревшая корзина начинается заново,
+  // запись старше корзины (старше окна) в окно не
+  // попадает. Номер интервала корзины служит ей версией:
+  // на время обнуления он равен kResetting
+  auto slot = static_cast<size_t>(level);
+  for (Window &window : windows_) {
+    int64_t index
+      = static_cast<int64_t>(timestamp) / window.spec.step;
+    Bucket &bucket = window.buckets[static_cast<size_t>(
+                                      index)
+                                    % window.size];
+    int64_t current
+      = bucket.index.load(memory_order_relaxed);
+    if (index > current) {
+      bucket.index.store(kResetting, memory_order_relaxed);
+      atomic_thread_fence(memory_order_release);
+      for (Counter &count : bucket.levels)
+        count.store(0, memory_order_relaxed);
+      bucket.levels[slot].store(1, memory_order_relaxed);
+      bucket.index.store(index, memory_order_release);
+    } else if (index == current) {
+      bump(bucket.levels[slot], 1);
+    }
+  }
+
+  uint64_t seq = seq_.load(memory_order_relaxed);
+  seq_.store(seq + 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+
+  bump(total_, 1);
+  bump(levels_[static_cast<size_t>(level)], 1);
+  if (length < minLen_.load(memory_order_relaxed))
+    minLen_.store(length, memory_order_relaxed);
+  if (length > maxLen_.load(memory_order_relaxed))
+    maxLen_.store(length, memory_order_relaxed);
+  bump(totalLen_, length);
+
+  seq_.store(seq + 2, memory_order_release);
+}
+
+// Итоги читаются под seqlock, пока версия нечётная или
+// изменилась за время чтения; запись итогов короткая,
+// поэтому повторы редки. Гистограммы и окна читаются
+// после итогов и включают все учтённые в них сообщения
+// (и, возможно, несколько следующих)
+StatsSnapshot StatsShard::snapshot(time_t now) const {
+  StatsSnapshot result;
+  while (true) {
+    uint64_t before = seq_.load(memory_order_acquire);
+    if (before & 1) {
+      this_thread::yield();  // Писатель внутри add()
+      continue;
+    }
+
+    result.totalMessages
+      = total_.load(memory_order_relaxed);
+    for (size_t i = 0; i < kStatsLevels; ++i)
+      result.levelCount[i]
+        = levels_[i].load(memory_order_relaxed);
+    uint64_t minLen = minLen_.load(memory_order_relaxed);
+    result.minLen = minLen == UINT64_MAX
+                      ? SIZE_MAX
+                      : static_cast<size_t>(minLen);
+    result.maxLen = static_cast<size_t>(
+      maxLen_.load(memory_order_relaxed));
+    result.totalLen = static_cast<size_t>(
+      totalLen_.load(memory_order_relaxed));
+
+    atomic_thread_fence(memory_order_acquire);
+    if (seq_.load(memory_order_relaxed) == before)
+      break;
+  }
+
+  for (size_t b = 0; b < Histogram::kBuckets; ++b) {
+    uint64_t lengths
+      = lengths_[b].load(memory_order_relaxed);
+    if (lengths > 0)
+      result.lengths.recordBucket(b, lengths);
+    uint64_t latency
+      = latency_[b].load(memory_order_relaxed);
+    if (latency > 0)
+      result.latency.recordBucket(b, latency);
+  }
+
+  // Корзины, чей интервал ещё попадает в окно от now.
+  // Корзина перечитывается, только если писатель начал
+  // её заново во время чтения (раз в step секунд)
+  result.windows.resize(windows_.size());
+  for (size_t w = 0; w < windows_.size(); ++w) {
+    const Window &window = windows_[w];
+    WindowCounts &counts = result.windows[w];
+    counts.window = window.spec;
+    int64_t nowIndex
+      = static_cast<int64_t>(now) / window.spec.step;
+    for (size_t b = 0; b < window.size; ++b) {
+      const Bucket &bucket = window.buckets[b];
+      array<uint64_t, kStatsLevels> levels{};
+      int64_t index = 0;
+      while (true) {
+        index = bucket.index.load(memory_order_acquire);
+        if (index == kResetting) {
+          this_thread::yield();  // Писатель обнуляет её
+          continue;
+        }
+        if (index < 0)
+          break;  // Пустая
+        for (size_t i = 0; i < kStatsLevels; ++i)
+          levels[i]
+            = bucket.levels[i].load(memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+        if (bucket.index.load(memory_order_relaxed)
+            == index)
+          break;
+      }
+      if (index < 0
+          || nowIndex - index
+               >= static_cast<int64_t>(window.size))
+        continue;
+      for (size_t i = 0; i < kStatsLevels; ++i)
+        counts.levelCount[i] += levels[i];
+    }
+  }
+  return result;
+}
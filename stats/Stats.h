@@ -0,0 +1,165 @@
+#pragma once  // Защита от повторного включения
+              // заголовочного файла
+
+#include <array>  // Для счётчиков по уровням
+#include <atomic>  // Для счётчиков шарда и seqlock
+#include <cstddef>  // Для std::size_t
+#include <cstdint>  // Для std::uint64_t
+#include <ctime>  // Для time_t
+#include <memory>  // Для корзин окон
+#include <string>  // Для разбора окон
+#include <vector>  // Для набора окон
+
+#include "Histogram.h"  // Для распределений длин и задержек
+#include "logger/LogLevel.h"  // Уровни клиента (кадры)
+
+// Уровень сообщения в статистике сервера: уровни логгера и
+// то, что определяется только по тексту
+enum class StatsLevel : std::uint8_t {
+  Error,
+  Warning,
+  Info,
+  Debug,
+  Unknown,
+  Count  // Число уровней (не уровень)
+};
+
+constexpr std::size_t kStatsLevels
+  = static_cast<std::size_t>(StatsLevel::Count);
+
+// Имя уровня для отчёта: "ERROR", ..., "unknown"
+const char *statsLevelName(StatsLevel level);
+
+// Уровень кадра (значение LogLevel клиента)
+StatsLevel statsLevel(logger::LogLevel level);
+
+// Скользящее окно счётчиков: кольцо корзин шириной step
+// секунд, покрывающее последние seconds секунд. Точность
+// окна — одна корзина
+struct RateWindow {
+  std::int64_t seconds = 0;  // Длина окна
+  std::int64_t step = 1;  // Ширина корзины
+
+  // Число корзин в кольце
+  std::size_t buckets() const {
+    return static_cast<std::size_t>(
+      (seconds + step - 1) / step);
+  }
+};
+
+// Окна по умолчанию: минута (корзины по 1 с), час (по
+// 10 с) и сутки (по 4 мин)
+std::vector<RateWindow> defaultRateWindows();
+
+// Разбирает список окон "60,3600/10,86400": длина в
+// секундах и, через '/', ширина корзины. Без ширины
+// корзин не больше 360. false при ошибке
+bool parseRateWindows(const std::string &spec,
+                      std::vector<RateWindow> &out);
+
+// Короткое имя длины окна: "1m", "1h", "1d", "90s"
+std::string rateWindowName(std::int64_t seconds);
+
+// Сообщения окна по уровням
+struct WindowCounts {
+  RateWindow window;  // Окно
+  std::array<std::uint64_t, kStatsLevels>
+    levelCount{};  // Сообщений по уровням
+
+  // Всего сообщений в окне
+  std::uint64_t total() const;
+};
+
+// Сводная статистика: снимок одного шарда или слияние
+// снимков всех шардов
+struct StatsSnapshot {
+  std::uint64_t totalMessages = 0;  // Всего сообщений
+  std::array<std::uint64_t, kStatsLevels>
+    levelCount{};  // Сообщений по уровням
+  std::size_t minLen = SIZE_MAX;  // Минимальная длина
+  std::size_t maxLen = 0;  // Максимальная длина
+  std::size_t totalLen = 0;  // Суммарная длина
+  Histogram lengths;  // Распределение длин
+  Histogram latency;  // Задержки кадров, мкс
+  std::vector<WindowCounts> windows;  // Скользящие окна
+
+  // Добавляет статистику другого шарда (с теми же окнами)
+  void merge(const StatsSnapshot &other);
+};
+
+// Счётчики одного реактора без блокировок. Писатель один —
+// поток своего реактора; итоги (всего, по уровням, длины)
+// он обновляет внутри seqlock (нечётный номер версии —
+// идёт запись). Поток отчёта читает их в любой момент и
+// повторяет чтение, если версия изменилась, поэтому итоги
+// снимка согласованы (всего сообщений = сумме по уровням),
+// а приём не останавливается. Шард выровнен на линию
+// кэша, чтобы счётчики соседних реакторов не делили линию.
+//
+// Счётчики за последние минуту, час, сутки и т. п.
+// ведутся по уровням в кольцах корзин фиксированного
+// размера (RateWindow), поэтому память шарда и стоимость
+// отчёта не зависят от числа принятых сообщений. Так же
+// устроены распределения длин и задержек: счётчики корзин
+// Histogram, из которых снимок строит гистограммы для
+// процентилей. Этих счётчиков тысячи, поэтому они вне
+// seqlock: снимок читает их после итогов, и они включают
+// все учтённые в итогах сообщения и, возможно, несколько
+// принятых за время чтения.
+class alignas(64) StatsShard {
+ public:
+  explicit StatsShard(
+    std::vector<RateWindow> windows = defaultRateWindows());
+
+  // Учитывает сообщение длиной length байт со временем
+  // timestamp; latencyUs — задержка от записи кадра до
+  // обработки (меньше нуля — неизвестна, как у текстовых
+  // строк). Только из потока-владельца шарда
+  void add(StatsLevel level, std::size_t length,
+           time_t timestamp, std::int64_t latencyUs = -1);
+
+  // Согласованный снимок; окна отсчитываются от now.
+  // Можно вызывать из любого потока
+  StatsSnapshot snapshot(time_t now) const;
+
+ private:
+  using Counter = std::atomic<std::uint64_t>;
+
+  // Корзина окна: номер интервала (время / step) и
+  // счётчики уровней за него
+  struct Bucket {
+    std::atomic<std::int64_t> index{-1};  // Интервал (-1 —
+                                          // пустая)
+    std::array<Counter, kStatsLevels> levels;  // Счётчики
+  };
+
+  // Номер интервала корзины на время её обнуления
+  static constexpr std::int64_t kResetting = -2;
+
+  // Кольцо корзин одного окна
+  struct Window {
+    RateWindow spec;  // Длина и шаг
+    std::size_t size = 0;  // Число корзин
+    std::unique_ptr<Bucket[]> buckets;  // Кольцо
+  };
+
+  // Обновление счётчика единственным писателем (без
+  // атомарного чтения-изменения-записи)
+  static void bump(Counter &counter, std::uint64_t by) {
+    counter.store(counter.load(std::memory_order_relaxed)
+                    + by,
+                  std::memory_order_relaxed);
+  }
+
+  std::atomic<std::uint64_t> seq_{0};  // Версия (seqlock)
+  Counter total_{0};  // Всего сообщений
+  std::array<Counter, kStatsLevels> levels_;  // По уровням
+  Counter minLen_;  // Минимальная длина
+  Counter maxLen_{0};  // Максимальная длина
+  Counter totalLen_{0};  // Суммарная длина
+  std::array<Counter, Histogram::kBuckets>
+    lengths_;  // Корзины длин
+  std::array<Counter, Histogram::kBuckets>
+    latency_;  // Корзины задержек
+  std::vector<Window> windows_;  // Скользящие окна
+};
@@ -0,0 +1,271 @@
+#include "TemplateMiner.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+
+// Переменное слово шаблона
+constexpr string_view kWildcard = "<*>";
+
+inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+inline bool isHex(char c) {
+  return isDigit(c) || (c >= 'a' && c <= 'f')
+         || (c >= 'A' && c <= 'F');
+}
+
+// Число, время, id с цифрами или длинное
+// шестнадцатеричное слово ("deadbeefcafe")
+bool isVariable(string_view token) {
+  if (any_of(token.begin(), token.end(), isDigit))
+    return true;
+  return token.size() >= 8
+         && all_of(token.begin(), token.end(), isHex);
+}
+
+inline bool isSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+}  // namespace
+
+TemplateMiner::TemplateMiner(TemplateMinerOptions options)
+    : options_(options) {
+  // Слой длин и хотя бы один слой слов
+  options_.depth = max<size_t>(options_.depth, 3);
+  options_.maxChildren
+    = max<size_t>(options_.maxChildren, 1);
+  options_.maxTemplates
+    = max<size_t>(options_.maxTemplates, 1);
+  tokens_.reserve(kMaxTokens);
+}
+
+void TemplateMiner::tokenize(string_view line) {
+  tokens_.clear();
+  size_t pos = 0;
+  while (tokens_.size() < kMaxTokens) {
+    while (pos < line.size() && isSpace(line[pos]))
+      ++pos;
+    if (pos == line.size())
+      break;
+    size_t end = pos;
+    while (end < line.size() && !isSpace(line[end]))
+      ++end;
+    string_view text = line.substr(pos, end - pos);
+    tokens_.push_back({text, isVariable(text)});
+    pos = end;
+  }
+}
+
+TemplateMiner::Node *TemplateMiner::child(
+  Node *node, string_view token) {
+  auto &children = node->children;
+  auto it = lower_bound(
+    children.begin(), children.end(), token,
+    [](const unique_ptr<Node> &c, string_view key) {
+      return string_view(c->token) < key;
+    });
+  if (it != children.end() && (*it)->token == token)
+    return it->get();
+  // Слишком много разных слов на этом уровне — они,
+  // скорее всего, переменные
+  if (token != kWildcard
+      && children.size() >= options_.maxChildren)
+    return child(node, kWildcard);
+
+  auto created = make_unique<Node>();
+  created->parent = node;
+  created->token = string(token);
+  return children.insert(it, move(created))->get();
+}
+
+// Слой длин, затем первые depth - 2 слова (переменные —
+// в ветку "<*>")
+TemplateMiner::Node *TemplateMiner::findLeaf() {
+  size_t length = tokens_.size();
+  unique_ptr<Node> &top = lengths_[length];
+  if (!top) {
+    top = make_unique<Node>();
+    top->length = length;
+  }
+  Node *node = top.get();
+  size_t layers = min(options_.depth - 2, length);
+  for (size_t i = 0; i < layers; ++i)
+    node = child(node, tokens_[i].variable
+                         ? kWildcard
+                         : tokens_[i].text);
+  return node;
+}
+
+// Совпавшим считается слово, равное слову шаблона, или
+// переменное слово на месте "<*>"; при равенстве выбирается
+// шаблон с большим числом "<*>" (более общий)
+TemplateMiner::ClusterList::iterator TemplateMiner::match(
+  Node *leaf) {
+  auto best = clusters_.end();
+  size_t bestSame = 0;
+  size_t bestWild = 0;
+  for (ClusterList::iterator cluster : leaf->clusters) {
+    size_t same = 0;
+    size_t wild = 0;
+    for (size_t i = 0; i < tokens_.size(); ++i) {
+      const string &word = cluster->tokens[i];
+      if (word == kWildcard) {
+        ++wild;
+        if (tokens_[i].variable)
+          ++same;
+      } else if (!tokens_[i].variable
+                 && word == tokens_[i].text) {
+        ++same;
+      }
+    }
+    if (best == clusters_.end() || same > bestSame
+        || (same == bestSame && wild > bestWild)) {
+      best = cluster;
+      bestSame = same;
+      bestWild = wild;
+    }
+  }
+  if (best != clusters_.end()
+      && static_cast<double>(bestSame)
+           < options_.similarity
+               * static_cast<double>(tokens_.size()))
+    return clusters_.end();
+  return best;
+}
+
+void TemplateMiner::add(string_view line, time_t now) {
+  lock_guard<mutex> lock(mutex_);
+  tokenize(line);
+  if (tokens_.empty())
+    return;
+
+  Node *leaf = findLeaf();
+  auto cluster = match(leaf);
+  if (cluster != clusters_.end()) {
+    // Несовпавшие слова становятся переменными
+    for (size_t i = 0; i < tokens_.size(); ++i) {
+      string &word = cluster->tokens[i];
+      if (word != kWildcard
+          && (tokens_[i].variable
+              || word != tokens_[i].text))
+        word = string(kWildcard);
+    }
+    ++cluster->count;
+    cluster->lastSeen = now;
+    clusters_.splice(clusters_.begin(), clusters_, cluster);
+    return;
+  }
+
+  Cluster created;
+  created.tokens.reserve(tokens_.size());
+  for (const Token &token : tokens_)
+    created.tokens.emplace_back(
+      token.variable ? kWildcard : token.text);
+  created.count = 1;
+  created.lastSeen = now;
+  created.leaf = leaf;
+  clusters_.push_front(move(created));
+  leaf->clusters.push_back(clusters_.begin());
+  if (clusters_.size() > options_.maxTemplates)
+    evictOldest();
+}
+
+void TemplateMiner::evictOldest() {
+  auto oldest = prev(clusters_.end());
+  Node *leaf = oldest->leaf;
+  leaf->clusters.erase(find(leaf->clusters.begin(),
+                            leaf->clusters.end(), oldest));
+  clusters_.erase(oldest);
+  ++evicted_;
+  prune(leaf);
+}
+
+// Без этого ветки вытесненных шаблонов копились бы и
+// память росла бы с числом разных сообщений
+void TemplateMiner::prune(Node *node) {
+  while (node != nullptr && node->children.empty()
+         && node->clusters.empty()) {
+    Node *parent = node->parent;
+    if (parent == nullptr) {
+      lengths_.erase(node->length);
+    } else {
+      auto &siblings = parent->children;
+      siblings.erase(find_if(
+        siblings.begin(), siblings.end(),
+        [node](const unique_ptr<Node> &sibling) {
+          return sibling.get() == node;
+        }));
+    }
+    node = parent;
+  }
+}
+
+vector<TemplateStats> TemplateMiner::templates() const {
+  vector<TemplateStats> result;
+  {
+    lock_guard<mutex> lock(mutex_);
+    result.reserve(clusters_.size());
+    for (const Cluster &cluster : clusters_) {
+      TemplateStats stats;
+      for (const string &word : cluster.tokens) {
+        if (!stats.text.empty())
+          stats.text += ' ';
+        stats.text += word;
+      }
+      stats.count = cluster.count;
+      stats.lastSeen = cluster.lastSeen;
+      result.push_back(move(stats));
+    }
+  }
+  sort(result.begin(), result.end(),
+       [](const TemplateStats &a, const TemplateStats &b) {
+         return a.count > b.count;
+       });
+  return result;
+}
+
+size_t TemplateMiner::size() const {
+  lock_guard<mutex> lock(mutex_);
+  return clusters_.size();
+}
+
+uint64_t TemplateMiner::evicted() const {
+  lock_guard<mutex> lock(mutex_);
+  return evicted_;
+}
+
+vector<TemplateStats> mergeTemplates(
+  const vector<const TemplateMiner *> &miners, size_t k) {
+  unordered_map<string, TemplateStats> merged;
+  for (const TemplateMiner *miner : miners) {
+    for (TemplateStats &stats : miner->templates()) {
+      auto found = merged.find(stats.text);
+      if (found == merged.end()) {
+        string key = stats.text;
+        merged.emplace(move(key), move(stats));
+      } else {
+        found->second.count += stats.count;
+        found->second.lastSeen
+          = max(found->second.lastSeen, stats.lastSeen);
+      }
+    }
+  }
+  vector<TemplateStats> result;
+  result.reserve(merged.size());
+  for (auto &entry : merged)
+    result.push_back(move(entry.second));
+  // При равенстве — по тексту, чтобы порядок не зависел
+  // от хеш-таблицы
+  sort(result.begin(), result.end(),
+       [](const TemplateStats &a, const TemplateStats &b) {
+         if (a.count != b.count)
+           return a.count > b.count;
+         return a.text < b.text;
+       });
+  if (result.size() > k)
+    result.resize(k);
+  return result;
+}
@@ -0,0 +1,139 @@
+#pragma once  // Защита от повторного включения
+              // заголовочного файла
+
+#include <cstddef>  // Для std::size_t
+#include <cstdint>  // Для std::uint64_t
+#include <ctime>  // Для time_t
+#include <list>  // Для LRU шаблонов
+#include <memory>  // Для узлов дерева
+#include <mutex>  // Для мьютекса майнера
+#include <string>  // Для слов шаблонов
+#include <string_view>  // Для слов строки без копирования
+#include <unordered_map>  // Для слоя длин
+#include <vector>  // Для слов и детей узлов
+
+// Параметры поиска шаблонов
+struct TemplateMinerOptions {
+  std::size_t depth = 4;  // Глубина дерева: слой длин,
+                          // depth - 2 слоя первых слов и
+                          // лист
+  double similarity = 0.5;  // Доля совпавших слов, с
+                            // которой строка подходит
+                            // шаблону
+  std::size_t maxChildren = 100;  // Детей узла, дальше —
+                                  // в ветку "<*>"
+  std::size_t maxTemplates = 1000;  // Шаблонов в таблице,
+                                    // лишние вытесняются
+                                    // по LRU
+};
+
+// Шаблон сообщений для отчёта
+struct TemplateStats {
+  std::string text;  // Слова шаблона через пробел
+  std::uint64_t count = 0;  // Подошедших строк
+  time_t lastSeen = 0;  // Время последней из них
+};
+
+// Поиск шаблонов сообщений на лету (алгоритм Drain).
+// Строка делится на слова (string_view внутрь строки, без
+// копирования); слова с цифрами и длинные
+// шестнадцатеричные (числа, id, адреса) считаются
+// переменными "<*>". Дерево фиксированной глубины
+// выбирает группу кандидатов по числу слов и первым
+// словам, а среди них — шаблон с наибольшей долей
+// совпавших слов. Подошедшая строка обобщает шаблон
+// (несовпавшие слова становятся "<*>"), неподошедшая
+// заводит новый. Таблица ограничена maxTemplates:
+// давно не встречавшиеся шаблоны вытесняются, а пустые
+// ветки дерева удаляются.
+//
+// Пишет поток своего реактора, отчёт читает из любого
+// потока; оба берут мьютекс майнера, отчёт — только на
+// время копирования.
+class TemplateMiner {
+ public:
+  // Предел слов строки: остальные не учитываются
+  static constexpr std::size_t kMaxTokens = 64;
+
+  explicit TemplateMiner(
+    TemplateMinerOptions options = TemplateMinerOptions());
+
+  TemplateMiner(const TemplateMiner &) = delete;
+  TemplateMiner &operator=(const TemplateMiner &) = delete;
+
+  // Относит строку к шаблону. Только из потока-владельца
+  void add(std::string_view line, time_t now);
+
+  // Все шаблоны по убыванию числа строк
+  std::vector<TemplateStats> templates() const;
+
+  // Шаблонов в таблице
+  std::size_t size() const;
+
+  // Вытеснено шаблонов с начала работы
+  std::uint64_t evicted() const;
+
+ private:
+  struct Node;
+
+  // Шаблон
+  struct Cluster {
+    std::vector<std::string> tokens;  // Слова или "<*>"
+    std::uint64_t count = 0;  // Подошедших строк
+    time_t lastSeen = 0;  // Время последней
+    Node *leaf = nullptr;  // Лист, где лежит шаблон
+  };
+
+  using ClusterList = std::list<Cluster>;
+
+  // Узел дерева: слово (или длина в слое длин), дети по
+  // возрастанию слова и, у листа, шаблоны
+  struct Node {
+    Node *parent = nullptr;  // null — узел слоя длин
+    std::size_t length = 0;  // Число слов (слой длин)
+    std::string token;  // Слово ветки
+    std::vector<std::unique_ptr<Node>> children;  // Дети
+    std::vector<ClusterList::iterator>
+      clusters;  // Шаблоны листа
+  };
+
+  // Слово строки
+  struct Token {
+    std::string_view text;  // Текст
+    bool variable = false;  // Число, id и т. п.
+  };
+
+  // Разбивает строку на слова в tokens_
+  void tokenize(std::string_view line);
+
+  // Лист для слов tokens_ (создаётся при необходимости)
+  Node *findLeaf();
+
+  // Ребёнок узла со словом token; создаётся, если детей
+  // меньше maxChildren, иначе — ветка "<*>"
+  Node *child(Node *node, std::string_view token);
+
+  // Лучший подходящий шаблон листа для tokens_ или
+  // clusters_.end()
+  ClusterList::iterator match(Node *leaf);
+
+  // Вытесняет самый давний шаблон
+  void evictOldest();
+
+  // Удаляет опустевший узел и опустевших предков
+  void prune(Node *node);
+
+  TemplateMinerOptions options_;  // Параметры
+  std::unordered_map<std::size_t, std::unique_ptr<Node>>
+    lengths_;  // Слой длин
+  ClusterList clusters_;  // Шаблоны, недавние — в начале
+  std::uint64_t evicted_ = 0;  // Вытеснено шаблонов
+  std::vector<Token> tokens_;  // Слова текущей строки
+  mutable std::mutex mutex_;  // Мьютекс майнера
+};
+
+// Общие шаблоны нескольких майнеров (одинаковые шаблоны
+// складываются) — не больше k по убыванию числа строк
+std::vector<TemplateStats> mergeTemplates(
+  const std::vector<const TemplateMiner *> &miners,
+  std::size_t k);
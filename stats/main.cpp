@@ -1,220 +1,491 @@
-#include <errno.h>
-#include <netinet/in.h>
-#include <sys/socket.h>
-#include <unistd.h>
+#include <pthread.h>
+#include <signal.h>
 
 #include <algorithm>
 #include <atomic>
-#include <cctype>
 #include <chrono>
-#include <csignal>
-#include <cstring>
+#include <condition_variable>
+#include <deque>
 #include <iostream>
+#include <memory>
 #include <mutex>
+#include <sstream>
 #include <thread>
 #include <unordered_map>
 #include <vector>
 
-#include "logger/LogEntry.h"
+#include "EntryStore.h"
+#include "HeavyHitters.h"
+#include "LevelClassifier.h"
+#include "Listener.h"
+#include "LogIndex.h"
+#include "QueryServer.h"
+#include "Reactor.h"
+#include "Reporter.h"
+#include "Stats.h"
+#include "TemplateMiner.h"
+#include "logger/Endpoint.h"
 
-volatile std::sig_atomic_t stop_flag = 0;
+using namespace std;
 
-void signal_handler(int) { stop_flag = 1; }
+// Вывод на консоль (поток вывода)
+unique_ptr<Reporter> reporter;
 
-using namespace std;
+// Шарды статистики: по одному на реактор
+vector<unique_ptr<StatsShard>> shards;
 
-// Вектор для хранения всех полученных лог-записей
-vector<LogEntry> entries;
-// Мьютекс для синхронизации доступа к данным
-mutex m;
+// Хранилища сообщений: по одному на реактор
+vector<unique_ptr<EntryStore>> stores;
 
-// Общая статистика
-int totalMessages = 0;  // Общее количество сообщений
-unordered_map<string, int>
-  levelCount;  // Количество сообщений по уровням
-size_t minLen = SIZE_MAX;  // Минимальная длина сообщения
-size_t maxLen = 0;  // Максимальная длина сообщения
-size_t totalLen = 0;  // Суммарная длина всех сообщений
+// Частые сообщения: по одному трекеру на реактор (пусто,
+// если отключены)
+vector<unique_ptr<HeavyHitters>> hitters;
 
-bool updated
-  = false;  // Флаг, указывающий, что статистика обновлена
+// Сколько частых сообщений выводить в отчёте
+size_t topMessages = 10;
 
-// Функция вывода текущей статистики на экран
-void printStats() {
-  lock_guard<mutex> lock(
-    m);  // Блокируем доступ к общим данным
-
-  cout << "\n📊 Statistics:\n";
-  cout << "  Total messages: " << totalMessages << "\n";
-  cout << "  By level:\n";
-  for (auto &[lvl, count] : levelCount) {
-    cout << "    " << lvl << ": " << count << "\n";
+// Шаблоны сообщений: по одному майнеру на реактор (пусто,
+// если отключены)
+vector<unique_ptr<TemplateMiner>> miners;
+
+// Сколько шаблонов выводить в отчёте
+size_t topTemplates = 10;
+
+// Индексы для запросов: по одному на реактор (пусто, если
+// порт запросов не задан)
+vector<unique_ptr<LogIndex>> indexes;
+
+// Сообщений принято всеми реакторами (для вывода каждые N)
+atomic<uint64_t> received{0};
+
+// Флаг, указывающий, что статистика обновлена
+atomic<bool> updated{false};
+
+// Процентили распределения одной строкой; верхняя
+// граница корзины не выводится больше известного
+// максимума limit
+void printPercentiles(ostream &out,
+                      const Histogram &histogram,
+                      uint64_t limit = UINT64_MAX) {
+  const char *separator = "";
+  for (double percent : {50.0, 90.0, 99.0, 99.9}) {
+    out << separator << "p" << percent << " "
+        << min(histogram.percentile(percent), limit);
+    separator = ", ";
   }
+}
+
+// Функция вывода текущей статистики на экран: снимки
+// шардов (seqlock, приём не останавливается) сливаются в
+// общую картину, отчёт форматируется без блокировок и
+// выводится одной записью, чтобы не перемешаться с
+// другими. Вызывается только из потока отчётов
+void printStats() {
+  // Сбрасываем флаг обновления статистики
+  updated.store(false, memory_order_relaxed);
 
-  // Считаем количество сообщений за последний час
   time_t now = time(nullptr);
-  auto countLastHour
-    = count_if(entries.begin(), entries.end(),
-               [now](const LogEntry &e) {
-                 return now - e.timestamp <= 3600;
-               });
-  cout << "  Messages in last hour: " << countLastHour
-       << "\n";
+  StatsSnapshot total;
+  for (const auto &shard : shards)
+    total.merge(shard->snapshot(now));
+
+  ostringstream out;
+  out << "\n📊 Statistics:\n";
+  out << "  Total messages: " << total.totalMessages
+      << "\n";
+  out << "  By level:\n";
+  for (size_t i = 0; i < kStatsLevels; ++i) {
+    if (total.levelCount[i] > 0)
+      out << "    "
+          << statsLevelName(static_cast<StatsLevel>(i))
+          << ": " << total.levelCount[i] << "\n";
+  }
+  // Самые частые сообщения (оценки Count-Min Sketch
+  // сложены по реакторам)
+  if (!hitters.empty() && total.totalMessages > 0) {
+    vector<const HeavyHitters *> views;
+    for (const auto &tracker : hitters)
+      views.push_back(tracker.get());
+    vector<HeavyHitter> top
+      = mergeHeavyHitters(views, topMessages);
+    out << "  Top messages:\n";
+    for (const HeavyHitter &hitter : top) {
+      out << "    " << hitter.count << " ("
+          << hitter.count * 100 / total.totalMessages
+          << "%): " << hitter.sample << "\n";
+    }
+  }
+  // Самые частые шаблоны (одинаковые шаблоны реакторов
+  // сложены)
+  if (!miners.empty() && total.totalMessages > 0) {
+    vector<const TemplateMiner *> views;
+    size_t tracked = 0;
+    uint64_t evicted = 0;
+    for (const auto &miner : miners) {
+      views.push_back(miner.get());
+      tracked += miner->size();
+      evicted += miner->evicted();
+    }
+    out << "  Templates (" << tracked << " tracked, "
+        << evicted << " evicted):\n";
+    for (const TemplateStats &stats :
+         mergeTemplates(views, topTemplates)) {
+      out << "    " << stats.count << ", last "
+          << now - stats.lastSeen << "s ago: "
+          << stats.text << "\n";
+    }
+  }
+  // Скользящие окна: всего и по уровням
+  for (const WindowCounts &window : total.windows) {
+    out << "  Messages in last "
+        << rateWindowName(window.window.seconds) << ": "
+        << window.total();
+    const char *separator = " (";
+    for (size_t i = 0; i < kStatsLevels; ++i) {
+      if (window.levelCount[i] == 0)
+        continue;
+      out << separator
+          << statsLevelName(static_cast<StatsLevel>(i))
+          << ": " << window.levelCount[i];
+      separator = ", ";
+    }
+    out << (window.total() > 0 ? ")\n" : "\n");
+  }
 
   // Выводим статистику по длинам сообщений, если сообщения
   // есть
-  if (totalMessages > 0) {
-    cout << "  Lengths:\n";
-    cout << "    Min: " << minLen << "\n";
-    cout << "    Max: " << maxLen << "\n";
-    cout << "    Avg: " << totalLen / totalMessages << "\n";
+  if (total.totalMessages > 0) {
+    out << "  Lengths:\n";
+    out << "    Min: " << total.minLen << "\n";
+    out << "    Max: " << total.maxLen << "\n";
+    out << "    Avg: "
+        << total.totalLen / total.totalMessages << "\n";
+    out << "    Percentiles: ";
+    printPercentiles(out, total.lengths, total.maxLen);
+    out << "\n";
   }
 
-  updated = false;  // Сбрасываем флаг обновления статистики
+  // Задержка от записи кадра клиентом до обработки (у
+  // текстовых строк времени записи нет)
+  if (total.latency.count() > 0) {
+    out << "  Frame latency (us): ";
+    printPercentiles(out, total.latency);
+    out << " of " << total.latency.count() << " frames\n";
+  }
+
+  // Занятое хранилищами место
+  EntryStoreUsage stored;
+  for (const auto &store : stores) {
+    EntryStoreUsage usage = store->usage();
+    stored.memoryEntries += usage.memoryEntries;
+    stored.segments += usage.segments;
+    stored.diskBytes += usage.diskBytes;
+    stored.prunedSegments += usage.prunedSegments;
+  }
+  out << "  Stored: " << stored.memoryEntries
+      << " in memory, " << stored.segments
+      << " segments (" << stored.diskBytes
+      << " bytes) on disk, " << stored.prunedSegments
+      << " segments pruned\n";
+
+  // Опубликованные сегменты индексов
+  if (!indexes.empty()) {
+    LogIndexUsage indexed;
+    for (const auto &index : indexes) {
+      LogIndexUsage usage = index->usage();
+      indexed.entries += usage.entries;
+      indexed.segments += usage.segments;
+      indexed.bytes += usage.bytes;
+    }
+    out << "  Index: " << indexed.entries
+        << " entries in " << indexed.segments
+        << " segments (" << indexed.bytes << " bytes)\n";
+  }
+  reporter->post(Verbosity::Quiet, out.str());
 }
 
-// Функция таймера для периодического вывода статистики
-// каждые T секунд
+// Поток отчётов: запросы от приёма и остановка
+mutex timerMutex;
+condition_variable timerCv;
+bool reportDue = false;
+bool timerStop = false;
+
+// Функция потока отчётов: статистика каждые T секунд (если
+// обновилась) и по запросу приёма каждые N сообщений.
+// Отчёт собирается без timerMutex, так что приём, который
+// просит следующий, не ждёт текущий
 void statsTimer(int T) {
+  auto period = chrono::seconds(T);
+  auto deadline = chrono::steady_clock::now() + period;
+  unique_lock<mutex> lock(timerMutex);
   while (true) {
-    this_thread::sleep_for(chrono::seconds(T));
-    if (updated)
+    timerCv.wait_until(lock, deadline, [] {
+      return timerStop || reportDue;
+    });
+    if (timerStop)
+      break;
+    bool requested = reportDue;
+    reportDue = false;
+    auto now = chrono::steady_clock::now();
+    bool periodic = now >= deadline;
+    if (periodic)
+      deadline = now + period;
+    lock.unlock();
+
+    if (periodic) {
+      for (const auto &store : stores)
+        store->prune(time(nullptr));
+    }
+    if (requested || (periodic && updated))
       printStats();
+    lock.lock();
   }
 }
 
-// Функция определения уровня лог-сообщения по его
-// содержимому
-string determineLevel(const string &line) {
-  // Преобразуем строку в верхний регистр для удобного
-  // поиска
-  string upperLine = line;
-  transform(upperLine.begin(), upperLine.end(),
-            upperLine.begin(), ::toupper);
-
-  // Проверяем наличие ключевых слов, определяющих уровень
-  // логирования
-  if (upperLine.find("ERROR") != string::npos
-      || upperLine.find("ERR") != string::npos
-      || upperLine.find("FATAL") != string::npos)
-    return "ERROR";
-  else if (upperLine.find("WARNING") != string::npos
-           || upperLine.find("WARN") != string::npos
-           || upperLine.find("WRN") != string::npos)
-    return "WARNING";
-  else if (upperLine.find("INFO") != string::npos
-           || upperLine.find("INFORMATION") != string::npos)
-    return "INFO";
-  else if (upperLine.find("DEBUG") != string::npos
-           || upperLine.find("DBG") != string::npos
-           || upperLine.find("TRACE") != string::npos)
-    return "DEBUG";
-  else
-    return "unknown";  // Если не найден известный уровень
+// Поиск по истории хранилищ (кольцо и сегменты на диске):
+// читаются только блоки сегментов за период запроса,
+// каждая запись проверяется по тексту; от каждого
+// хранилища — не больше limit самых новых
+vector<IndexHit> searchStores(const IndexQuery &query) {
+  vector<IndexHit> hits;
+  for (const auto &store : stores) {
+    deque<IndexHit> found;
+    store->query(
+      query.from, query.to, [&](const StoredEntry &entry) {
+        if (matchesQuery(query, entry.timestamp,
+                         entry.level, entry.message)) {
+          found.push_back({0, entry.timestamp, entry.level,
+                           entry.message});
+          if (found.size() > query.limit)
+            found.pop_front();
+        }
+        return true;
+      });
+    move(found.begin(), found.end(), back_inserter(hits));
+  }
+  keepNewestHits(hits, query.limit);
+  return hits;
 }
 
-// Функция обработки одной строки лога
-void processLogLine(const string &line) {
-  if (line.empty())
-    return;
-
-  time_t now = time(nullptr);
-  string level = determineLevel(line);
-
-  // Выводим полученное сообщение с определённым уровнем
-  cout << "📝 [" << level << "] " << line << "\n";
-
-  lock_guard<mutex> lock(
-    m);  // Блокируем доступ к общим данным
-
-  // Сохраняем запись и обновляем статистику
-  entries.push_back({line, now, level});
-  levelCount[level]++;
-
-  totalMessages++;
-  minLen = min(minLen, line.size());
-  maxLen = max(maxLen, line.size());
-  totalLen += line.size();
-
-  updated = true;  // Помечаем, что статистика обновлена
+// Ответ на запрос: найденные сообщения по одному в строке
+// ("время [УРОВЕНЬ] текст", переводы строк текста
+// заменены пробелами) и итог "# N matches"; при ошибке —
+// "# error: причина". Вызывается из потока сервера
+// запросов
+string answerQuery(string_view text) {
+  IndexQuery query;
+  string error;
+  if (!parseIndexQuery(text, time(nullptr), query, error))
+    return "# error: " + error + "\n";
+
+  vector<IndexHit> hits;
+  if (query.source == QuerySource::Store) {
+    hits = searchStores(query);
+  } else {
+    vector<const LogIndex *> views;
+    for (const auto &index : indexes)
+      views.push_back(index.get());
+    hits = searchIndexes(views, query);
+  }
+  ostringstream out;
+  for (IndexHit &hit : hits) {
+    replace(hit.message.begin(), hit.message.end(), '\n',
+            ' ');
+    out << hit.timestamp << " ["
+        << statsLevelName(hit.level) << "] " << hit.message
+        << "\n";
+  }
+  out << "# " << hits.size() << " matches\n";
+  return out.str();
 }
 
-// Функция для обработки подключенного клиента
-void handleClient(int clientSock, int N) {
-  cout << "🔌 New client connected (socket: " << clientSock
-       << ")\n";
-
-  char buffer[1024];
-  string leftover;  // Буфер для хранения неполных данных
-                    // между recv
-
-  while (true) {
-    memset(buffer, 0, sizeof(buffer));  // Очищаем буфер
-
-    ssize_t bytes
-      = recv(clientSock, buffer, sizeof(buffer) - 1, 0);
+// Получатель сообщений реактора: учёт в его шарде
+// статистики, хранилище, трекере частых сообщений,
+// майнере шаблонов и индексе
+class StatsSink : public MessageSink {
+ public:
+  StatsSink(StatsShard &shard, EntryStore &store,
+            HeavyHitters *tracker, TemplateMiner *miner,
+            LogIndex *index, int N)
+      : shard_(shard),
+        store_(store),
+        tracker_(tracker),
+        miner_(miner),
+        index_(index),
+        N_(N) {}
+
+  // Функция обработки одной строки лога
+  void onLine(string_view line) override {
+    if (line.empty())
+      return;
+    // Майнеру шаблонов — текст без времени и уровня:
+    // иначе эти поля, переменные и общие для всех строк,
+    // сводят строки в одну ветку дерева и засчитываются
+    // как совпавшие слова
+    string_view message;
+    StatsLevel level = classifyMessage(line, message);
+    process(line, message, level, time(nullptr), -1);
+  }
 
-    cout << "DEBUG: recv returned " << bytes << " bytes\n";
+  // Уровень и время берутся из кадра, разбор текста не
+  // нужен. Время записи даёт задержку доставки (часы
+  // клиента впереди — считаем нулевой)
+  void onFrame(const logger::frame::Frame &frame) override {
+    int64_t nowNs
+      = chrono::duration_cast<chrono::nanoseconds>(
+          chrono::system_clock::now().time_since_epoch())
+          .count();
+    int64_t latencyUs
+      = max<int64_t>(0, nowNs - frame.timestampNs) / 1000;
+    process(frame.payload, frame.payload,
+            statsLevel(frame.level),
+            static_cast<time_t>(frame.timestampNs
+                                / 1000000000),
+            latencyUs);
+  }
 
-    if (bytes < 0) {
-      if (errno == EAGAIN || errno == EWOULDBLOCK) {
-        // Неблокирующий сокет: нет данных сейчас, пробуем
-        // снова
-        continue;
-      }
-      cout << "ERROR: recv failed: " << strerror(errno)
-           << "\n";
-      break;
-    }
+  void onConnect(int fd) override {
+    reporter->post(Verbosity::Normal,
+                   "🔌 New client connected (socket: ",
+                   to_string(fd), ")\n");
+  }
 
-    if (bytes == 0) {
-      cout << "INFO: Client closed connection gracefully\n";
-      // Обработка остатков данных, если есть
-      if (!leftover.empty()) {
-        processLogLine(leftover);
-        if (totalMessages % N == 0)
-          printStats();
-      }
-      break;
-    }
+  void onDisconnect(int fd) override {
+    reporter->post(Verbosity::Normal,
+                   "🔌 Client disconnected (socket: ",
+                   to_string(fd), ")\n");
+  }
 
-    // Обеспечиваем корректное завершение строки
-    buffer[bytes] = '\0';
-    leftover.append(buffer, bytes);
+  // События соединений — normal, ошибки выводятся всегда
+  void onNotice(string_view text, bool error) override {
+    reporter->post(
+      error ? Verbosity::Quiet : Verbosity::Normal, text,
+      "\n");
+  }
 
-    // Обработка всех полных строк (разделённых '\n')
-    size_t pos;
-    while ((pos = leftover.find('\n')) != string::npos) {
-      string line = leftover.substr(0, pos);
-      leftover.erase(0, pos + 1);
+  // Новые сообщения становятся видны запросам не позже
+  // чем через LogIndex::kPublishInterval (плюс такт
+  // реактора), даже если поток сообщений иссяк
+  void onTick() override {
+    if (index_ != nullptr)
+      index_->publishIfDue();
+  }
 
-      // Убираем возможный символ возврата каретки '\r' для
-      // Windows-совместимости
-      if (!line.empty() && line.back() == '\r') {
-        line.pop_back();
+ private:
+  // Учёт одного сообщения с известным уровнем и временем
+  // (latencyUs < 0 — задержка неизвестна); message — текст
+  // line без заголовка. Каждые N сообщений (по всем
+  // реакторам) поток отчётов выводит статистику
+  void process(string_view line, string_view message,
+               StatsLevel level, time_t now,
+               int64_t latencyUs) {
+    // Эхо сообщения с определённым уровнем (verbose)
+    reporter->post(Verbosity::Verbose, "📝 [",
+                   statsLevelName(level), "] ", line, "\n");
+
+    shard_.add(level, line.size(), now, latencyUs);
+    store_.append(now, level, line);
+    if (tracker_ != nullptr)
+      tracker_->add(line);
+    if (miner_ != nullptr)
+      miner_->add(message, now);
+    if (index_ != nullptr)
+      index_->add(now, level, line);
+    updated.store(true, memory_order_relaxed);
+
+    // fetch_add выдаёт каждому сообщению свой номер,
+    // поэтому отчёт на каждом N-м сообщении
+    // запрашивается ровно один раз при любом числе
+    // реакторов; сам отчёт собирает поток отчётов
+    // (запросы, пришедшие, пока он занят, объединяются)
+    uint64_t number
+      = received.fetch_add(1, memory_order_relaxed) + 1;
+    if (number % static_cast<uint64_t>(N_) == 0) {
+      {
+        lock_guard<mutex> lock(timerMutex);
+        reportDue = true;
       }
-
-      processLogLine(line);
-
-      // Печатаем статистику каждые N сообщений
-      if (totalMessages % N == 0)
-        printStats();
+      timerCv.notify_one();
     }
   }
 
-  cout << "🔌 Client disconnected (socket: " << clientSock
-       << ")\n";
-  close(clientSock);
+  StatsShard &shard_;  // Шард своего реактора
+  EntryStore &store_;  // Хранилище своего реактора
+  HeavyHitters *tracker_;  // Частые сообщения (или null)
+  TemplateMiner *miner_;  // Шаблоны сообщений (или null)
+  LogIndex *index_;  // Индекс для запросов (или null)
+  int N_;  // Печатать статистику каждые N сообщений
+};
+
+// Вывод справки по аргументам
+void printUsage(const char *program) {
+  cerr << "Usage: " << program
+       << " <port> <N> <T> [--reactors K] [--udp PORT]"
+          " [--unix PATH] [--unixgram PATH]"
+          " [--windows LIST] [--store DIR]"
+          " [--memory-entries N] [--retain-bytes BYTES]"
+          " [--retain-age SECONDS] [--line-buffer BYTES]"
+          " [--verbosity LEVEL] [--top K]"
+          " [--templates K] [--template-limit N]"
+          " [--query-port PORT] [--index-entries N]\n";
+  cerr << "  port: TCP port number to listen on\n";
+  cerr << "  N: Print stats every N messages\n";
+  cerr << "  T: Print stats every T seconds (if updated)\n";
+  cerr << "  --reactors K: Event loop threads, each with "
+          "its own SO_REUSEPORT listener (default 1)\n";
+  cerr << "  --udp PORT: Also receive datagrams on UDP "
+          "PORT\n";
+  cerr << "  --unix PATH: Also listen on AF_UNIX stream "
+          "socket PATH\n";
+  cerr << "  --unixgram PATH: Also receive datagrams on "
+          "AF_UNIX socket PATH\n";
+  cerr << "  --windows LIST: Sliding windows in seconds, "
+          "optionally with bucket width, e.g. "
+          "60/1,3600/10,86400 (default 60/1,3600/10,"
+          "86400/240)\n";
+  cerr << "  --store DIR: Spill entries evicted from "
+          "memory to segment files in DIR\n";
+  cerr << "  --memory-entries N: Recent entries kept in "
+          "memory (default 10000)\n";
+  cerr << "  --retain-bytes BYTES: Prune oldest segments "
+          "above BYTES on disk\n";
+  cerr << "  --retain-age SECONDS: Prune segments older "
+          "than SECONDS\n";
+  cerr << "  --line-buffer BYTES: Per-connection line "
+          "buffer, 1..16777216 (default 65536)\n";
+  cerr << "  --verbosity LEVEL: quiet (stats and errors), "
+          "normal (+ connections) or verbose (+ every "
+          "message, default)\n";
+  cerr << "  --top K: Most repeated messages to report, 0 "
+          "disables (default 10)\n";
+  cerr << "  --templates K: Most frequent message "
+          "templates to report, 0 disables (default 10)\n";
+  cerr << "  --template-limit N: Templates kept per event "
+          "loop, least recently seen evicted (default "
+          "1000)\n";
+  cerr << "  --query-port PORT: Answer index queries on "
+          "127.0.0.1:PORT, one query line per connection, "
+          "e.g. 'timeout OR refused level=error last=3600 "
+          "limit=20'; add source=store to search the "
+          "entry store history instead (default: "
+          "disabled)\n";
+  cerr << "  --index-entries N: Recent entries kept in the "
+          "index (default 100000)\n";
+}
+
+// Доля предела на один реактор с округлением вверх:
+// ненулевой предел не становится нулём, который для
+// хранилища значит «без предела», а для кольца — «не
+// хранить»
+uint64_t perReactor(uint64_t limit, int reactorCount) {
+  auto count = static_cast<uint64_t>(reactorCount);
+  return limit / count + (limit % count != 0 ? 1 : 0);
 }
 
 // Главная функция программы
 int main(int argc, char *argv[]) {
-  if (argc < 4) {
-    cerr << "Usage: " << argv[0] << " <port> <N> <T>\n";
-    cerr << "  port: Port number to listen on\n";
-    cerr << "  N: Print stats every N messages\n";
-    cerr
-      << "  T: Print stats every T seconds (if updated)\n";
+  if (argc < 4 || argc % 2 != 0) {
+    printUsage(argv[0]);
     return 1;
   }
 
@@ -222,101 +493,220 @@ int main(int argc, char *argv[]) {
   int port = stoi(argv[1]);
   int N = stoi(argv[2]);
   int T = stoi(argv[3]);
-
-  cout << "Starting log server with parameters:\n";
-  cout << "  Port: " << port << "\n";
-  cout << "  Stats every " << N << " messages\n";
-  cout << "  Auto-stats every " << T << " seconds\n\n";
-
-  // Запускаем поток таймера для периодического вывода
-  // статистики
-  thread timerThread(statsTimer, T);
-  timerThread.detach();
-
-  // Создаём TCP сокет
-  int server_fd = socket(AF_INET, SOCK_STREAM, 0);
-  if (server_fd == -1) {
-    perror("socket");
-    return 1;
+  int reactorCount = 1;
+  vector<RateWindow> windows = defaultRateWindows();
+  EntryStoreOptions storeOptions;
+  size_t lineBuffer = LineReader::kDefaultCapacity;
+  Verbosity verbosity = Verbosity::Verbose;
+  TemplateMinerOptions minerOptions;
+  int queryPort = -1;
+  size_t indexEntries = 100000;
+
+  // TCP слушается всегда, остальные транспорты — по флагам
+  vector<logger::Endpoint> endpoints{
+    logger::Endpoint::tcp("0.0.0.0", port)};
+  for (int i = 4; i + 1 < argc; i += 2) {
+    string flag = argv[i];
+    string value = argv[i + 1];
+    if (flag == "--reactors") {
+      reactorCount = max(1, stoi(value));
+    } else if (flag == "--windows") {
+      if (!parseRateWindows(value, windows)) {
+        cerr << "Invalid --windows: " << value << "\n";
+        return 1;
+      }
+    } else if (flag == "--store") {
+      storeOptions.directory = value;
+    } else if (flag == "--memory-entries") {
+      storeOptions.memoryEntries = stoul(value);
+    } else if (flag == "--retain-bytes") {
+      storeOptions.retentionBytes = stoull(value);
+    } else if (flag == "--retain-age") {
+      storeOptions.retentionSeconds = stoll(value);
+    } else if (flag == "--verbosity") {
+      if (!parseVerbosity(value, verbosity)) {
+        cerr << "Invalid --verbosity: " << value << "\n";
+        return 1;
+      }
+    } else if (flag == "--top") {
+      topMessages = stoul(value);
+    } else if (flag == "--templates") {
+      topTemplates = stoul(value);
+    } else if (flag == "--template-limit") {
+      minerOptions.maxTemplates
+        = max<size_t>(1, stoul(value));
+    } else if (flag == "--query-port") {
+      queryPort = stoi(value);
+    } else if (flag == "--index-entries") {
+      indexEntries = max<size_t>(1, stoul(value));
+    } else if (flag == "--line-buffer") {
+      lineBuffer = clamp<size_t>(stoul(value), 1,
+                                 LineReader::kMaxLine);
+    } else if (flag == "--udp") {
+      endpoints.push_back(
+        logger::Endpoint::udp("0.0.0.0", stoi(value)));
+    } else if (flag == "--unix") {
+      endpoints.push_back(
+        logger::Endpoint::unixStream(value));
+    } else if (flag == "--unixgram") {
+      endpoints.push_back(
+        logger::Endpoint::unixDatagram(value));
+    } else {
+      printUsage(argv[0]);
+      return 1;
+    }
   }
 
-  // Позволяем переиспользовать адрес, чтобы избежать ошибки
-  // "Address already in use"
-  int opt = 1;
-  if (setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, &opt,
-                 sizeof(opt))
-      < 0) {
-    perror("setsockopt");
-    close(server_fd);
-    return 1;
+  // SIGINT и SIGTERM блокируются до запуска потоков (маску
+  // наследуют все) и принимаются через sigwait в main —
+  // без обработчика и флага, который надо опрашивать
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+  // Дальше весь вывод идёт через поток вывода
+  reporter = make_unique<Reporter>(verbosity);
+
+  ostringstream banner;
+  banner << "Starting log server with parameters:\n";
+  banner << "  Port: " << port << "\n";
+  banner << "  Stats every " << N << " messages\n";
+  banner << "  Auto-stats every " << T << " seconds\n";
+  banner << "  Reactors: " << reactorCount << "\n";
+  banner << "  Windows:";
+  for (const RateWindow &window : windows)
+    banner << " " << rateWindowName(window.seconds) << "/"
+           << window.step << "s";
+  banner << "\n";
+  if (!storeOptions.directory.empty())
+    banner << "  Store: " << storeOptions.directory << "\n";
+  if (queryPort >= 0)
+    banner << "  Index: " << indexEntries
+           << " entries\n";
+  banner << "\n";
+  reporter->post(Verbosity::Quiet, banner.str());
+
+  // У каждого реактора свой шард статистики и свои
+  // сокеты TCP/UDP на общем порту (SO_REUSEPORT): ядро
+  // распределяет соединения и датаграммы между ними, так
+  // что реакторы не делят ни сокетов, ни счётчиков.
+  // Файл сокета AF_UNIX нельзя привязать дважды — такие
+  // адреса обслуживает первый реактор. Хранилища тоже
+  // свои: сегменты реактора r лежат в DIR/r, а память и
+  // ограничение по байтам делятся поровну (с округлением
+  // вверх), как и сообщения индекса
+  vector<unique_ptr<StatsSink>> sinks;
+  vector<unique_ptr<Reactor>> reactors;
+  for (int r = 0; r < reactorCount; ++r) {
+    EntryStoreOptions options = storeOptions;
+    options.memoryEntries = static_cast<size_t>(
+      perReactor(options.memoryEntries, reactorCount));
+    options.retentionBytes
+      = perReactor(options.retentionBytes, reactorCount);
+    if (!options.directory.empty())
+      options.directory += "/" + to_string(r);
+    stores.push_back(make_unique<EntryStore>(options));
+    if (!stores[r]->open())
+      return 1;
+
+    // Лидеров отслеживается вдвое больше, чем выводится,
+    // чтобы у границы списка было меньше случайных
+    if (topMessages > 0)
+      hitters.push_back(
+        make_unique<HeavyHitters>(2 * topMessages));
+    if (topTemplates > 0)
+      miners.push_back(
+        make_unique<TemplateMiner>(minerOptions));
+    if (queryPort >= 0)
+      indexes.push_back(
+        make_unique<LogIndex>(static_cast<size_t>(
+          perReactor(indexEntries, reactorCount))));
+    shards.push_back(make_unique<StatsShard>(windows));
+    sinks.push_back(make_unique<StatsSink>(
+      *shards[r], *stores[r],
+      hitters.empty() ? nullptr : hitters[r].get(),
+      miners.empty() ? nullptr : miners[r].get(),
+      indexes.empty() ? nullptr : indexes[r].get(), N));
+    reactors.push_back(
+      make_unique<Reactor>(*sinks[r], lineBuffer));
+    for (logger::Endpoint &endpoint : endpoints) {
+      if (r > 0 && !endpoint.isInet())
+        continue;
+      int fd = openListener(endpoint, reactorCount > 1);
+      if (fd < 0
+          || !reactors[r]->addListener(fd,
+                                       endpoint.isStream()))
+        return 1;
+      if (endpoint.isInet() && endpoint.port == 0)
+        endpoint.port = boundPort(fd);  // Общий для всех
+      if (r == 0)
+        reporter->post(
+          Verbosity::Quiet,
+          "🟢 Log statistics server listening on ",
+          logger::toString(endpoint), "...\n");
+    }
   }
 
-  // Настраиваем адрес и порт для привязки
-  sockaddr_in address{};
-  address.sin_family = AF_INET;
-  address.sin_addr.s_addr
-    = INADDR_ANY;  // Привязываемся ко всем интерфейсам
-  address.sin_port = htons(static_cast<uint16_t>(port));
-
-  // Привязываем сокет к адресу
-  if (bind(server_fd, (struct sockaddr *)&address,
-           sizeof(address))
-      < 0) {
-    perror("bind");
-    close(server_fd);
-    return 1;
+  // Запросы принимаются только с локального адреса:
+  // протокол без аутентификации
+  unique_ptr<QueryServer> queryServer;
+  if (queryPort >= 0) {
+    logger::Endpoint endpoint
+      = logger::Endpoint::tcp("127.0.0.1", queryPort);
+    int fd = openListener(endpoint, false);
+    if (fd < 0)
+      return 1;
+    if (endpoint.port == 0)
+      endpoint.port = boundPort(fd);
+    queryServer = make_unique<QueryServer>(fd, answerQuery);
+    reporter->post(Verbosity::Quiet,
+                   "🔎 Query server listening on ",
+                   logger::toString(endpoint), "...\n");
   }
 
-  // Установка обработчиков сигналов для корректного
-  // завершения
-  std::signal(SIGINT, signal_handler);
-  std::signal(SIGTERM, signal_handler);
-
-  // Начинаем слушать входящие подключения с очередью до 10
-  // соединений
-  if (listen(server_fd, 10) < 0) {
-    perror("listen");
-    close(server_fd);
-    return 1;
+  // Фиксированный набор потоков: реакторы принимают и
+  // читают соединения, таймер печатает статистику, сервер
+  // запросов отвечает на запросы к индексам
+  vector<thread> reactorThreads;
+  for (auto &reactor : reactors)
+    reactorThreads.emplace_back(&Reactor::run,
+                                reactor.get());
+  thread timerThread(statsTimer, T);
+  thread queryThread;
+  if (queryServer)
+    queryThread
+      = thread(&QueryServer::run, queryServer.get());
+
+  int sig = 0;
+  sigwait(&signals, &sig);
+  reporter->post(Verbosity::Quiet, "Shutting down (signal ",
+                 to_string(sig), ")...\n");
+
+  if (queryServer) {
+    queryServer->stop();
+    queryThread.join();
   }
-
-  // Установка таймаута 1 секунда для accept
-  struct timeval tv;
-  tv.tv_sec = 1;
-  tv.tv_usec = 0;
-  if (setsockopt(server_fd, SOL_SOCKET, SO_RCVTIMEO,
-                 (const char *)&tv, sizeof(tv))
-      < 0) {
-    perror("setsockopt SO_RCVTIMEO failed");
-    close(server_fd);
-    return 1;
+  for (auto &reactor : reactors)
+    reactor->stop();
+  for (thread &reactorThread : reactorThreads)
+    reactorThread.join();
+  {
+    lock_guard<mutex> lock(timerMutex);
+    timerStop = true;
   }
+  timerCv.notify_one();
+  timerThread.join();
 
-  cout << "🟢 Log statistics server listening on port "
-       << port << "...\n";
-
-  // Основной цикл принятия входящих соединений
-  while (!stop_flag) {
-    socklen_t addrlen = sizeof(address);
-    int clientSock = accept(
-      server_fd, (struct sockaddr *)&address, &addrlen);
-    if (clientSock < 0) {
-      if (errno == EAGAIN || errno == EWOULDBLOCK) {
-        // Таймаут accept — просто пробуем снова
-        continue;
-      }
-      if (stop_flag)
-        break;  // прерываем цикл при сигнале
-      perror("accept");
-      continue;
-    }
-    // Создаём новый поток для обработки клиента
-    thread clientThread(handleClient, clientSock, N);
-    clientThread.detach();
-  }
+  for (const logger::Endpoint &endpoint : endpoints)
+    removeListener(endpoint);
+
+  // Хранилища сбрасывают кольца в сегменты
+  stores.clear();
 
-  // После выхода из цикла - закрываем сокет
-  close(server_fd);
+  // Поток вывода допечатывает очередь и завершается
+  reporter.reset();
 
   return 0;
 }
@@ -0,0 +1,217 @@
+#include <gtest/gtest.h>
+
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "logger/AsyncLogger.h"
+#include "logger/Logger.h"
+
+using namespace logger;
+
+namespace {
+
+// Тестовый приёмник: запоминает полученные сообщения и
+// может удерживать рабочий поток (имитация медленного
+// диска)
+class BlockingSink : public ILogger {
+ public:
+  void log(const std::string &message,
+           LogLevel level) override {
+    std::unique_lock<std::mutex> lock(m_);
+    entered_ = true;
+    cv_.notify_all();
+    cv_.wait(lock, [this] { return open_; });
+    received_.push_back(LogMessage{message, level});
+  }
+
+  void setLogLevel(LogLevel level) override {
+    level_ = level;
+  }
+  LogLevel getLogLevel() const override { return level_; }
+
+  // Ждёт, пока рабочий поток не зайдёт в log()
+  void waitEntered() {
+    std::unique_lock<std::mutex> lock(m_);
+    cv_.wait(lock, [this] { return entered_; });
+  }
+
+  // Отпускает рабочий поток
+  void open() {
+    std::lock_guard<std::mutex> lock(m_);
+    open_ = true;
+    cv_.notify_all();
+  }
+
+  std::vector<std::string> texts() {
+    std::lock_guard<std::mutex> lock(m_);
+    std::vector<std::string> result;
+    for (auto &msg : received_)
+      result.push_back(msg.text);
+    return result;
+  }
+
+ private:
+  std::mutex m_;
+  std::condition_variable cv_;
+  bool entered_ = false;
+  bool open_ = false;
+  LogLevel level_ = LogLevel::Info;
+  std::vector<LogMessage> received_;
+};
+
+// Создаёт AsyncLogger над BlockingSink, рабочий поток
+// которого уже удерживается на сообщении "held"
+std::unique_ptr<AsyncLogger> makeStalled(
+  BlockingSink *&sink, AsyncLoggerOptions options) {
+  auto owned = std::make_unique<BlockingSink>();
+  sink = owned.get();
+  auto async = std::make_unique<AsyncLogger>(
+    std::move(owned), options);
+  async->log("held", LogLevel::Info);
+  sink->waitEntered();
+  return async;
+}
+
+}  // namespace
+
+// DropNewest: при заполненной очереди новые сообщения
+// отбрасываются и учитываются в счётчике
+TEST(AsyncLoggerTest, DropNewest) {
+  BlockingSink *sink = nullptr;
+  AsyncLoggerOptions options;
+  options.capacity = 2;
+  options.policy = OverflowPolicy::DropNewest;
+  auto async = makeStalled(sink, options);
+
+  async->log("a", LogLevel::Info);
+  async->log("b", LogLevel::Info);
+  async->log("c", LogLevel::Error);  // Очередь заполнена
+  EXPECT_EQ(async->droppedCount(), 1u);
+  EXPECT_EQ(async->droppedCount(LogLevel::Error), 1u);
+
+  sink->open();
+  async->flush();
+  EXPECT_EQ(sink->texts(),
+            (std::vector<std::string>{"held", "a", "b"}));
+}
+
+// DropOldest: новое сообщение вытесняет самое старое
+TEST(AsyncLoggerTest, DropOldest) {
+  BlockingSink *sink = nullptr;
+  AsyncLoggerOptions options;
+  options.capacity = 2;
+  options.policy = OverflowPolicy::DropOldest;
+  auto async = makeStalled(sink, options);
+
+  async->log("a", LogLevel::Info);
+  async->log("b", LogLevel::Info);
+  async->log("c", LogLevel::Info);
+  EXPECT_EQ(async->droppedCount(LogLevel::Info), 1u);
+
+  sink->open();
+  async->flush();
+  EXPECT_EQ(sink->texts(),
+            (std::vector<std::string>{"held", "b", "c"}));
+}
+
+// Нулевая ёмкость считается единичной
+TEST(AsyncLoggerTest, ZeroCapacityHoldsOneMessage) {
+  BlockingSink *sink = nullptr;
+  AsyncLoggerOptions options;
+  options.capacity = 0;
+  options.policy = OverflowPolicy::DropOldest;
+  auto async = makeStalled(sink, options);
+
+  async->log("a", LogLevel::Info);
+  async->log("b", LogLevel::Info);
+  EXPECT_EQ(async->droppedCount(), 1u);
+
+  sink->open();
+  async->flush();
+  EXPECT_EQ(sink->texts(),
+            (std::vector<std::string>{"held", "b"}));
+}
+
+// Нулевая пачка считается единичной: рабочий поток
+// доставляет всё, flush() и деструктор не зависают
+TEST(AsyncLoggerTest, ZeroBatchStillDrains) {
+  BlockingSink *sink = nullptr;
+  AsyncLoggerOptions options;
+  options.maxBatch = 0;
+  auto async = makeStalled(sink, options);
+
+  async->log("a", LogLevel::Info);
+  async->log("b", LogLevel::Info);
+  sink->open();
+  async->flush();
+  EXPECT_EQ(sink->texts(),
+            (std::vector<std::string>{"held", "a", "b"}));
+}
+
+// DropBelowLevel: при переполнении отбрасываются только
+// сообщения ниже порога, важные ждут места
+TEST(AsyncLoggerTest, DropBelowLevel) {
+  BlockingSink *sink = nullptr;
+  AsyncLoggerOptions options;
+  options.capacity = 1;
+  options.policy = OverflowPolicy::DropBelowLevel;
+  options.dropLevel = LogLevel::Warning;
+  auto async = makeStalled(sink, options);
+
+  async->log("a", LogLevel::Info);
+  async->log("info", LogLevel::Info);  // Отброшено
+  EXPECT_EQ(async->droppedCount(LogLevel::Info), 1u);
+
+  // Error блокируется до освобождения места
+  std::thread producer(
+    [&] { async->log("error", LogLevel::Error); });
+  sink->open();
+  producer.join();
+  async->flush();
+
+  EXPECT_EQ(async->droppedCount(LogLevel::Error), 0u);
+  EXPECT_EQ(
+    sink->texts(),
+    (std::vector<std::string>{"held", "a", "error"}));
+}
+
+// Block: ничего не теряется, сообщения ниже уровня не
+// попадают в очередь; запись в файл через Logger
+TEST(AsyncLoggerTest, BlockWritesThroughLogger) {
+  std::string filename
+    = std::string(LOG_DIR) + "/test_async.log";
+  std::remove(filename.c_str());
+  {
+    AsyncLoggerOptions options;
+    options.capacity = 4;
+    AsyncLogger async(
+      std::make_unique<Logger>(filename, LogLevel::Warning),
+      options);
+    EXPECT_EQ(async.getLogLevel(), LogLevel::Warning);
+
+    for (int i = 0; i < 100; ++i) {
+      async.log("line " + std::to_string(i),
+                LogLevel::Error);
+    }
+    async.log("hidden", LogLevel::Info);
+    async.flush();
+    EXPECT_EQ(async.droppedCount(), 0u);
+  }
+
+  std::ifstream file(filename);
+  ASSERT_TRUE(file.is_open());
+  std::string content(
+    (std::istreambuf_iterator<char>(file)),
+    std::istreambuf_iterator<char>());
+  EXPECT_NE(content.find("[ERROR] line 0\n"),
+            std::string::npos);
+  EXPECT_NE(content.find("[ERROR] line 99\n"),
+            std::string::npos);
+  EXPECT_EQ(content.find("hidden"), std::string::npos);
+}
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "logger/BinaryLogDecoder.h"
+#include "logger/BinaryLogger.h"
+
+using namespace logger;
+
+namespace {
+
+// Декодирует двоичный лог и возвращает строки без меток
+// времени (начиная с "[LEVEL]")
+std::vector<std::string> decodeFile(const std::string &filename,
+                                    long *decoded = nullptr) {
+  std::ifstream in(filename, std::ios::binary);
+  std::ostringstream out;
+  std::string error;
+  long count = decodeBinaryLog(in, out, &error);
+  EXPECT_GE(count, 0) << error;
+  if (decoded != nullptr)
+    *decoded = count;
+
+  std::vector<std::string> lines;
+  std::istringstream text(out.str());
+  std::string line;
+  while (std::getline(text, line)) {
+    std::size_t level = line.find("] [");
+    lines.push_back(level == std::string::npos
+                      ? line
+                      : line.substr(level + 2));
+  }
+  return lines;
+}
+
+}  // namespace
+
+// Сообщения с аргументами разных типов и обычные строки
+// восстанавливаются декодером; фильтр уровня работает
+TEST(BinaryLoggerTest, EncodesAndDecodes) {
+  std::string filename
+    = std::string(LOG_DIR) + "/test_binary.bin";
+  {
+    BinaryLogger logger(filename, LogLevel::Warning);
+    for (int i = 0; i < 2; ++i) {
+      LOGGER_BINARY_LOG(logger, LogLevel::Error,
+                        "request {} took {} ms from {}", i, 1.5,
+                        std::string("host"));
+    }
+    LOGGER_BINARY_LOG(logger, LogLevel::Info, "hidden {}", 1);
+    logger.log("plain {} text", LogLevel::Warning);
+    logger.log("hidden plain", LogLevel::Info);
+    logger.logf(LogLevel::Error, "unsigned {} char {}", 7u, 'x');
+  }
+
+  long decoded = 0;
+  std::vector<std::string> lines = decodeFile(filename, &decoded);
+  ASSERT_EQ(decoded, 4);
+  ASSERT_EQ(lines.size(), 4u);
+  EXPECT_EQ(lines[0], "[ERROR] request 0 took 1.5 ms from host");
+  EXPECT_EQ(lines[1], "[ERROR] request 1 took 1.5 ms from host");
+  EXPECT_EQ(lines[2], "[WARNING] plain {} text");
+  EXPECT_EQ(lines[3], "[ERROR] unsigned 7 char x");
+}
+
+// Обрезанный хвост файла (аварийное завершение) не мешает
+// декодировать полные записи; чужой файл отклоняется
+TEST(BinaryLoggerTest, ToleratesTruncatedTail) {
+  std::string filename
+    = std::string(LOG_DIR) + "/test_binary_tail.bin";
+  {
+    BinaryLogger logger(filename);
+    LOGGER_BINARY_LOG(logger, LogLevel::Warning, "value {}", 42);
+    LOGGER_BINARY_LOG(logger, LogLevel::Warning, "value {}", 43);
+  }
+
+  std::ifstream in(filename, std::ios::binary);
+  std::string bytes((std::istreambuf_iterator<char>(in)),
+                    std::istreambuf_iterator<char>());
+  {
+    std::ofstream out(filename,
+                      std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(),
+              static_cast<std::streamsize>(bytes.size() - 3));
+  }
+
+  std::vector<std::string> lines = decodeFile(filename);
+  ASSERT_EQ(lines.size(), 1u);
+  EXPECT_EQ(lines[0], "[WARNING] value 42");
+
+  std::istringstream garbage("not a log");
+  std::ostringstream sink;
+  std::string error;
+  EXPECT_EQ(decodeBinaryLog(garbage, sink, &error), -1);
+  EXPECT_FALSE(error.empty());
+}
+
+// Строки длиннее 65535 байт не обрезаются
+TEST(BinaryLoggerTest, KeepsLongStrings) {
+  std::string filename
+    = std::string(LOG_DIR) + "/test_binary_long.bin";
+  std::string text(70000, 'x');
+  text.back() = 'y';
+  {
+    BinaryLogger logger(filename);
+    logger.log(text, LogLevel::Info);
+    LOGGER_BINARY_LOG(logger, LogLevel::Info, "long {} end",
+                      text);
+  }
+
+  std::vector<std::string> lines = decodeFile(filename);
+  ASSERT_EQ(lines.size(), 2u);
+  EXPECT_EQ(lines[0], "[INFO] " + text);
+  EXPECT_EQ(lines[1], "[INFO] long " + text + " end");
+}
+
+// Длина из повреждённого файла не выделяет гигабайты, а
+// даёт ошибку; файл старой версии отклоняется
+TEST(BinaryLoggerTest, RejectsCorruptedLengths) {
+  std::string bytes(binlog::kBinaryLogMagic,
+                    sizeof(binlog::kBinaryLogMagic));
+  bytes += static_cast<char>(binlog::kEntryRecord);
+  binlog::appendRaw(bytes, binlog::kPlainMessageFormat);
+  bytes += static_cast<char>(LogLevel::Info);
+  binlog::appendRaw(bytes, std::int64_t{0});
+  binlog::appendRaw(bytes, std::uint32_t{0xFFFFFFF0});
+
+  std::istringstream corrupted(bytes);
+  std::ostringstream sink;
+  std::string error;
+  EXPECT_EQ(decodeBinaryLog(corrupted, sink, &error), -1);
+  EXPECT_NE(error.find("length"), std::string::npos);
+
+  bytes[5] = '1';
+  std::istringstream old(bytes);
+  EXPECT_EQ(decodeBinaryLog(old, sink, &error), -1);
+  EXPECT_NE(error.find("version"), std::string::npos);
+}
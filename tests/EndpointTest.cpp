@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+
+#include <sys/un.h>
+
+#include <string>
+
+#include "logger/Endpoint.h"
+
+using namespace logger;
+
+// Разбор всех схем и обратное преобразование в строку
+TEST(EndpointTest, ParsesSchemes) {
+  Endpoint e;
+  ASSERT_TRUE(parseEndpoint("tcp://10.0.0.1:6000", e));
+  EXPECT_EQ(e.transport, Transport::Tcp);
+  EXPECT_EQ(e.host, "10.0.0.1");
+  EXPECT_EQ(e.port, 6000);
+  EXPECT_TRUE(e.isStream());
+
+  ASSERT_TRUE(parseEndpoint("udp://127.0.0.1:5001", e));
+  EXPECT_EQ(e.transport, Transport::Udp);
+  EXPECT_FALSE(e.isStream());
+
+  ASSERT_TRUE(parseEndpoint("unix:/tmp/log.sock", e));
+  EXPECT_EQ(e.transport, Transport::UnixStream);
+  EXPECT_EQ(e.path, "/tmp/log.sock");
+
+  ASSERT_TRUE(parseEndpoint("unixgram:/tmp/log.dgram", e));
+  EXPECT_EQ(e.transport, Transport::UnixDatagram);
+  EXPECT_FALSE(e.isInet());
+
+  for (const char *spec :
+       {"tcp://127.0.0.1:5000", "udp://127.0.0.1:9",
+        "unix:/run/a.sock", "unixgram:rel.sock"}) {
+    ASSERT_TRUE(parseEndpoint(spec, e)) << spec;
+    EXPECT_EQ(toString(e), spec);
+  }
+}
+
+// Ошибочные строки не меняют результат; длинный путь не
+// помещается в sockaddr_un
+TEST(EndpointTest, RejectsBadAddresses) {
+  Endpoint e = Endpoint::unixStream("/keep");
+  EXPECT_FALSE(parseEndpoint("socket", e));
+  EXPECT_FALSE(parseEndpoint("tcp://127.0.0.1", e));
+  EXPECT_FALSE(parseEndpoint("tcp://:5000", e));
+  EXPECT_FALSE(parseEndpoint("udp://host:70000", e));
+  EXPECT_FALSE(parseEndpoint("unix:", e));
+  EXPECT_EQ(e.path, "/keep");
+
+  sockaddr_storage addr{};
+  socklen_t len = 0;
+  EXPECT_TRUE(toSockaddr(e, addr, len));
+  std::string longPath(sizeof(sockaddr_un::sun_path), 'x');
+  EXPECT_FALSE(
+    toSockaddr(Endpoint::unixStream(longPath), addr, len));
+  EXPECT_FALSE(
+    toSockaddr(Endpoint::tcp("localhost", 1), addr, len));
+}
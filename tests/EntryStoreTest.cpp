@@ -0,0 +1,198 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "EntryStore.h"
+
+namespace {
+
+// Пустой каталог хранилища для теста
+std::string freshDir(const std::string &name) {
+  std::string dir = std::string(LOG_DIR) + "/" + name;
+  std::filesystem::remove_all(dir);
+  return dir;
+}
+
+// Все сообщения хранилища за период
+std::vector<StoredEntry> collect(EntryStore &store,
+                                 time_t from, time_t to) {
+  std::vector<StoredEntry> result;
+  store.query(from, to, [&](const StoredEntry &entry) {
+    result.push_back(entry);
+    return true;
+  });
+  return result;
+}
+
+const time_t kBase = 1700000000;
+
+}  // namespace
+
+// Вытесненные из кольца сообщения уходят в сегменты, а
+// запрос видит всю историю в порядке приёма
+TEST(EntryStoreTest, SpillsToSegmentsAndQueriesInOrder) {
+  EntryStoreOptions options;
+  options.directory = freshDir("store_spill");
+  options.memoryEntries = 10;
+  options.segmentBytes = 1024;
+  EntryStore store(options);
+  ASSERT_TRUE(store.open());
+
+  for (int i = 0; i < 500; ++i)
+    store.append(kBase + i,
+                 i % 2 ? StatsLevel::Info
+                       : StatsLevel::Error,
+                 "message " + std::to_string(i));
+
+  EntryStoreUsage usage = store.usage();
+  EXPECT_EQ(usage.memoryEntries, 10u);
+  EXPECT_GT(usage.segments, 5u);
+
+  std::vector<StoredEntry> all
+    = collect(store, kBase, kBase + 1000);
+  ASSERT_EQ(all.size(), 500u);
+  for (int i = 0; i < 500; ++i) {
+    EXPECT_EQ(all[i].timestamp, kBase + i);
+    EXPECT_EQ(all[i].message,
+              "message " + std::to_string(i));
+  }
+  EXPECT_EQ(all[7].level, StatsLevel::Info);
+
+  std::vector<StoredEntry> range
+    = collect(store, kBase + 100, kBase + 109);
+  ASSERT_EQ(range.size(), 10u);
+  EXPECT_EQ(range.front().message, "message 100");
+  EXPECT_EQ(range.back().message, "message 109");
+
+  // Обход можно прервать
+  int seen = 0;
+  store.query(kBase, kBase + 1000,
+              [&](const StoredEntry &) {
+                return ++seen < 3;
+              });
+  EXPECT_EQ(seen, 3);
+}
+
+// После перезапуска сегменты подхватываются, а оборванная
+// запись в конце сегмента отрезается
+TEST(EntryStoreTest, RecoversSegmentsAfterRestart) {
+  EntryStoreOptions options;
+  options.directory = freshDir("store_recover");
+  options.memoryEntries = 5;
+  {
+    EntryStore store(options);
+    ASSERT_TRUE(store.open());
+    for (int i = 0; i < 20; ++i)
+      store.append(
+        kBase + i, StatsLevel::Warning,
+        "line\nwith newline " + std::to_string(i));
+  }
+
+  // Имитация аварии: индекса нет, запись оборвана
+  namespace fs = std::filesystem;
+  std::string segment;
+  for (const auto &file :
+       fs::directory_iterator(options.directory)) {
+    if (file.path().extension() == ".log")
+      segment = file.path().string();
+  }
+  ASSERT_FALSE(segment.empty());
+  fs::remove(fs::path(segment).replace_extension(".idx"));
+  auto size = fs::file_size(segment);
+  std::ofstream(segment, std::ios::app).write("\0\0\1", 3);
+
+  EntryStore store(options);
+  ASSERT_TRUE(store.open());
+  EXPECT_EQ(fs::file_size(segment), size);
+  store.append(kBase + 20, StatsLevel::Error, "after");
+
+  std::vector<StoredEntry> all
+    = collect(store, kBase, kBase + 100);
+  ASSERT_EQ(all.size(), 21u);
+  EXPECT_EQ(all[3].message, "line\nwith newline 3");
+  EXPECT_EQ(all[3].level, StatsLevel::Warning);
+  EXPECT_EQ(all.back().message, "after");
+}
+
+// Ограничения хранения удаляют старые сегменты, не трогая
+// текущий
+TEST(EntryStoreTest, PrunesByBytesAndAge) {
+  EntryStoreOptions options;
+  options.directory = freshDir("store_prune");
+  options.memoryEntries = 0;
+  options.segmentBytes = 4096;
+  options.retentionBytes = 16 * 1024;
+  {
+    EntryStore store(options);
+    ASSERT_TRUE(store.open());
+
+    std::string message(100, 'x');
+    for (int i = 0; i < 2000; ++i)
+      store.append(kBase + i, StatsLevel::Info, message);
+
+    EntryStoreUsage usage = store.usage();
+    EXPECT_GT(usage.prunedSegments, 0u);
+    EXPECT_LE(usage.diskBytes, options.retentionBytes
+                                 + options.segmentBytes);
+    std::vector<StoredEntry> all
+      = collect(store, kBase, kBase + 2000);
+    ASSERT_FALSE(all.empty());
+    EXPECT_EQ(all.back().timestamp, kBase + 1999);
+    EXPECT_GT(all.front().timestamp, kBase);
+  }
+
+  // По возрасту: после перезапуска все сегменты закрыты и
+  // старше минуты
+  EntryStoreOptions aged = options;
+  aged.retentionBytes = 0;
+  aged.retentionSeconds = 60;
+  EntryStore again(aged);
+  ASSERT_TRUE(again.open());
+  EXPECT_EQ(again.usage().segments, 0u);
+  EXPECT_GT(again.usage().prunedSegments, 0u);
+}
+
+// Без каталога хранится только кольцо последних сообщений
+TEST(EntryStoreTest, MemoryOnlyKeepsRecentEntries) {
+  EntryStoreOptions options;
+  options.memoryEntries = 3;
+  EntryStore store(options);
+  ASSERT_TRUE(store.open());
+  for (int i = 0; i < 10; ++i)
+    store.append(kBase + i, StatsLevel::Debug,
+                 std::to_string(i));
+
+  std::vector<StoredEntry> all
+    = collect(store, kBase, kBase + 100);
+  ASSERT_EQ(all.size(), 3u);
+  EXPECT_EQ(all[0].message, "7");
+  EXPECT_EQ(all[2].message, "9");
+  EXPECT_EQ(store.usage().segments, 0u);
+}
+
+// Сообщение длиннее кадра обрезается: записи после него
+// читаются и переживают перезапуск
+TEST(EntryStoreTest, TruncatesOversizeMessages) {
+  EntryStoreOptions options;
+  options.directory = freshDir("store_oversize");
+  options.memoryEntries = 0;
+  {
+    EntryStore store(options);
+    ASSERT_TRUE(store.open());
+    store.append(kBase, StatsLevel::Info,
+                 std::string(EntryStore::kMaxMessage + 100,
+                             'x'));
+    store.append(kBase + 1, StatsLevel::Info, "after");
+  }
+
+  EntryStore again(options);
+  ASSERT_TRUE(again.open());
+  std::vector<StoredEntry> all
+    = collect(again, kBase, kBase + 1);
+  ASSERT_EQ(all.size(), 2u);
+  EXPECT_EQ(all[0].message.size(), EntryStore::kMaxMessage);
+  EXPECT_EQ(all[1].message, "after");
+}
@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "logger/FrameProtocol.h"
+
+using namespace logger;
+
+// Кадры переживают произвольное разбиение потока, а
+// сообщения с переводами строк приходят целыми
+TEST(FrameProtocolTest, DecodesAcrossSplits) {
+  std::string stream;
+  frame::appendFrame(stream, LogLevel::Error, 1234567890123,
+                     "first\nsecond line");
+  frame::appendFrame(stream, LogLevel::Info, -5, "");
+  frame::appendFrame(stream, LogLevel::Warning, 42, "tail");
+
+  frame::FrameDecoder decoder;
+  std::vector<std::string> payloads;
+  frame::Frame f;
+  for (char c : stream) {
+    decoder.feed(&c, 1);  // По одному байту
+    while (decoder.next(f)) {
+      payloads.emplace_back(f.payload);
+      if (payloads.size() == 1) {
+        EXPECT_EQ(f.level, LogLevel::Error);
+        EXPECT_EQ(f.timestampNs, 1234567890123);
+      } else if (payloads.size() == 2) {
+        EXPECT_EQ(f.timestampNs, -5);
+      }
+    }
+  }
+  EXPECT_EQ(payloads, (std::vector<std::string>{
+                        "first\nsecond line", "", "tail"}));
+  EXPECT_EQ(decoder.pending(), 0u);
+  EXPECT_FALSE(decoder.failed());
+}
+
+// Приветствие и неверная длина кадра
+TEST(FrameProtocolTest, HelloAndCorruptLength) {
+  EXPECT_EQ(frame::helloLine(), "LOGFRAME 1\n");
+  EXPECT_EQ(frame::parseHello("LOGFRAME 1"), 1u);
+  EXPECT_EQ(frame::parseHello("LOGFRAME 7"), 7u);
+  EXPECT_EQ(frame::parseHello("LOGFRAME x"), 0u);
+  EXPECT_EQ(frame::parseHello("[INFO] LOGFRAME 1"), 0u);
+
+  frame::FrameDecoder decoder;
+  const char bad[] = {0, 0, 0, 2, 'a', 'b'};  // Меньше
+                                              // заголовка
+  decoder.feed(bad, sizeof(bad));
+  frame::Frame f;
+  EXPECT_FALSE(decoder.next(f));
+  EXPECT_TRUE(decoder.failed());
+}
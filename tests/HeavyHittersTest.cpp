@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "HeavyHitters.h"
+
+namespace {
+
+// Разные сообщения без цифр: "unique message xyz"
+std::string uniqueMessage(int i) {
+  std::string text = "unique message ";
+  for (int n = 0; n < 3; ++n, i /= 26)
+    text += static_cast<char>('a' + i % 26);
+  return text;
+}
+
+}  // namespace
+
+// Слова с цифрами (время, числа, id) не различают
+// сообщения, остальной текст — различает
+TEST(HeavyHittersTest, FingerprintIgnoresNumbers) {
+  EXPECT_EQ(
+    HeavyHitters::fingerprint(
+      "[2024-05-01 12:00:01] [ERROR] disk 91% full"),
+    HeavyHitters::fingerprint(
+      "[2024-05-02 08:13:59] [ERROR] disk 7% full"));
+  EXPECT_EQ(
+    HeavyHitters::fingerprint("user u42 id=0x1f"),
+    HeavyHitters::fingerprint("user u7 id=0xbeef1"));
+  EXPECT_NE(HeavyHitters::fingerprint("disk full"),
+            HeavyHitters::fingerprint("disk empty"));
+  EXPECT_NE(HeavyHitters::fingerprint("a b"),
+            HeavyHitters::fingerprint("ab"));
+}
+
+// Поток из многих разных сообщений и одного частого: оно
+// первое, а оценка не меньше настоящего числа
+TEST(HeavyHittersTest, FindsFloodAmongUniqueMessages) {
+  HeavyHitters tracker(4);
+  for (int i = 0; i < 20000; ++i) {
+    tracker.add(uniqueMessage(i));
+    if (i % 4 == 0)
+      tracker.add("[ERROR] connection " + std::to_string(i)
+                  + " refused\nstack");
+    if (i % 10 == 0)
+      tracker.add("[WARNING] slow query");
+  }
+
+  std::vector<HeavyHitter> top = tracker.top();
+  ASSERT_EQ(top.size(), 4u);
+  EXPECT_EQ(top[0].sample, "[ERROR] connection 0 refused");
+  EXPECT_GE(top[0].count, 5000u);
+  EXPECT_LT(top[0].count, 5100u);
+  EXPECT_EQ(top[1].sample, "[WARNING] slow query");
+  EXPECT_GE(top[1].count, 2000u);
+  EXPECT_EQ(tracker.estimate(top[0].fingerprint),
+            top[0].count);
+}
+
+// Сообщение, частое только в сумме по шардам, попадает в
+// общий список с суммой оценок
+TEST(HeavyHittersTest, MergeSumsEstimatesAcrossShards) {
+  HeavyHitters left(2), right(2);
+  for (int i = 0; i < 30; ++i) {
+    left.add("shared");
+    right.add("shared");
+  }
+  for (int i = 0; i < 40; ++i) {
+    left.add("left only");
+    right.add("right only");
+  }
+  std::vector<HeavyHitter> merged
+    = mergeHeavyHitters({&left, &right}, 2);
+  ASSERT_EQ(merged.size(), 2u);
+  EXPECT_EQ(merged[0].sample, "shared");
+  EXPECT_EQ(merged[0].count, 60u);
+  EXPECT_EQ(merged[1].count, 40u);
+  EXPECT_TRUE(mergeHeavyHitters({}, 5).empty());
+}
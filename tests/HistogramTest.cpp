@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "Histogram.h"
+
+// Корзины идут подряд и покрывают весь диапазон uint64 без
+// пропусков, а ширина корзины не больше 1/32 её начала
+TEST(HistogramTest, BucketsCoverRangeWithBoundedError) {
+  EXPECT_EQ(Histogram::bucketLow(0), 0u);
+  for (std::size_t i = 0; i + 1 < Histogram::kBuckets;
+       ++i) {
+    std::uint64_t low = Histogram::bucketLow(i);
+    std::uint64_t high = Histogram::bucketHigh(i);
+    ASSERT_EQ(high + 1, Histogram::bucketLow(i + 1)) << i;
+    ASSERT_EQ(Histogram::bucketOf(low), i);
+    ASSERT_EQ(Histogram::bucketOf(high), i);
+    ASSERT_LE(high - low, low / Histogram::kSubBuckets);
+  }
+  EXPECT_EQ(Histogram::bucketOf(UINT64_MAX),
+            Histogram::kBuckets - 1);
+  EXPECT_EQ(Histogram::bucketHigh(Histogram::kBuckets - 1),
+            UINT64_MAX);
+}
+
+// Малые значения точны, большие — в пределах корзины
+TEST(HistogramTest, PercentilesUseNearestRank) {
+  Histogram histogram;
+  EXPECT_EQ(histogram.percentile(50), 0u);
+  for (std::uint64_t value = 1; value <= 1000; ++value)
+    histogram.record(value);
+  EXPECT_EQ(histogram.count(), 1000u);
+  EXPECT_EQ(histogram.percentile(0), 1u);
+  EXPECT_NEAR(
+    static_cast<double>(histogram.percentile(50)), 500,
+    500.0 / Histogram::kSubBuckets);
+  EXPECT_NEAR(
+    static_cast<double>(histogram.percentile(99)), 990,
+    990.0 / Histogram::kSubBuckets);
+  // 1000 лежит в корзине [992, 1007]
+  EXPECT_EQ(histogram.percentile(100), 1007u);
+
+  Histogram exact;
+  exact.record(3, 999);
+  exact.record(40);
+  EXPECT_EQ(exact.percentile(99.9), 3u);
+  EXPECT_EQ(exact.percentile(99.95), 40u);
+}
+
+// Слияние даёт ту же гистограмму, что и общая запись
+TEST(HistogramTest, MergeMatchesSingleHistogram) {
+  Histogram single, left, right;
+  for (std::uint64_t value = 0; value < 5000; value += 7) {
+    single.record(value * value);
+    (value % 2 == 0 ? left : right).record(value * value);
+  }
+  left.merge(right);
+  EXPECT_EQ(left.count(), single.count());
+  for (double percent : {1.0, 50.0, 90.0, 99.0, 99.9})
+    EXPECT_EQ(left.percentile(percent),
+              single.percentile(percent));
+}
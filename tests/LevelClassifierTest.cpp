@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include "LevelClassifier.h"
+
+// Уровень берётся из поля "[УРОВЕНЬ]", а не из текста
+TEST(LevelClassifierTest, UsesLevelFieldOfLoggerLines) {
+  EXPECT_EQ(classifyLevel("[2024-05-01 12:00:00.123] [INFO]"
+                          " connection error recovered"),
+            StatsLevel::Info);
+  EXPECT_EQ(
+    classifyLevel("[1714564800] [WARNING] disk 91% full"),
+    StatsLevel::Warning);
+  EXPECT_EQ(
+    classifyLevel("#42 [12:00:00] [ERROR] info lost"),
+    StatsLevel::Error);
+  EXPECT_EQ(classifyLevel("[debug] trace id 7"),
+            StatsLevel::Debug);
+  EXPECT_EQ(classifyLevel("[t] [Fatal] "),
+            StatsLevel::Error);
+}
+
+// Текст сообщения — после поля уровня; без поля — вся
+// строка
+TEST(LevelClassifierTest, SplitsMessageFromHeader) {
+  std::string_view message;
+  EXPECT_EQ(classifyMessage("[2024-05-01 12:00:00] [INFO] "
+                            "user logged in",
+                            message),
+            StatsLevel::Info);
+  EXPECT_EQ(message, "user logged in");
+  classifyMessage("#42 [12:00:00] [ERROR] info lost",
+                  message);
+  EXPECT_EQ(message, "info lost");
+  classifyMessage("[debug] trace id 7", message);
+  EXPECT_EQ(message, "trace id 7");
+  classifyMessage("[t] [Fatal]", message);
+  EXPECT_EQ(message, "");
+  EXPECT_EQ(classifyMessage("[x] warning: low memory",
+                            message),
+            StatsLevel::Warning);
+  EXPECT_EQ(message, "[x] warning: low memory");
+}
+
+// Строки без поля уровня просматриваются целиком с
+// прежним приоритетом ключевых слов
+TEST(LevelClassifierTest, ScansFreeFormLines) {
+  EXPECT_EQ(classifyLevel("user login ok, info: id=3"),
+            StatsLevel::Info);
+  EXPECT_EQ(classifyLevel("Debug: warn threshold reached"),
+            StatsLevel::Warning);
+  EXPECT_EQ(classifyLevel("info then ERR at the end"),
+            StatsLevel::Error);
+  EXPECT_EQ(classifyLevel("dbg"), StatsLevel::Debug);
+  EXPECT_EQ(classifyLevel("[module] plain text"),
+            StatsLevel::Unknown);
+  EXPECT_EQ(classifyLevel("[t] [custom] TRACE here"),
+            StatsLevel::Debug);
+  EXPECT_EQ(classifyLevel(""), StatsLevel::Unknown);
+  EXPECT_EQ(classifyLevel("[unterminated INFO"),
+            StatsLevel::Info);
+  EXPECT_EQ(classifyLevel("er"), StatsLevel::Unknown);
+}
+
+TEST(LevelClassifierTest, LevelNamesMatchWholeField) {
+  EXPECT_EQ(levelFromName("information"), StatsLevel::Info);
+  EXPECT_EQ(levelFromName("WRN"), StatsLevel::Warning);
+  EXPECT_EQ(levelFromName("ERRORS"), StatsLevel::Unknown);
+  EXPECT_EQ(levelFromName(""), StatsLevel::Unknown);
+}
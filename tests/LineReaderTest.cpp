@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "LineReader.h"
+
+namespace {
+
+// Пишет text в reader кусками не больше step байт и
+// собирает все целые строки
+std::vector<std::string> feed(LineReader &reader,
+                              const std::string &text,
+                              std::size_t step) {
+  std::vector<std::string> lines;
+  std::size_t pos = 0;
+  while (pos < text.size()) {
+    std::size_t room = 0;
+    char *dest = reader.space(room);
+    std::size_t len
+      = std::min({room, step, text.size() - pos});
+    std::memcpy(dest, text.data() + pos, len);
+    reader.commit(len);
+    pos += len;
+    std::string_view line;
+    while (reader.next(line))
+      lines.emplace_back(line);
+  }
+  return lines;
+}
+
+}  // namespace
+
+// Строки, пересекающие границы recv и конец буфера,
+// собираются целиком
+TEST(LineReaderTest, SplitsLinesAcrossChunksAndWraps) {
+  LineReader reader(16);
+  std::string text;
+  for (int i = 0; i < 50; ++i)
+    text += "line " + std::to_string(i) + "\n";
+  text += "tail";
+
+  std::vector<std::string> lines = feed(reader, text, 5);
+  ASSERT_EQ(lines.size(), 50u);
+  EXPECT_EQ(lines.front(), "line 0");
+  EXPECT_EQ(lines[37], "line 37");
+  EXPECT_EQ(reader.pending(), "tail");
+  EXPECT_FALSE(reader.empty());
+}
+
+// Строка длиннее буфера увеличивает его
+TEST(LineReaderTest, GrowsForLongLines) {
+  LineReader reader(8);
+  std::string longLine(100, 'x');
+  std::vector<std::string> lines
+    = feed(reader, "ab\n" + longLine + "\ncd\n", 64);
+  ASSERT_EQ(lines.size(), 3u);
+  EXPECT_EQ(lines[1], longLine);
+  EXPECT_EQ(lines[2], "cd");
+  EXPECT_TRUE(reader.empty());
+}
+
+// Буфер больше kMaxLine не выделяется: строка без '\n'
+// отдаётся частями по kMaxLine, место для recv есть всегда
+TEST(LineReaderTest, CapsCapacityAtMaxLine) {
+  LineReader reader(2 * LineReader::kMaxLine);
+  std::string text(LineReader::kMaxLine + 10, 'x');
+  std::vector<std::string> lines
+    = feed(reader, text, LineReader::kMaxLine);
+  ASSERT_EQ(lines.size(), 1u);
+  EXPECT_EQ(lines[0].size(), LineReader::kMaxLine);
+  EXPECT_EQ(reader.pending().size(), 10u);
+  std::size_t room = 0;
+  reader.space(room);
+  EXPECT_GT(room, 0u);
+}
+
+// Буфер можно отдать и вернуть, когда строк не осталось
+TEST(LineReaderTest, ReleasesAndAdoptsBuffer) {
+  LineReader reader(32);
+  feed(reader, "one\n", 32);
+  ASSERT_TRUE(reader.empty());
+  std::vector<char> buffer = reader.release();
+  EXPECT_EQ(buffer.size(), 32u);
+  EXPECT_FALSE(reader.hasBuffer());
+
+  LineReader other(32);
+  other.adopt(std::move(buffer));
+  std::vector<std::string> lines = feed(other, "two\n", 32);
+  ASSERT_EQ(lines.size(), 1u);
+  EXPECT_EQ(lines[0], "two");
+}
@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "logger/LockFreeLogQueue.h"
+
+using namespace logger;
+
+// Тест однопоточного добавления и извлечения сообщения из
+// lock-free очереди
+TEST(LockFreeLogQueueTest, PushPopSingleThread) {
+  LockFreeLogQueue q(4);
+  q.push(LogMessage{"Hello", LogLevel::Warning});
+
+  auto popped = q.pop();
+  ASSERT_TRUE(popped.has_value());
+  EXPECT_EQ(popped->text, "Hello");
+  EXPECT_EQ(popped->level, LogLevel::Warning);
+
+  // После закрытия пустая очередь возвращает nullopt
+  q.close();
+  EXPECT_FALSE(q.pop().has_value());
+}
+
+// Ёмкость округляется до степени двойки, а tryPush
+// сообщает о заполненном кольце
+TEST(LockFreeLogQueueTest, TryPushReportsFull) {
+  LockFreeLogQueue q(3);
+  ASSERT_EQ(q.capacity(), 4u);
+
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(q.tryPush(
+      LogMessage{std::to_string(i), LogLevel::Info}));
+  }
+  EXPECT_FALSE(q.tryPush(LogMessage{"x", LogLevel::Info}));
+
+  // После извлечения одного сообщения место появляется
+  auto first = q.tryPop();
+  ASSERT_TRUE(first.has_value());
+  EXPECT_EQ(first->text, "0");
+  EXPECT_TRUE(q.tryPush(LogMessage{"4", LogLevel::Info}));
+}
+
+// Сообщения, добавленные до close(), извлекаются после
+// закрытия очереди
+TEST(LockFreeLogQueueTest, DrainAfterClose) {
+  LockFreeLogQueue q(8);
+  q.push(LogMessage{"a", LogLevel::Info});
+  q.push(LogMessage{"b", LogLevel::Info});
+  q.close();
+
+  EXPECT_EQ(q.pop()->text, "a");
+  EXPECT_EQ(q.pop()->text, "b");
+  EXPECT_FALSE(q.pop().has_value());
+}
+
+// Несколько производителей и один потребитель через
+// маленькое кольцо: все сообщения доставлены, порядок
+// внутри каждого производителя сохранён
+TEST(LockFreeLogQueueTest, MultiProducerOrdering) {
+  constexpr int kProducers = 8;
+  constexpr int kPerProducer = 2000;
+  LockFreeLogQueue q(16);
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p < kProducers; ++p) {
+    producers.emplace_back([&q, p] {
+      for (int i = 0; i < kPerProducer; ++i) {
+        q.push(LogMessage{
+          std::to_string(p) + ":" + std::to_string(i),
+          LogLevel::Info});
+      }
+    });
+  }
+
+  std::vector<int> next(kProducers, 0);
+  int received = 0;
+  std::thread consumer([&] {
+    while (auto msg = q.pop()) {
+      auto sep = msg->text.find(':');
+      int p = std::stoi(msg->text.substr(0, sep));
+      int i = std::stoi(msg->text.substr(sep + 1));
+      EXPECT_EQ(i, next[static_cast<size_t>(p)]);
+      next[static_cast<size_t>(p)] = i + 1;
+      ++received;
+    }
+  });
+
+  for (auto &t : producers)
+    t.join();
+  q.close();
+  consumer.join();
+
+  EXPECT_EQ(received, kProducers * kPerProducer);
+}
+
+// Пакетное извлечение из lock-free очереди
+TEST(LockFreeLogQueueTest, PopBatchAndDrain) {
+  LockFreeLogQueue q(8);
+  for (int i = 0; i < 5; ++i) {
+    q.push(LogMessage{std::to_string(i), LogLevel::Info});
+  }
+
+  std::vector<LogMessage> batch;
+  ASSERT_TRUE(
+    q.popBatch(batch, 2, std::chrono::milliseconds(5)));
+  ASSERT_EQ(batch.size(), 2u);
+  EXPECT_EQ(batch[1].text, "1");
+
+  EXPECT_EQ(q.drainAll(batch), 3u);
+  EXPECT_EQ(batch[2].text, "4");
+
+  // Пустая очередь: таймаут, затем false после закрытия
+  EXPECT_TRUE(
+    q.popBatch(batch, 2, std::chrono::milliseconds(5)));
+  EXPECT_TRUE(batch.empty());
+  q.close();
+  EXPECT_FALSE(
+    q.popBatch(batch, 2, std::chrono::milliseconds(5)));
+}
+
+// close() во время записи: потребитель дочитывает до
+// хвоста, и у каждого производителя он получает начало
+// его сообщений без пропусков, а push, шедшие
+// одновременно с close(), остаются в кольце
+TEST(LockFreeLogQueueTest, CloseWhileProducersPush) {
+  constexpr int kProducers = 4;
+  LockFreeLogQueue q(1 << 16);
+  std::atomic<bool> stop{false};
+  std::vector<int> pushed(kProducers, 0);
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p < kProducers; ++p) {
+    producers.emplace_back([&, p] {
+      int i = 0;
+      while (!stop.load() && i < 10000) {
+        q.push(LogMessage{
+          std::to_string(p) + ":" + std::to_string(i),
+          LogLevel::Info});
+        ++i;
+      }
+      pushed[static_cast<size_t>(p)] = i;
+    });
+  }
+
+  std::vector<int> next(kProducers, 0);
+  auto check = [&](const LogMessage &msg) {
+    auto sep = msg.text.find(':');
+    auto p = static_cast<size_t>(
+      std::stoi(msg.text.substr(0, sep)));
+    EXPECT_EQ(std::stoi(msg.text.substr(sep + 1)), next[p]);
+    ++next[p];
+  };
+  std::thread consumer([&] {
+    while (auto msg = q.pop())
+      check(*msg);
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  q.close();
+  consumer.join();
+  stop = true;
+  for (auto &t : producers)
+    t.join();
+
+  std::vector<LogMessage> rest;
+  q.drainAll(rest);
+  for (const LogMessage &msg : rest)
+    check(msg);
+  EXPECT_EQ(next, pushed);
+}
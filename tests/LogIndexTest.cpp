@@ -0,0 +1,227 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "LogIndex.h"
+
+namespace {
+
+// Тексты найденных сообщений
+std::vector<std::string> messages(
+  const std::vector<IndexHit> &hits) {
+  std::vector<std::string> result;
+  for (const IndexHit &hit : hits)
+    result.push_back(hit.message);
+  return result;
+}
+
+IndexQuery parse(const std::string &text,
+                 time_t now = 1000) {
+  IndexQuery query;
+  std::string error;
+  EXPECT_TRUE(parseIndexQuery(text, now, query, error))
+    << error;
+  return query;
+}
+
+}  // namespace
+
+// Слова группы — через И, группы — через ИЛИ, регистр не
+// важен, слово должно совпасть целиком
+TEST(LogIndexTest, AndOrQueries) {
+  LogIndex index(100);
+  index.add(1, StatsLevel::Error, "DB timeout on shard 3");
+  index.add(2, StatsLevel::Info, "db connected");
+  index.add(3, StatsLevel::Error, "connection refused");
+  index.add(4, StatsLevel::Warning, "timeouts are rising");
+  index.publish();
+
+  EXPECT_EQ(
+    messages(index.search(parse("db timeout"))),
+    std::vector<std::string>{"DB timeout on shard 3"});
+  EXPECT_EQ(
+    messages(index.search(parse("db AND connected OR "
+                                "REFUSED"))),
+    (std::vector<std::string>{"db connected",
+                              "connection refused"}));
+  EXPECT_TRUE(index.search(parse("db refused")).empty());
+  EXPECT_TRUE(index.search(parse("missing")).empty());
+
+  // Только фильтры — все сообщения
+  std::vector<IndexHit> all = index.search(parse(""));
+  ASSERT_EQ(all.size(), 4u);
+  EXPECT_EQ(all[0].id, 0u);
+  EXPECT_EQ(all[3].timestamp, 4);
+  EXPECT_EQ(all[3].level, StatsLevel::Warning);
+}
+
+// Фильтры уровня и времени и limit, оставляющий самые
+// новые
+TEST(LogIndexTest, LevelTimeAndLimitFilters) {
+  LogIndex index(1000);
+  for (int i = 0; i < 100; ++i)
+    index.add(900 + i,
+              i % 2 == 0 ? StatsLevel::Error
+                         : StatsLevel::Info,
+              "request " + std::to_string(i) + " done");
+  index.publish();
+
+  EXPECT_EQ(index.search(parse("request level=error"))
+              .size(),
+            50u);
+  EXPECT_EQ(
+    index.search(parse("request level=error,info")).size(),
+    100u);
+  EXPECT_TRUE(
+    index.search(parse("request level=warning")).empty());
+
+  std::vector<IndexHit> window
+    = index.search(parse("done from=910 to=919"));
+  ASSERT_EQ(window.size(), 10u);
+  EXPECT_EQ(window.front().timestamp, 910);
+  EXPECT_EQ(window.back().timestamp, 919);
+
+  // last= отсчитывается от now (1000)
+  EXPECT_EQ(index.search(parse("done last=5")).size(), 5u);
+
+  EXPECT_EQ(
+    messages(index.search(parse("request limit=2"))),
+    (std::vector<std::string>{"request 98 done",
+                              "request 99 done"}));
+  EXPECT_EQ(messages(index.search(parse("42"))),
+            std::vector<std::string>{"request 42 done"});
+}
+
+// Запросы видят только опубликованное; мелкие сегменты
+// сливаются, старые сверх предела отбрасываются
+TEST(LogIndexTest, PublishMergeAndTrim) {
+  LogIndex index(2 * LogIndex::kSegmentEntries);
+  index.add(1, StatsLevel::Info, "first");
+  EXPECT_TRUE(index.search(parse("first")).empty());
+  index.publishIfDue();  // Интервал ещё не прошёл
+  EXPECT_TRUE(index.search(parse("first")).empty());
+  index.publish();
+  EXPECT_EQ(index.search(parse("first")).size(), 1u);
+
+  for (int i = 0; i < 10; ++i) {
+    index.add(2, StatsLevel::Info, "small batch");
+    index.publish();
+  }
+  LogIndexUsage usage = index.usage();
+  EXPECT_EQ(usage.entries, 11u);
+  EXPECT_LT(usage.segments, 5u);
+  EXPECT_GT(usage.bytes, 0u);
+  EXPECT_EQ(index.search(parse("small")).size(), 10u);
+
+  // Сегменты по kSegmentEntries публикуются сами
+  for (size_t i = 0; i < 3 * LogIndex::kSegmentEntries;
+       ++i)
+    index.add(3, StatsLevel::Info, "bulk entry");
+  usage = index.usage();
+  EXPECT_LE(usage.entries, 2 * LogIndex::kSegmentEntries);
+  EXPECT_GE(usage.entries, LogIndex::kSegmentEntries);
+  EXPECT_TRUE(index.search(parse("first")).empty());
+
+  IndexQuery bulk = parse("bulk limit=10000");
+  std::vector<IndexHit> before = index.search(bulk);
+  EXPECT_EQ(before.size(), usage.entries);
+  EXPECT_EQ(before.back().id,
+            3 * LogIndex::kSegmentEntries + 10);
+}
+
+// Поиск по индексам нескольких реакторов: общий limit по
+// времени записи
+TEST(LogIndexTest, SearchesSeveralIndexes) {
+  LogIndex a(100);
+  LogIndex b(100);
+  a.add(10, StatsLevel::Error, "disk full");
+  b.add(20, StatsLevel::Error, "disk full again");
+  a.add(30, StatsLevel::Error, "disk full once more");
+  a.publish();
+  b.publish();
+
+  std::vector<IndexHit> hits
+    = searchIndexes({&a, &b}, parse("disk limit=2"));
+  EXPECT_EQ(messages(hits),
+            (std::vector<std::string>{
+              "disk full again", "disk full once more"}));
+}
+
+// Запросы из другого потока во время приёма видят
+// целые снимки: номера растут, тексты совпадают
+TEST(LogIndexTest, SearchesWhileWriting) {
+  LogIndex index(10000);
+  std::atomic<bool> done{false};
+  std::thread writer([&] {
+    for (int i = 0; i < 50000; ++i)
+      index.add(i, StatsLevel::Info,
+                i % 3 == 0 ? "tick even" : "tock odd");
+    index.publish();
+    done = true;
+  });
+
+  IndexQuery query = parse("tick limit=500");
+  std::size_t searches = 0;
+  while (!done || searches == 0) {
+    std::vector<IndexHit> hits = index.search(query);
+    ASSERT_LE(hits.size(), 500u);
+    for (std::size_t i = 0; i < hits.size(); ++i) {
+      ASSERT_EQ(hits[i].message, "tick even");
+      ASSERT_EQ(hits[i].id % 3, 0u);
+      if (i > 0) {
+        ASSERT_GT(hits[i].id, hits[i - 1].id);
+      }
+    }
+    ++searches;
+  }
+  writer.join();
+  std::vector<IndexHit> last = index.search(query);
+  ASSERT_EQ(last.size(), 500u);
+  EXPECT_EQ(last.back().id, 49998u);
+}
+
+// Проверка записи без индекса (поиск по хранилищу)
+TEST(LogIndexTest, MatchesEntriesWithoutIndex) {
+  IndexQuery query
+    = parse("db timeout OR refused level=error from=10 "
+            "source=store");
+  EXPECT_EQ(query.source, QuerySource::Store);
+  EXPECT_TRUE(matchesQuery(query, 10, StatsLevel::Error,
+                           "DB: timeout"));
+  EXPECT_TRUE(matchesQuery(query, 20, StatsLevel::Error,
+                           "connection refused"));
+  EXPECT_FALSE(matchesQuery(query, 20, StatsLevel::Error,
+                            "db is slow"));
+  EXPECT_FALSE(matchesQuery(query, 20, StatsLevel::Info,
+                            "refused"));
+  EXPECT_FALSE(matchesQuery(query, 9, StatsLevel::Error,
+                            "refused"));
+  EXPECT_EQ(parse("").source, QuerySource::Index);
+}
+
+TEST(LogIndexTest, RejectsInvalidQueries) {
+  const char *invalid[] = {"level=loud", "limit=0",
+                           "limit=100000", "from=abc",
+                           "last=-5", "a OR", "OR b",
+                           "a OR OR b", "source=disk"};
+  for (const char *text : invalid) {
+    IndexQuery query;
+    std::string error;
+    EXPECT_FALSE(parseIndexQuery(text, 0, query, error))
+      << text;
+    EXPECT_FALSE(error.empty()) << text;
+  }
+
+  IndexQuery query = parse("user=Bob level=unknown,fatal");
+  ASSERT_EQ(query.any.size(), 1u);
+  EXPECT_EQ(query.any[0],
+            (std::vector<std::string>{"user", "bob"}));
+  auto bit = [](StatsLevel level) {
+    return 1u << static_cast<unsigned>(level);
+  };
+  EXPECT_EQ(query.levels, bit(StatsLevel::Unknown)
+                            | bit(StatsLevel::Error));
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+// Файл собирается с порогом Warning: вызовы уровня Info
+// должны вырезаться при компиляции независимо от значения
+// LOGGER_MIN_LEVEL для остальной сборки
+#include "logger/LogMacros.h"
+#undef LOGGER_MIN_LEVEL
+#define LOGGER_MIN_LEVEL LOGGER_LEVEL_WARNING
+
+using namespace logger;
+
+namespace {
+
+// Тестовый логгер: запоминает полученные сообщения
+class RecordingLogger : public ILogger {
+ public:
+  explicit RecordingLogger(LogLevel level) : ILogger(level) {}
+
+  void log(const std::string &message,
+           LogLevel level) override {
+    received.push_back(LogMessage{message, level});
+  }
+  void setLogLevel(LogLevel level) override {
+    storeLevel(level);
+  }
+  LogLevel getLogLevel() const override {
+    return loadLevel();
+  }
+
+  std::vector<LogMessage> received;
+};
+
+}  // namespace
+
+// Выражение сообщения вычисляется только если уровень
+// включён во время выполнения
+TEST(LogMacrosTest, EvaluatesMessageLazily) {
+  RecordingLogger logger(LogLevel::Error);
+  int built = 0;
+  auto build = [&built] {
+    ++built;
+    return std::string("expensive");
+  };
+
+  LOGGER_WARNING(logger, build());
+  LOGGER_WARNING(logger, build);
+  EXPECT_EQ(built, 0);
+  EXPECT_TRUE(logger.received.empty());
+
+  LOGGER_ERROR(logger, build);
+  logger.setLogLevel(LogLevel::Warning);
+  EXPECT_TRUE(logger.isEnabled(LogLevel::Warning));
+  LOGGER_WARNING(logger, "value " + std::to_string(built));
+
+  ASSERT_EQ(logger.received.size(), 2u);
+  EXPECT_EQ(built, 1);
+  EXPECT_EQ(logger.received[0].text, "expensive");
+  EXPECT_EQ(logger.received[0].level, LogLevel::Error);
+  EXPECT_EQ(logger.received[1].text, "value 1");
+  EXPECT_EQ(logger.received[1].level, LogLevel::Warning);
+}
+
+// Уровни ниже LOGGER_MIN_LEVEL не логируются даже при
+// включённом уровне во время выполнения
+TEST(LogMacrosTest, StripsLevelsBelowCompileTimeMinimum) {
+  RecordingLogger logger(LogLevel::Info);
+  int built = 0;
+
+  LOGGER_INFO(logger, [&built] {
+    ++built;
+    return std::string("stripped");
+  });
+  LOGGER_LOG(logger, LogLevel::Info, "stripped");
+  LOGGER_LOG(logger, LogLevel::Warning, "kept");
+
+  EXPECT_EQ(built, 0);
+  ASSERT_EQ(logger.received.size(), 1u);
+  EXPECT_EQ(logger.received[0].text, "kept");
+}
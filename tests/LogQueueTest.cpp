@@ -2,6 +2,7 @@
 
 #include <chrono>
 #include <thread>
+#include <vector>
 
 #include "logger/LogQueue.h"
 #include "logger/Logger.h"
@@ -76,3 +77,48 @@ TEST(LogQueueTest, PushPopMultiThread) {
     EXPECT_EQ(results[i].level, LogLevel::Info);
   }
 }
+
+// Тест пакетного извлечения: popBatch забирает не больше
+// max сообщений, остаток остаётся в очереди
+TEST(LogQueueTest, PopBatchRespectsMax) {
+  LogQueue q;
+  for (int i = 0; i < 5; ++i) {
+    q.push(LogMessage{"msg" + std::to_string(i),
+                      LogLevel::Info});
+  }
+
+  std::vector<LogMessage> batch;
+  ASSERT_TRUE(
+    q.popBatch(batch, 3, std::chrono::milliseconds(10)));
+  ASSERT_EQ(batch.size(), 3u);
+  EXPECT_EQ(batch[0].text, "msg0");
+  EXPECT_EQ(batch[2].text, "msg2");
+
+  // Остаток забирается целиком через drainAll
+  EXPECT_EQ(q.drainAll(batch), 2u);
+  EXPECT_EQ(batch[0].text, "msg3");
+  EXPECT_EQ(batch[1].text, "msg4");
+}
+
+// popBatch возвращает пустую пачку по таймауту и false
+// после закрытия пустой очереди
+TEST(LogQueueTest, PopBatchTimeoutAndClose) {
+  LogQueue q;
+  std::vector<LogMessage> batch;
+
+  EXPECT_TRUE(
+    q.popBatch(batch, 10, std::chrono::milliseconds(5)));
+  EXPECT_TRUE(batch.empty());
+
+  q.push(LogMessage{"last", LogLevel::Error});
+  q.close();
+
+  // Сообщения, добавленные до закрытия, всё ещё выдаются
+  ASSERT_TRUE(
+    q.popBatch(batch, 10, std::chrono::milliseconds(5)));
+  ASSERT_EQ(batch.size(), 1u);
+  EXPECT_EQ(batch[0].text, "last");
+
+  EXPECT_FALSE(
+    q.popBatch(batch, 10, std::chrono::milliseconds(5)));
+}
@@ -1,7 +1,14 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
 #include <fstream>
+#include <sstream>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "logger/Logger.h"
 
@@ -66,3 +73,371 @@ TEST(LoggerTest, LoggingLevels) {
   EXPECT_EQ(content.find("Info message"),
             std::string::npos);
 }
+
+// Тест пакетной записи: сообщения ниже уровня логгера
+// отфильтрованы, остальные записаны в исходном порядке
+TEST(LoggerTest, LogBatch) {
+  std::string filename
+    = std::string(LOG_DIR) + "/test_batch.log";
+  std::remove(filename.c_str());
+
+  Logger logger(filename, LogLevel::Warning);
+  std::vector<LogMessage> batch{
+    {"first", LogLevel::Error},
+    {"skipped", LogLevel::Info},
+    {"second", LogLevel::Warning},
+  };
+  logger.logBatch(batch.data(), batch.size());
+
+  std::ifstream file(filename);
+  ASSERT_TRUE(file.is_open());
+  std::string content(
+    (std::istreambuf_iterator<char>(file)),
+    std::istreambuf_iterator<char>());
+
+  auto first = content.find("[ERROR] first\n");
+  auto second = content.find("[WARNING] second\n");
+  ASSERT_NE(first, std::string::npos);
+  ASSERT_NE(second, std::string::npos);
+  EXPECT_LT(first, second);
+  EXPECT_EQ(content.find("skipped"), std::string::npos);
+}
+
+namespace {
+
+// Читает содержимое файла целиком
+std::string readFile(const std::string &filename) {
+  std::ifstream file(filename);
+  return std::string((std::istreambuf_iterator<char>(file)),
+                     std::istreambuf_iterator<char>());
+}
+
+// Политика без автоматического сброса: данные остаются в
+// буфере до flush()
+LoggerOptions manualFlush() {
+  LoggerOptions options;
+  options.flush.eachMessage = false;
+  return options;
+}
+
+}  // namespace
+
+// Без автоматического сброса строки появляются в файле
+// только после flush()
+TEST(LoggerTest, ManualFlush) {
+  std::string filename
+    = std::string(LOG_DIR) + "/test_manual_flush.log";
+  std::remove(filename.c_str());
+
+  Logger logger(filename, LogLevel::Info, manualFlush());
+  logger.log("buffered", LogLevel::Info);
+  EXPECT_EQ(readFile(filename).find("buffered"),
+            std::string::npos);
+
+  logger.flush();
+  EXPECT_NE(readFile(filename).find("[INFO] buffered\n"),
+            std::string::npos);
+}
+
+// Сброс на ошибке и по числу байт
+TEST(LoggerTest, FlushOnErrorAndBytes) {
+  std::string filename
+    = std::string(LOG_DIR) + "/test_error_flush.log";
+  std::remove(filename.c_str());
+
+  LoggerOptions options = manualFlush();
+  options.flush.onError = true;
+  options.flush.everyBytes = 4096;
+  Logger logger(filename, LogLevel::Info, options);
+
+  logger.log("info", LogLevel::Info);
+  EXPECT_TRUE(readFile(filename).empty());
+
+  logger.log("boom", LogLevel::Error);
+  EXPECT_NE(readFile(filename).find("[ERROR] boom\n"),
+            std::string::npos);
+
+  // Накопление больше порога сбрасывается без flush()
+  std::string big(5000, 'x');
+  logger.log(big, LogLevel::Info);
+  EXPECT_NE(readFile(filename).find(big),
+            std::string::npos);
+}
+
+// Фоновый сброс по интервалу и сброс в деструкторе
+TEST(LoggerTest, FlushIntervalAndDestructor) {
+  std::string filename
+    = std::string(LOG_DIR) + "/test_interval_flush.log";
+  std::remove(filename.c_str());
+
+  {
+    LoggerOptions options = manualFlush();
+    options.flush.interval = std::chrono::milliseconds(10);
+    Logger logger(filename, LogLevel::Info, options);
+    logger.log("ticked", LogLevel::Info);
+
+    // Ждём срабатывания фонового сброса
+    for (int i = 0; i < 200; ++i) {
+      if (readFile(filename).find("ticked")
+          != std::string::npos)
+        break;
+      std::this_thread::sleep_for(
+        std::chrono::milliseconds(5));
+    }
+    EXPECT_NE(readFile(filename).find("ticked"),
+              std::string::npos);
+  }
+
+  {
+    Logger logger(filename, LogLevel::Info, manualFlush());
+    logger.log("on close", LogLevel::Info);
+  }
+  EXPECT_NE(readFile(filename).find("on close"),
+            std::string::npos);
+}
+
+namespace {
+
+// Возвращает сегменты ротации лог-файла (отсортированные)
+std::vector<std::string> segmentsOf(
+  const std::string &dir) {
+  std::vector<std::string> result;
+  for (auto &entry : std::filesystem::directory_iterator(dir)) {
+    std::string name = entry.path().filename().string();
+    if (name.rfind("rotated.log.", 0) == 0)
+      result.push_back(entry.path().string());
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+// Считает строки во всех файлах
+std::size_t countLines(const std::vector<std::string> &files) {
+  std::size_t lines = 0;
+  for (auto &file : files) {
+    std::string content = readFile(file);
+    lines += static_cast<std::size_t>(
+      std::count(content.begin(), content.end(), '\n'));
+  }
+  return lines;
+}
+
+}  // namespace
+
+// Ротация по размеру: фоновый поток переименовывает файл,
+// строки не теряются и не дублируются
+TEST(LoggerTest, RotatesBySize) {
+  std::string dir = std::string(LOG_DIR) + "/rotation_size";
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+  std::string filename = dir + "/rotated.log";
+
+  std::size_t written = 0;
+  {
+    LoggerOptions options;
+    options.rotation.maxBytes = 512;
+    Logger logger(filename, LogLevel::Info, options);
+    for (std::size_t round = 1; round <= 3; ++round) {
+      // Ротация выполняется асинхронно: строки, записанные
+      // до подмены файла, попадают в предыдущий сегмент и не
+      // учитываются в размере нового — поэтому пишем, пока
+      // не появится очередной сегмент
+      for (int i = 0; i < 2000; ++i) {
+        if (segmentsOf(dir).size() >= round)
+          break;
+        logger.log("message number " + std::to_string(i),
+                   LogLevel::Info);
+        ++written;
+        std::this_thread::sleep_for(
+          std::chrono::milliseconds(1));
+      }
+      EXPECT_EQ(segmentsOf(dir).size(), round);
+    }
+    logger.log("tail", LogLevel::Info);
+  }
+
+  auto files = segmentsOf(dir);
+  EXPECT_EQ(files.size(), 3u);
+  EXPECT_NE(readFile(filename).find("tail"),
+            std::string::npos);
+  files.push_back(filename);
+  EXPECT_EQ(countLines(files), written + 1);
+}
+
+// Неудачная ротация (файл удалён — переименовать нечего)
+// сообщается rotate() и не выключает ротацию по размеру:
+// после паузы retryDelay запись сверх maxBytes пробует
+// снова
+TEST(LoggerTest, RotationRetriesAfterFailure) {
+  std::string dir = std::string(LOG_DIR) + "/rotation_retry";
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+  std::string filename = dir + "/rotated.log";
+
+  LoggerOptions options;
+  options.rotation.maxBytes = 256;
+  options.rotation.retryDelay
+    = std::chrono::milliseconds(10);
+  Logger logger(filename, LogLevel::Info, options);
+  logger.log("first", LogLevel::Info);
+  std::filesystem::remove(filename);
+  EXPECT_FALSE(logger.rotate());
+  for (int i = 0; i < 20; ++i)
+    logger.log("before the file is back", LogLevel::Info);
+  logger.flush();
+  EXPECT_TRUE(segmentsOf(dir).empty());
+
+  std::ofstream(filename).put('\n');
+  for (int i = 0; i < 2000 && segmentsOf(dir).empty(); ++i) {
+    logger.log("after the file is back", LogLevel::Info);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(segmentsOf(dir).size(), 1u);
+  EXPECT_TRUE(logger.rotate());
+}
+
+// До истечения retryDelay записи сверх maxBytes не
+// повторяют неудачную ротацию; rotate() пробует сразу.
+// Пустой файл не ротируется
+TEST(LoggerTest, RotationBacksOffAndSkipsEmptyFile) {
+  std::string dir
+    = std::string(LOG_DIR) + "/rotation_backoff";
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+  std::string filename = dir + "/rotated.log";
+
+  LoggerOptions options;
+  options.rotation.maxBytes = 256;
+  options.rotation.retryDelay = std::chrono::hours(1);
+  Logger logger(filename, LogLevel::Info, options);
+  EXPECT_TRUE(logger.rotate());  // Файл пуст
+  EXPECT_TRUE(segmentsOf(dir).empty());
+
+  logger.log("first", LogLevel::Info);
+  std::filesystem::remove(filename);
+  EXPECT_FALSE(logger.rotate());
+  std::ofstream(filename).put('\n');
+  for (int i = 0; i < 50; ++i) {
+    logger.log("within the retry delay", LogLevel::Info);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  logger.flush();
+  EXPECT_TRUE(segmentsOf(dir).empty());
+
+  EXPECT_TRUE(logger.rotate());
+  EXPECT_EQ(segmentsOf(dir).size(), 1u);
+}
+
+// Хранение: остаются только maxFiles последних сегментов;
+// при сборке с zlib сегменты сжимаются
+TEST(LoggerTest, RotationRetentionAndCompression) {
+  std::string dir
+    = std::string(LOG_DIR) + "/rotation_retention";
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+  std::string filename = dir + "/rotated.log";
+
+  LoggerOptions options;
+  options.rotation.interval = std::chrono::hours(1);
+  options.rotation.maxFiles = 2;
+  options.rotation.compress = true;
+  Logger logger(filename, LogLevel::Info, options);
+
+  for (int i = 0; i < 4; ++i) {
+    logger.log("segment " + std::to_string(i),
+               LogLevel::Info);
+    logger.rotate();
+  }
+
+  auto files = segmentsOf(dir);
+  ASSERT_EQ(files.size(), 2u);
+  if (Logger::compressionSupported()) {
+    for (auto &file : files) {
+      EXPECT_EQ(file.substr(file.size() - 3), ".gz");
+      std::string content = readFile(file);
+      ASSERT_GE(content.size(), 2u);
+      EXPECT_EQ(static_cast<unsigned char>(content[0]), 0x1f);
+      EXPECT_EQ(static_cast<unsigned char>(content[1]), 0x8b);
+    }
+  }
+}
+
+// Поточные буферы: строки каждого потока идут в исходном
+// порядке, номера сообщений уникальны и ничего не теряется
+TEST(LoggerTest, StagingKeepsPerThreadOrder) {
+  std::string filename
+    = std::string(LOG_DIR) + "/test_staging.log";
+  std::remove(filename.c_str());
+
+  constexpr int kThreads = 4;
+  constexpr int kPerThread = 2000;
+  {
+    LoggerOptions options = manualFlush();
+    options.staging.enabled = true;
+    options.staging.bufferBytes = 512;
+    options.sequenceNumbers = true;
+    Logger logger(filename, LogLevel::Info, options);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+      threads.emplace_back([&logger, t] {
+        for (int i = 0; i < kPerThread; ++i) {
+          logger.log("t" + std::to_string(t) + " "
+                       + std::to_string(i),
+                     LogLevel::Info);
+        }
+      });
+    }
+    for (auto &th : threads)
+      th.join();
+  }
+
+  std::istringstream lines(readFile(filename));
+  std::string line;
+  std::vector<int> next(kThreads, 0);
+  std::vector<bool> seen(kThreads * kPerThread, false);
+  int count = 0;
+  while (std::getline(lines, line)) {
+    ASSERT_EQ(line[0], '#') << line;
+    std::size_t seq = std::stoul(line.substr(1));
+    ASSERT_LT(seq, seen.size());
+    EXPECT_FALSE(seen[seq]);
+    seen[seq] = true;
+
+    std::size_t msg = line.find("[INFO] t");
+    ASSERT_NE(msg, std::string::npos) << line;
+    std::istringstream fields(line.substr(msg + 8));
+    int thread = 0;
+    int index = 0;
+    fields >> thread >> index;
+    EXPECT_EQ(index, next[thread]) << line;
+    next[thread] = index + 1;
+    ++count;
+  }
+  EXPECT_EQ(count, kThreads * kPerThread);
+}
+
+// flush() дописывает недозаполненные буферы потоков
+TEST(LoggerTest, StagingFlushCollectsBuffers) {
+  std::string filename
+    = std::string(LOG_DIR) + "/test_staging_flush.log";
+  std::remove(filename.c_str());
+
+  LoggerOptions options = manualFlush();
+  options.staging.enabled = true;
+  options.staging.collectInterval = std::chrono::hours(1);
+  Logger logger(filename, LogLevel::Info, options);
+
+  std::thread producer(
+    [&logger] { logger.log("from thread", LogLevel::Info); });
+  producer.join();
+  logger.log("from main", LogLevel::Info);
+  EXPECT_EQ(readFile(filename), "");
+
+  logger.flush();
+  std::string content = readFile(filename);
+  EXPECT_NE(content.find("[INFO] from thread\n"),
+            std::string::npos);
+  EXPECT_NE(content.find("[INFO] from main\n"),
+            std::string::npos);
+}
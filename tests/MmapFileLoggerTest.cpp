@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "logger/MmapFileLogger.h"
+
+using namespace logger;
+
+namespace {
+
+// Читает содержимое файла целиком
+std::string readFile(const std::string &filename) {
+  std::ifstream file(filename, std::ios::binary);
+  return std::string((std::istreambuf_iterator<char>(file)),
+                     std::istreambuf_iterator<char>());
+}
+
+// Параметры с маленькими экстентами, чтобы строки
+// пересекали их границы
+MmapLoggerOptions smallExtents() {
+  MmapLoggerOptions options;
+  options.extentSize = 4096;
+  return options;
+}
+
+}  // namespace
+
+// После штатного закрытия файл обрезан до фактической
+// длины и содержит только строки нужных уровней
+TEST(MmapFileLoggerTest, TruncatesOnCleanShutdown) {
+  std::string filename
+    = std::string(LOG_DIR) + "/test_mmap.log";
+  std::remove(filename.c_str());
+
+  std::size_t expected = 0;
+  {
+    MmapFileLogger logger(filename, LogLevel::Warning);
+    ASSERT_TRUE(logger.isOpen());
+    logger.log("visible", LogLevel::Error);
+    logger.log("hidden", LogLevel::Info);
+    expected = logger.size();
+  }
+
+  std::string content = readFile(filename);
+  EXPECT_EQ(content.size(), expected);
+  EXPECT_NE(content.find("[ERROR] visible\n"),
+            std::string::npos);
+  EXPECT_EQ(content.find("hidden"), std::string::npos);
+  EXPECT_EQ(content.find('\0'), std::string::npos);
+}
+
+// Конкурентная запись через несколько экстентов: все
+// строки целые, ни одна не потеряна
+TEST(MmapFileLoggerTest, ConcurrentWritersAcrossExtents) {
+  std::string filename
+    = std::string(LOG_DIR) + "/test_mmap_mt.log";
+  std::remove(filename.c_str());
+
+  constexpr int kThreads = 4;
+  constexpr int kPerThread = 1000;
+  {
+    MmapFileLogger logger(filename, LogLevel::Info,
+                          smallExtents());
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+      threads.emplace_back([&logger, t] {
+        for (int i = 0; i < kPerThread; ++i) {
+          logger.log("thread " + std::to_string(t) + " msg "
+                       + std::to_string(i),
+                     LogLevel::Info);
+        }
+      });
+    }
+    for (auto &th : threads)
+      th.join();
+    EXPECT_EQ(logger.droppedCount(), 0u);
+  }
+
+  std::istringstream lines(readFile(filename));
+  std::string line;
+  int count = 0;
+  while (std::getline(lines, line)) {
+    EXPECT_EQ(line.find("[INFO] thread "), 22u) << line;
+    ++count;
+  }
+  EXPECT_EQ(count, kThreads * kPerThread);
+}
+
+// Восстановление после аварии: нулевой хвост и неполная
+// строка отбрасываются, запись продолжается после
+// последней полной строки
+TEST(MmapFileLoggerTest, RecoversValidPrefix) {
+  std::string filename
+    = std::string(LOG_DIR) + "/test_mmap_crash.log";
+  {
+    std::ofstream crashed(filename,
+                          std::ios::binary | std::ios::trunc);
+    crashed << "line one\nline two\npartial";
+    crashed << std::string(3, '\0') << "late\n";
+    crashed << std::string(10000, '\0');
+  }
+
+  {
+    MmapFileLogger logger(filename, LogLevel::Info,
+                          smallExtents());
+    EXPECT_EQ(logger.size(), 18u);
+    logger.log("after restart", LogLevel::Info);
+  }
+
+  std::string content = readFile(filename);
+  EXPECT_EQ(content.rfind("line one\nline two\n[", 0), 0u);
+  EXPECT_NE(content.find("[INFO] after restart\n"),
+            std::string::npos);
+  EXPECT_EQ(content.find("partial"), std::string::npos);
+  EXPECT_EQ(content.find('\0'), std::string::npos);
+}
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "Listener.h"
+#include "QueryServer.h"
+
+using namespace logger;
+
+namespace {
+
+// Подключается к 127.0.0.1:port; -1 при ошибке
+int connectTo(int port) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(static_cast<uint16_t>(port));
+  if (connect(fd, reinterpret_cast<sockaddr *>(&addr),
+              sizeof(addr))
+      < 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+// Отправляет запрос на 127.0.0.1:port, закрывает запись
+// и читает ответ до закрытия соединения сервером
+std::string ask(int port, const std::string &request) {
+  int fd = connectTo(port);
+  if (fd < 0)
+    return "connect failed";
+  send(fd, request.data(), request.size(), 0);
+  shutdown(fd, SHUT_WR);
+  std::string response;
+  char buffer[256];
+  ssize_t bytes;
+  while ((bytes = recv(fd, buffer, sizeof(buffer), 0)) > 0)
+    response.append(buffer, static_cast<size_t>(bytes));
+  close(fd);
+  return response;
+}
+
+}  // namespace
+
+// Одна строка запроса (до '\n' или конца потока) — один
+// ответ; слишком длинный
+// запрос отклоняется, stop() завершает run()
+TEST(QueryServerTest, AnswersOneQueryPerConnection) {
+  int listener
+    = openListener(Endpoint::tcp("127.0.0.1", 0));
+  ASSERT_GE(listener, 0);
+  int port = boundPort(listener);
+  QueryServer server(listener, [](std::string_view query) {
+    return "got " + std::string(query) + "\n";
+  });
+  std::thread loop(&QueryServer::run, &server);
+
+  EXPECT_EQ(ask(port, "disk full\r\nignored\n"),
+            "got disk full\n");
+  EXPECT_EQ(ask(port, "no newline"), "got no newline\n");
+  EXPECT_EQ(
+    ask(port,
+        std::string(QueryServer::kMaxQuery + 1, 'x')
+          + "\n"),
+    "# error: query too long\n");
+
+  auto start = std::chrono::steady_clock::now();
+  server.stop();
+  loop.join();
+  EXPECT_LT(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(500));
+}
+
+// Срок общий на весь обмен: клиент, присылающий запрос
+// по байту, отключается через kClientTimeoutMs, а stop()
+// прерывает незаконченный обмен
+TEST(QueryServerTest, DeadlineCoversWholeRequest) {
+  int listener
+    = openListener(Endpoint::tcp("127.0.0.1", 0));
+  ASSERT_GE(listener, 0);
+  int port = boundPort(listener);
+  QueryServer server(listener, [](std::string_view) {
+    return std::string("answer\n");
+  });
+  std::thread loop(&QueryServer::run, &server);
+
+  int slow = connectTo(port);
+  ASSERT_GE(slow, 0);
+  auto start = std::chrono::steady_clock::now();
+  char reply = 0;
+  ssize_t got = -1;
+  while (std::chrono::steady_clock::now() - start
+         < std::chrono::seconds(5)) {
+    send(slow, "x", 1, MSG_NOSIGNAL);
+    got = recv(slow, &reply, 1, MSG_DONTWAIT);
+    if (got >= 0)
+      break;  // Сервер закрыл соединение
+    std::this_thread::sleep_for(
+      std::chrono::milliseconds(100));
+  }
+  EXPECT_EQ(got, 0);
+  EXPECT_LT(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(
+              QueryServer::kClientTimeoutMs + 500));
+  close(slow);
+
+  int stuck = connectTo(port);
+  ASSERT_GE(stuck, 0);
+  send(stuck, "partial", 7, MSG_NOSIGNAL);
+  std::this_thread::sleep_for(
+    std::chrono::milliseconds(50));
+  start = std::chrono::steady_clock::now();
+  server.stop();
+  loop.join();
+  EXPECT_LT(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(500));
+  close(stuck);
+}
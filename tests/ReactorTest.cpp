@@ -0,0 +1,219 @@
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Listener.h"
+#include "Reactor.h"
+
+using namespace logger;
+
+namespace {
+
+// Запоминает принятые сообщения; тест ждёт нужного числа
+class RecordingSink : public MessageSink {
+ public:
+  void onLine(std::string_view line) override {
+    add(std::string(line));
+  }
+
+  void onFrame(const frame::Frame &f) override {
+    add(std::string(logLevelName(f.level)) + ":"
+        + std::string(f.payload));
+  }
+
+  void onTick() override { ++ticks; }
+
+  std::atomic<int> ticks{0};  // Вызовов onTick
+
+  // Ждёт count сообщений (не дольше 2 секунд)
+  std::vector<std::string> wait(std::size_t count) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait_for(lock, std::chrono::seconds(2),
+                 [&] { return messages_.size() >= count; });
+    return messages_;
+  }
+
+ private:
+  void add(std::string message) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    messages_.push_back(std::move(message));
+    cv_.notify_all();
+  }
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<std::string> messages_;
+};
+
+// Клиентский сокет к 127.0.0.1:port
+int connectTo(int port, int type) {
+  int fd = socket(AF_INET, type, 0);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(static_cast<uint16_t>(port));
+  connect(fd, reinterpret_cast<sockaddr *>(&addr),
+          sizeof(addr));
+  return fd;
+}
+
+void sendAll(int fd, const std::string &data) {
+  ASSERT_EQ(send(fd, data.data(), data.size(), 0),
+            static_cast<ssize_t>(data.size()));
+}
+
+}  // namespace
+
+// Строки в произвольном разбиении от нескольких клиентов,
+// переход на кадры и остановка из другого потока
+TEST(ReactorTest, LinesAndFramesFromManyClients) {
+  RecordingSink sink;
+  Reactor reactor(sink);
+  int listener
+    = openListener(Endpoint::tcp("127.0.0.1", 0));
+  ASSERT_GE(listener, 0);
+  int port = boundPort(listener);
+  ASSERT_TRUE(reactor.addListener(listener, true));
+  std::thread loop(&Reactor::run, &reactor);
+
+  std::vector<int> clients;
+  for (int i = 0; i < 50; ++i)
+    clients.push_back(connectTo(port, SOCK_STREAM));
+  for (int fd : clients)
+    sendAll(fd, "hel");
+  for (int fd : clients)
+    sendAll(fd, "lo\r\n");
+  EXPECT_EQ(sink.wait(50).size(), 50u);
+
+  int framed = connectTo(port, SOCK_STREAM);
+  sendAll(framed, frame::helloLine());
+  char ack[32] = {};
+  ASSERT_GT(recv(framed, ack, sizeof(ack), 0), 0);
+  EXPECT_EQ(std::string(ack), frame::ackLine());
+  std::string frames;
+  frame::appendFrame(frames, LogLevel::Error, 0, "a\nb");
+  sendAll(framed, frames);
+  auto got = sink.wait(51);
+  ASSERT_EQ(got.size(), 51u);
+  EXPECT_EQ(got[0], "hello");
+  EXPECT_EQ(got[50], "ERROR:a\nb");
+
+  auto start = std::chrono::steady_clock::now();
+  reactor.stop();
+  loop.join();
+  EXPECT_LT(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(500));
+  for (int fd : clients)
+    close(fd);
+  close(framed);
+}
+
+// Датаграммы и хвост без '\n' при закрытии соединения
+TEST(ReactorTest, DatagramsAndTailOnClose) {
+  RecordingSink sink;
+  Reactor reactor(sink);
+  int stream = openListener(Endpoint::tcp("127.0.0.1", 0));
+  int dgram = openListener(Endpoint::udp("127.0.0.1", 0));
+  ASSERT_GE(stream, 0);
+  ASSERT_GE(dgram, 0);
+  int streamPort = boundPort(stream);
+  int dgramPort = boundPort(dgram);
+  ASSERT_TRUE(reactor.addListener(stream, true));
+  ASSERT_TRUE(reactor.addListener(dgram, false));
+  std::thread loop(&Reactor::run, &reactor);
+
+  int udp = connectTo(dgramPort, SOCK_DGRAM);
+  sendAll(udp, "first datagram\n");
+  sendAll(udp, "second\nline");
+  EXPECT_EQ(sink.wait(2),
+            (std::vector<std::string>{"first datagram",
+                                      "second\nline"}));
+
+  int tcp = connectTo(streamPort, SOCK_STREAM);
+  sendAll(tcp, "no newline");
+  close(tcp);
+  EXPECT_EQ(sink.wait(3).back(), "no newline");
+
+  reactor.stop();
+  loop.join();
+  close(udp);
+}
+
+// Несколько реакторов со своими сокетами на одном порту
+// (SO_REUSEPORT): ядро распределяет соединения между ними,
+// ни одно сообщение не теряется
+TEST(ReactorTest, ReusePortSpreadsConnections) {
+  constexpr int kReactors = 2;
+  constexpr int kClients = 64;
+  RecordingSink sinks[kReactors];
+  std::vector<std::unique_ptr<Reactor>> reactors;
+  Endpoint endpoint = Endpoint::tcp("127.0.0.1", 0);
+  for (RecordingSink &sink : sinks) {
+    reactors.push_back(std::make_unique<Reactor>(sink));
+    int fd = openListener(endpoint, true);
+    ASSERT_GE(fd, 0);
+    endpoint.port = boundPort(fd);
+    ASSERT_TRUE(reactors.back()->addListener(fd, true));
+  }
+  std::vector<std::thread> loops;
+  for (auto &reactor : reactors)
+    loops.emplace_back(&Reactor::run, reactor.get());
+
+  std::vector<int> clients;
+  for (int i = 0; i < kClients; ++i) {
+    clients.push_back(
+      connectTo(endpoint.port, SOCK_STREAM));
+    sendAll(clients.back(), "m\n");
+  }
+
+  // Ждём, пока все сообщения не будут приняты
+  auto deadline = std::chrono::steady_clock::now()
+                  + std::chrono::seconds(2);
+  std::size_t total = 0;
+  std::size_t perReactor[kReactors] = {};
+  while (total < kClients
+         && std::chrono::steady_clock::now() < deadline) {
+    total = 0;
+    for (int r = 0; r < kReactors; ++r) {
+      perReactor[r] = sinks[r].wait(0).size();
+      total += perReactor[r];
+    }
+    std::this_thread::sleep_for(
+      std::chrono::milliseconds(5));
+  }
+  EXPECT_EQ(total, static_cast<std::size_t>(kClients));
+  for (std::size_t count : perReactor)
+    EXPECT_GT(count, 0u);  // Оба реактора получили часть
+
+  for (auto &reactor : reactors)
+    reactor->stop();
+  for (std::thread &loop : loops)
+    loop.join();
+  for (int fd : clients)
+    close(fd);
+}
+
+// Без сообщений onTick вызывается раз в kTickMs
+TEST(ReactorTest, TicksWhileIdle) {
+  RecordingSink sink;
+  Reactor reactor(sink);
+  std::thread loop(&Reactor::run, &reactor);
+  std::this_thread::sleep_for(
+    std::chrono::milliseconds(5 * Reactor::kTickMs / 2));
+  reactor.stop();
+  loop.join();
+  EXPECT_GE(sink.ticks.load(), 2);
+  EXPECT_LE(sink.ticks.load(), 4);
+}
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <sstream>
+#include <streambuf>
+#include <string>
+
+#include "Reporter.h"
+
+namespace {
+
+// Буфер потока, первая запись в который ждёт release():
+// так поток вывода можно задержать, как медленный
+// терминал
+class GateBuf : public std::stringbuf {
+ public:
+  // Ждёт, пока поток вывода не упрётся в запись
+  void waitBlocked() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return blocked_; });
+  }
+
+  void release() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      open_ = true;
+    }
+    cv_.notify_all();
+  }
+
+ protected:
+  std::streamsize xsputn(const char *s,
+                         std::streamsize n) override {
+    std::unique_lock<std::mutex> lock(mutex_);
+    blocked_ = true;
+    cv_.notify_all();
+    cv_.wait(lock, [this] { return open_; });
+    return std::stringbuf::xsputn(s, n);
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool blocked_ = false;
+  bool open_ = false;
+};
+
+}  // namespace
+
+// Сообщения выводятся целиком и в порядке постановки
+TEST(ReporterTest, WritesMessagesInOrder) {
+  std::ostringstream out;
+  {
+    Reporter reporter(Verbosity::Normal, 1024, out);
+    for (int i = 0; i < 100; ++i)
+      reporter.post(Verbosity::Quiet, "line ",
+                    std::to_string(i), "\n");
+    reporter.flush();
+    EXPECT_EQ(out.str().substr(0, 14), "line 0\nline 1\n");
+    reporter.post(Verbosity::Normal, "last\n");
+  }  // Деструктор допечатывает очередь
+
+  std::string expected;
+  for (int i = 0; i < 100; ++i)
+    expected += "line " + std::to_string(i) + "\n";
+  EXPECT_EQ(out.str(), expected + "last\n");
+}
+
+TEST(ReporterTest, FiltersByVerbosity) {
+  std::ostringstream out;
+  {
+    Reporter reporter(Verbosity::Quiet, 1024, out);
+    EXPECT_TRUE(reporter.enabled(Verbosity::Quiet));
+    EXPECT_FALSE(reporter.enabled(Verbosity::Normal));
+    reporter.post(Verbosity::Verbose, "echo\n");
+    reporter.post(Verbosity::Normal, "connect\n");
+    reporter.post(Verbosity::Quiet, "report\n");
+  }
+  EXPECT_EQ(out.str(), "report\n");
+
+  Verbosity verbosity = Verbosity::Quiet;
+  EXPECT_TRUE(parseVerbosity("verbose", verbosity));
+  EXPECT_EQ(verbosity, Verbosity::Verbose);
+  EXPECT_FALSE(parseVerbosity("loud", verbosity));
+  EXPECT_EQ(verbosity, Verbosity::Verbose);
+}
+
+// Пока вывод стоит, переполнение буфера отбрасывает
+// сообщения целиком, а не тормозит вызывающего. Эхо
+// упирается в предел первым, отчёты не отбрасываются
+TEST(ReporterTest, DropsWholeMessagesWhenFull) {
+  GateBuf gate;
+  std::ostream out(&gate);
+  {
+    // Эху доступно 6 байт из 8
+    Reporter reporter(Verbosity::Verbose, 8, out);
+    reporter.post(Verbosity::Quiet, "first\n");
+    gate.waitBlocked();  // Поток вывода занят "first"
+
+    reporter.post(Verbosity::Verbose, "abc\n");
+    reporter.post(Verbosity::Verbose, "de\n");  // Не влезает
+    reporter.post(Verbosity::Verbose, "f\n");  // Влезает
+    reporter.post(Verbosity::Normal, "ghi\n");  // Не влезает
+    reporter.post(Verbosity::Normal, "g\n");  // Влезает
+    reporter.post(Verbosity::Quiet, "report\n");  // Сверх
+    EXPECT_EQ(reporter.dropped(), 2u);
+
+    gate.release();
+    reporter.flush();
+  }
+  EXPECT_EQ(gate.str(),
+            "first\n"
+            "⚠️ Console output dropped 2 messages\n"
+            "abc\nf\ng\nreport\n");
+}
@@ -1,9 +1,115 @@
 #include <gtest/gtest.h>
 
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "logger/FrameProtocol.h"
 #include "logger/SocketLogger.h"
 
 using namespace logger;
 
+namespace {
+
+// Параметры с короткими паузами переподключения
+SocketLoggerOptions fastReconnect() {
+  SocketLoggerOptions options;
+  options.reconnectMin = std::chrono::milliseconds(5);
+  options.reconnectMax = std::chrono::milliseconds(20);
+  options.lingerTimeout = std::chrono::milliseconds(100);
+  return options;
+}
+
+// Сокет, привязанный к свободному порту 127.0.0.1, но ещё
+// не принимающий соединения (подключение к нему
+// отклоняется)
+int bindLoopback(int &port) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+  socklen_t len = sizeof(addr);
+  getsockname(fd, reinterpret_cast<sockaddr *>(&addr), &len);
+  port = ntohs(addr.sin_port);
+  return fd;
+}
+
+// Сокет AF_UNIX сервера по пути path (датаграммный или
+// потоковый, ещё без listen)
+int bindUnix(const std::string &path, int type) {
+  unlink(path.c_str());
+  int fd = socket(AF_UNIX, type, 0);
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  path.copy(addr.sun_path, sizeof(addr.sun_path) - 1);
+  bind(fd, reinterpret_cast<sockaddr *>(&addr),
+       sizeof(addr));
+  return fd;
+}
+
+// Принимает count датаграмм (или до таймаута)
+std::vector<std::string> readDatagrams(int fd, int count) {
+  timeval tv{2, 0};
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  std::vector<std::string> datagrams;
+  char buf[4096];
+  while (static_cast<int>(datagrams.size()) < count) {
+    ssize_t n = recv(fd, buf, sizeof(buf), 0);
+    if (n < 0)
+      break;
+    datagrams.emplace_back(buf,
+                           static_cast<std::size_t>(n));
+  }
+  return datagrams;
+}
+
+// Читает из соединения, пока не придёт count строк или не
+// истечёт таймаут
+std::string readLines(int fd, int count) {
+  timeval tv{2, 0};
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  std::string data;
+  char buf[4096];
+  int lines = 0;
+  while (lines < count) {
+    ssize_t n = recv(fd, buf, sizeof(buf), 0);
+    if (n <= 0)
+      break;
+    for (ssize_t i = 0; i < n; ++i)
+      lines += buf[i] == '\n';
+    data.append(buf, static_cast<std::size_t>(n));
+  }
+  return data;
+}
+
+// Читает кадры, пока не придёт count штук или не истечёт
+// таймаут
+std::vector<std::string> readFrames(int fd, int count) {
+  frame::FrameDecoder decoder;
+  std::vector<std::string> payloads;
+  char buf[4096];
+  frame::Frame f;
+  while (static_cast<int>(payloads.size()) < count) {
+    ssize_t n = recv(fd, buf, sizeof(buf), 0);
+    if (n <= 0)
+      break;
+    decoder.feed(buf, static_cast<std::size_t>(n));
+    while (decoder.next(f))
+      payloads.emplace_back(f.payload);
+  }
+  return payloads;
+}
+
+}  // namespace
+
 // Тестируем установку и получение уровня логирования
 TEST(SocketLoggerTest, SetGetLevel) {
   // Создаем SocketLogger с уровнем Info
@@ -32,3 +138,223 @@ TEST(SocketLoggerTest, Connection) {
   // Подтверждаем, что тест прошел без ошибок
   SUCCEED();
 }
+
+// Сервер запускается после логгера: сообщения копятся в
+// буфере и уходят после переподключения в исходном порядке
+TEST(SocketLoggerTest, SpillsUntilServerAppears) {
+  int port = 0;
+  int listener = bindLoopback(port);
+  ASSERT_GT(port, 0);
+
+  SocketLogger slogger("127.0.0.1", port, LogLevel::Info,
+                       fastReconnect());
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < 100; ++i) {
+    slogger.log("early " + std::to_string(i), LogLevel::Info);
+  }
+  // Вызывающий не ждёт сеть
+  EXPECT_LT(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(500));
+  EXPECT_FALSE(slogger.isConnected());
+
+  ASSERT_EQ(listen(listener, 1), 0);
+  int conn = accept(listener, nullptr, nullptr);
+  ASSERT_GE(conn, 0);
+  slogger.log("late", LogLevel::Warning);
+  EXPECT_TRUE(slogger.flush(std::chrono::seconds(2)));
+
+  std::string data = readLines(conn, 101);
+  EXPECT_NE(data.find("[INFO] early 0\n"), std::string::npos);
+  EXPECT_LT(data.find("early 0\n"), data.find("early 99\n"));
+  EXPECT_LT(data.find("early 99\n"), data.find("late\n"));
+  EXPECT_EQ(slogger.droppedCount(), 0u);
+  close(conn);
+  close(listener);
+}
+
+// Переполнение буфера: лишние сообщения отбрасываются и
+// учитываются, log() не блокируется
+TEST(SocketLoggerTest, DropsWhenSpillIsFull) {
+  int port = 0;
+  int listener = bindLoopback(port);
+
+  SocketLoggerOptions options = fastReconnect();
+  options.spillBytes = 1024;
+  SocketLogger slogger("127.0.0.1", port, LogLevel::Info,
+                       options);
+  for (int i = 0; i < 100; ++i) {
+    slogger.log("message " + std::to_string(i),
+                LogLevel::Info);
+  }
+  EXPECT_GT(slogger.droppedCount(), 0u);
+  EXPECT_LT(slogger.droppedCount(), 100u);
+  EXPECT_FALSE(slogger.flush(std::chrono::milliseconds(20)));
+  close(listener);
+}
+
+// Сервер подтверждает протокол кадров: сообщения с
+// переводами строк приходят целыми кадрами
+TEST(SocketLoggerTest, FramedAfterHandshake) {
+  int port = 0;
+  int listener = bindLoopback(port);
+  ASSERT_EQ(listen(listener, 1), 0);
+
+  SocketLoggerOptions options = fastReconnect();
+  options.protocol = WireProtocol::Framed;
+  SocketLogger slogger("127.0.0.1", port, LogLevel::Info,
+                       options);
+  slogger.log("queued\nbefore ack", LogLevel::Error);
+
+  int conn = accept(listener, nullptr, nullptr);
+  ASSERT_GE(conn, 0);
+  EXPECT_EQ(readLines(conn, 1), frame::helloLine());
+  // Подтверждение вместе с лишними байтами после него
+  std::string ack = frame::ackLine() + "extra";
+  ASSERT_EQ(send(conn, ack.data(), ack.size(), 0),
+            static_cast<ssize_t>(ack.size()));
+
+  slogger.log("after", LogLevel::Info);
+  EXPECT_TRUE(slogger.flush(std::chrono::seconds(2)));
+  EXPECT_TRUE(slogger.isFramed());
+  EXPECT_EQ(readFrames(conn, 2),
+            (std::vector<std::string>{"queued\nbefore ack",
+                                      "after"}));
+  close(conn);
+  close(listener);
+}
+
+// Сервер не отвечает на приветствие (старая версия):
+// логгер закрывает соединение и продолжает текстовым
+// протоколом на новом
+TEST(SocketLoggerTest, FallsBackToTextWithoutAck) {
+  int port = 0;
+  int listener = bindLoopback(port);
+  ASSERT_EQ(listen(listener, 2), 0);
+
+  SocketLoggerOptions options = fastReconnect();
+  options.protocol = WireProtocol::Framed;
+  options.handshakeTimeout = std::chrono::milliseconds(50);
+  SocketLogger slogger("127.0.0.1", port, LogLevel::Info,
+                       options);
+  slogger.log("plain", LogLevel::Warning);
+
+  int first = accept(listener, nullptr, nullptr);
+  ASSERT_GE(first, 0);
+  // После приветствия — конец потока, текста здесь нет
+  EXPECT_EQ(readLines(first, 2), frame::helloLine());
+
+  int second = accept(listener, nullptr, nullptr);
+  ASSERT_GE(second, 0);
+  EXPECT_TRUE(slogger.flush(std::chrono::seconds(2)));
+  EXPECT_FALSE(slogger.isFramed());
+  std::string data = readLines(second, 1);
+  EXPECT_EQ(data.find(frame::helloLine()),
+            std::string::npos);
+  EXPECT_NE(data.find("[WARNING] plain\n"),
+            std::string::npos);
+  close(first);
+  close(second);
+  close(listener);
+}
+
+// Подтверждение пришло позже срока: сервер уже ждёт
+// кадры, поэтому текст на этом соединении не отправляется
+TEST(SocketLoggerTest, ReconnectsAfterLateAck) {
+  int port = 0;
+  int listener = bindLoopback(port);
+  ASSERT_EQ(listen(listener, 2), 0);
+
+  SocketLoggerOptions options = fastReconnect();
+  options.protocol = WireProtocol::Framed;
+  options.handshakeTimeout = std::chrono::milliseconds(50);
+  SocketLogger slogger("127.0.0.1", port, LogLevel::Info,
+                       options);
+  slogger.log("late", LogLevel::Info);
+
+  int first = accept(listener, nullptr, nullptr);
+  ASSERT_GE(first, 0);
+  EXPECT_EQ(readLines(first, 1), frame::helloLine());
+  std::this_thread::sleep_for(
+    std::chrono::milliseconds(200));
+  std::string ack = frame::ackLine();
+  send(first, ack.data(), ack.size(), MSG_NOSIGNAL);
+  EXPECT_EQ(readLines(first, 1), "");
+
+  int second = accept(listener, nullptr, nullptr);
+  ASSERT_GE(second, 0);
+  EXPECT_TRUE(slogger.flush(std::chrono::seconds(2)));
+  EXPECT_FALSE(slogger.isFramed());
+  EXPECT_NE(readLines(second, 1).find("[INFO] late\n"),
+            std::string::npos);
+  close(first);
+  close(second);
+  close(listener);
+}
+
+// Потоковый сокет AF_UNIX: тот же протокол, что и по TCP,
+// включая рукопожатие кадров
+TEST(SocketLoggerTest, UnixStreamTransport) {
+  std::string path = "/tmp/logger_test_"
+                     + std::to_string(getpid()) + ".sock";
+  int listener = bindUnix(path, SOCK_STREAM);
+  ASSERT_EQ(listen(listener, 1), 0);
+
+  SocketLoggerOptions options = fastReconnect();
+  options.protocol = WireProtocol::Framed;
+  SocketLogger slogger(Endpoint::unixStream(path),
+                       LogLevel::Info, options);
+  slogger.log("over unix", LogLevel::Warning);
+
+  int conn = accept(listener, nullptr, nullptr);
+  ASSERT_GE(conn, 0);
+  EXPECT_EQ(readLines(conn, 1), frame::helloLine());
+  std::string ack = frame::ackLine();
+  ASSERT_EQ(send(conn, ack.data(), ack.size(), 0),
+            static_cast<ssize_t>(ack.size()));
+
+  EXPECT_TRUE(slogger.flush(std::chrono::seconds(2)));
+  EXPECT_EQ(readFrames(conn, 1),
+            std::vector<std::string>{"over unix"});
+  close(conn);
+  close(listener);
+  unlink(path.c_str());
+}
+
+// Датаграммные транспорты: одно сообщение — одна
+// датаграмма, перевод строки внутри сообщения сохраняется
+TEST(SocketLoggerTest, DatagramTransports) {
+  std::string path = "/tmp/logger_test_"
+                     + std::to_string(getpid()) + ".dgram";
+  int unixFd = bindUnix(path, SOCK_DGRAM);
+  int udpFd = socket(AF_INET, SOCK_DGRAM, 0);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  bind(udpFd, reinterpret_cast<sockaddr *>(&addr),
+       sizeof(addr));
+  socklen_t len = sizeof(addr);
+  getsockname(udpFd, reinterpret_cast<sockaddr *>(&addr),
+              &len);
+
+  for (Endpoint endpoint :
+       {Endpoint::unixDatagram(path),
+        Endpoint::udp("127.0.0.1", ntohs(addr.sin_port))}) {
+    int fd = endpoint.isInet() ? udpFd : unixFd;
+    SocketLogger slogger(endpoint, LogLevel::Info,
+                         fastReconnect());
+    slogger.log("one", LogLevel::Info);
+    slogger.log("two\nlines", LogLevel::Error);
+    EXPECT_TRUE(slogger.flush(std::chrono::seconds(2)));
+    EXPECT_FALSE(slogger.isFramed());
+
+    std::vector<std::string> got = readDatagrams(fd, 2);
+    ASSERT_EQ(got.size(), 2u) << toString(endpoint);
+    EXPECT_NE(got[0].find("[INFO] one"), std::string::npos);
+    EXPECT_EQ(got[0].back(), 'e');  // Без '\n'
+    EXPECT_NE(got[1].find("[ERROR] two\nlines"),
+              std::string::npos);
+  }
+  close(udpFd);
+  close(unixFd);
+  unlink(path.c_str());
+}
@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "logger/SpillRing.h"
+
+using namespace logger;
+
+// Записи извлекаются целиком и в порядке добавления, в
+// том числе через границу кольца
+TEST(SpillRingTest, KeepsRecordsAcrossWrap) {
+  SpillRing ring(64);
+  std::string out;
+  std::vector<std::size_t> ends;
+
+  for (int round = 0; round < 10; ++round) {
+    ASSERT_TRUE(ring.push("abcdefghij", 10));
+    ASSERT_TRUE(ring.push("xyz", 3));
+    out.clear();
+    ends.clear();
+    EXPECT_EQ(ring.popInto(out, ends, 1024), 2u);
+    EXPECT_EQ(out, "abcdefghijxyz");
+    EXPECT_EQ(ends, (std::vector<std::size_t>{10, 13}));
+    EXPECT_TRUE(ring.empty());
+  }
+}
+
+// Ёмкость учитывает заголовки; popInto соблюдает maxBytes,
+// но всегда отдаёт хотя бы одну запись
+TEST(SpillRingTest, BoundsAndBatching) {
+  SpillRing ring(32);
+  EXPECT_TRUE(ring.push("0123456789ab", 12));  // 16 байт
+  EXPECT_TRUE(ring.push("0123456789ab", 12));  // 32 байта
+  EXPECT_FALSE(ring.push("x", 1));
+  EXPECT_EQ(ring.bytes(), 32u);
+
+  std::string out;
+  std::vector<std::size_t> ends;
+  EXPECT_EQ(ring.popInto(out, ends, 4), 1u);
+  EXPECT_EQ(out.size(), 12u);
+  EXPECT_TRUE(ring.push("x", 1));
+  EXPECT_EQ(ring.popInto(out, ends, 1024), 2u);
+  EXPECT_EQ(out.size(), 25u);
+  EXPECT_EQ(ring.records(), 0u);
+}
@@ -0,0 +1,207 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <thread>
+#include <vector>
+
+#include "Stats.h"
+
+// Слияние снимков шардов даёт ту же статистику, что и
+// один общий шард
+TEST(StatsShardTest, MergeMatchesSingleShard) {
+  time_t now = time(nullptr);
+  StatsShard single;
+  StatsShard shards[3];
+  const StatsLevel levels[] = {StatsLevel::Error,
+                               StatsLevel::Warning,
+                               StatsLevel::Info};
+  for (int i = 0; i < 30; ++i) {
+    auto length = static_cast<std::size_t>(i + 1);
+    time_t when = i % 5 == 0 ? now - 7200 : now;
+    single.add(levels[i % 3], length, when);
+    shards[i % 2 == 0 ? 0 : 1 + i % 4 / 2].add(
+      levels[i % 3], length, when);
+  }
+
+  StatsSnapshot merged;
+  for (const StatsShard &shard : shards)
+    merged.merge(shard.snapshot(now));
+  StatsSnapshot expected = single.snapshot(now);
+
+  EXPECT_EQ(merged.totalMessages, 30u);
+  EXPECT_EQ(merged.totalMessages, expected.totalMessages);
+  EXPECT_EQ(merged.levelCount, expected.levelCount);
+  EXPECT_EQ(merged.levelCount[static_cast<std::size_t>(
+              StatsLevel::Warning)],
+            10u);
+  EXPECT_EQ(merged.minLen, 1u);
+  EXPECT_EQ(merged.maxLen, 30u);
+  EXPECT_EQ(merged.totalLen, expected.totalLen);
+  // Окна по умолчанию: минута, час, сутки; 6 записей
+  // старше часа, но моложе суток
+  ASSERT_EQ(merged.windows.size(), 3u);
+  EXPECT_EQ(merged.windows[0].total(), 24u);
+  EXPECT_EQ(merged.windows[1].total(), 24u);
+  EXPECT_EQ(merged.windows[2].total(), 30u);
+  EXPECT_EQ(merged.windows[1].levelCount,
+            expected.windows[1].levelCount);
+}
+
+// Распределения длин и задержек шардов сливаются в общее;
+// задержка учитывается только там, где она известна
+TEST(StatsShardTest, HistogramsMergeAcrossShards) {
+  time_t now = time(nullptr);
+  StatsShard shards[2];
+  for (int i = 1; i <= 1000; ++i) {
+    auto length = static_cast<std::size_t>(i % 100 == 0
+                                             ? 5000
+                                             : 40);
+    std::int64_t latency = i % 2 == 0 ? i : -1;
+    shards[i % 2].add(StatsLevel::Info, length, now,
+                      latency);
+  }
+
+  StatsSnapshot merged;
+  for (const StatsShard &shard : shards)
+    merged.merge(shard.snapshot(now));
+  EXPECT_EQ(merged.lengths.count(), 1000u);
+  EXPECT_EQ(merged.lengths.percentile(50), 40u);
+  EXPECT_EQ(merged.lengths.percentile(98), 40u);
+  EXPECT_EQ(
+    merged.lengths.percentile(99.9),
+    Histogram::bucketHigh(Histogram::bucketOf(5000)));
+  EXPECT_EQ(merged.latency.count(), 500u);
+  EXPECT_NEAR(
+    static_cast<double>(merged.latency.percentile(90)), 900,
+    900.0 / Histogram::kSubBuckets);
+}
+
+// Окно считает по уровням только записи моложе своей
+// длины, а устаревшие корзины переиспользуются
+TEST(StatsShardTest, WindowsSlideAndExpire) {
+  time_t now = 1700000000;
+  StatsShard shard({{10, 1}, {60, 10}});
+  shard.add(StatsLevel::Error, 1, now - 30);
+  shard.add(StatsLevel::Error, 1, now - 5);
+  shard.add(StatsLevel::Info, 1, now - 5);
+  shard.add(StatsLevel::Info, 1, now);
+
+  StatsSnapshot s = shard.snapshot(now);
+  ASSERT_EQ(s.windows.size(), 2u);
+  const auto error = static_cast<std::size_t>(
+    StatsLevel::Error);
+  const auto info = static_cast<std::size_t>(
+    StatsLevel::Info);
+  EXPECT_EQ(s.windows[0].total(), 3u);
+  EXPECT_EQ(s.windows[0].levelCount[error], 1u);
+  EXPECT_EQ(s.windows[0].levelCount[info], 2u);
+  EXPECT_EQ(s.windows[1].total(), 4u);
+  EXPECT_EQ(s.windows[1].levelCount[error], 2u);
+
+  // Через 10 секунд кольцо на 10 корзин по 1 с уже
+  // сдвинулось: корзина now - 5 вышла из окна, а запись
+  // now + 10 легла на место корзины now
+  shard.add(StatsLevel::Warning, 1, now + 10);
+  s = shard.snapshot(now + 10);
+  EXPECT_EQ(s.windows[0].total(), 1u);
+  EXPECT_EQ(s.windows[1].total(), 5u);
+  EXPECT_EQ(s.totalMessages, 5u);
+
+  // Через сутки все окна пусты, итоги остаются
+  s = shard.snapshot(now + 86400);
+  EXPECT_EQ(s.windows[0].total(), 0u);
+  EXPECT_EQ(s.windows[1].total(), 0u);
+  EXPECT_EQ(s.totalMessages, 5u);
+}
+
+// Разбор списка окон и короткие имена
+TEST(StatsShardTest, ParsesWindowList) {
+  std::vector<RateWindow> windows;
+  ASSERT_TRUE(parseRateWindows("60/1,3600/10,86400",
+                               windows));
+  ASSERT_EQ(windows.size(), 3u);
+  EXPECT_EQ(windows[0].buckets(), 60u);
+  EXPECT_EQ(windows[1].buckets(), 360u);
+  EXPECT_EQ(windows[2].step, 240);
+  EXPECT_EQ(windows[2].buckets(), 360u);
+
+  EXPECT_FALSE(parseRateWindows("", windows));
+  EXPECT_FALSE(parseRateWindows("60,", windows));
+  EXPECT_FALSE(parseRateWindows("60/0", windows));
+  EXPECT_FALSE(parseRateWindows("10/20", windows));
+  EXPECT_FALSE(parseRateWindows("1h", windows));
+  EXPECT_FALSE(parseRateWindows("864000/1", windows));
+  EXPECT_EQ(windows.size(), 3u);  // Не изменился
+
+  EXPECT_EQ(rateWindowName(60), "1m");
+  EXPECT_EQ(rateWindowName(7200), "2h");
+  EXPECT_EQ(rateWindowName(86400), "1d");
+  EXPECT_EQ(rateWindowName(90), "90s");
+}
+
+// Пустой шард не портит слияние
+TEST(StatsShardTest, EmptyShardIsNeutral) {
+  StatsShard empty;
+  StatsShard one;
+  one.add(StatsLevel::Info, 3, time(nullptr));
+
+  StatsSnapshot merged = empty.snapshot(time(nullptr));
+  merged.merge(one.snapshot(time(nullptr)));
+  EXPECT_EQ(merged.totalMessages, 1u);
+  EXPECT_EQ(merged.minLen, 3u);
+  EXPECT_EQ(merged.maxLen, 3u);
+  EXPECT_STREQ(statsLevelName(StatsLevel::Unknown),
+               "unknown");
+}
+
+// Снимки берутся, пока писатель не останавливается, и
+// каждый согласован: всего сообщений = сумме по уровням и
+// суммарной длине / 4, а корзины гистограмм и окон
+// включают все учтённые сообщения
+TEST(StatsShardTest, SnapshotIsConsistentUnderWrites) {
+  StatsShard shard;
+  std::atomic<bool> stop{false};
+  std::atomic<std::uint64_t> written{0};
+  time_t now = time(nullptr);
+  std::thread writer([&] {
+    std::uint64_t i = 0;
+    while (!stop.load(std::memory_order_relaxed)) {
+      shard.add(static_cast<StatsLevel>(i % 5), 4, now);
+      written.store(++i, std::memory_order_relaxed);
+    }
+  });
+  while (written.load(std::memory_order_relaxed) == 0)
+    std::this_thread::yield();
+
+  // Снимки, пока итоги не сменятся 20 раз (на одном ядре
+  // писатель и читатель чередуются по кванту)
+  auto deadline = std::chrono::steady_clock::now()
+                  + std::chrono::seconds(10);
+  std::uint64_t last = 0;
+  int changes = 0;
+  while (changes < 20
+         && std::chrono::steady_clock::now() < deadline) {
+    StatsSnapshot s = shard.snapshot(now);
+    std::uint64_t sum = 0;
+    for (std::uint64_t count : s.levelCount)
+      sum += count;
+    EXPECT_EQ(sum, s.totalMessages);
+    EXPECT_EQ(s.totalLen, s.totalMessages * 4);
+    EXPECT_GE(s.windows[0].total(), s.totalMessages);
+    EXPECT_GE(s.lengths.count(), s.totalMessages);
+    EXPECT_GE(s.totalMessages, last);
+    if (s.totalMessages != last)
+      ++changes;
+    last = s.totalMessages;
+  }
+  EXPECT_EQ(changes, 20);
+  stop = true;
+  writer.join();
+
+  StatsSnapshot s = shard.snapshot(now);
+  EXPECT_EQ(s.totalMessages, written.load());
+  EXPECT_EQ(s.windows[0].total(), s.totalMessages);
+  EXPECT_EQ(s.lengths.count(), s.totalMessages);
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "LevelClassifier.h"
+#include "TemplateMiner.h"
+
+// Числа, время и id становятся "<*>", и строки одного
+// вида сходятся в один шаблон
+TEST(TemplateMinerTest, GroupsLinesDifferingInVariables) {
+  TemplateMiner miner;
+  for (int i = 0; i < 50; ++i)
+    miner.add("[12:00:" + std::to_string(10 + i)
+                + "] [ERROR] db timeout after "
+                + std::to_string(i * 7) + " ms",
+              100 + i);
+  miner.add("request 0xdeadbeef from deadbeefcafe", 200);
+
+  std::vector<TemplateStats> templates = miner.templates();
+  ASSERT_EQ(templates.size(), 2u);
+  EXPECT_EQ(templates[0].text,
+            "<*> [ERROR] db timeout after <*> ms");
+  EXPECT_EQ(templates[0].count, 50u);
+  EXPECT_EQ(templates[0].lastSeen, 149);
+  EXPECT_EQ(templates[1].text, "request <*> from <*>");
+}
+
+// Строки формата Logger майнер получает без "[время]
+// [УРОВЕНЬ]" (как в log_stats): поля заголовка не сводят
+// разные сообщения в один шаблон
+TEST(TemplateMinerTest, MinesLoggerLinesWithoutHeader) {
+  const char *lines[] = {
+    "[2024-05-01 12:00:00] [INFO] user logged in",
+    "[2024-05-01 12:00:01] [INFO] disk full now",
+    "[2024-05-01 12:00:02.125] [INFO] user logged in",
+    "#7 [2024-05-01 12:00:03] [WARNING] disk full now",
+    "[2024-05-01 12:00:04] [ERROR] user 42 logged out"};
+  TemplateMiner miner;
+  time_t now = 100;
+  for (const char *line : lines) {
+    std::string_view message;
+    classifyMessage(line, message);
+    miner.add(message, now++);
+  }
+
+  std::vector<TemplateStats> templates = miner.templates();
+  ASSERT_EQ(templates.size(), 3u);
+  EXPECT_EQ(templates[2].text, "user <*> logged out");
+  std::vector<std::string> texts{templates[0].text,
+                                 templates[1].text};
+  std::sort(texts.begin(), texts.end());
+  EXPECT_EQ(texts, (std::vector<std::string>{
+                     "disk full now", "user logged in"}));
+  EXPECT_EQ(templates[0].count, 2u);
+  EXPECT_EQ(templates[1].count, 2u);
+}
+
+// Похожие строки обобщают шаблон, непохожие заводят
+// новый
+TEST(TemplateMinerTest, GeneralizesSimilarLines) {
+  TemplateMiner miner;
+  miner.add("connect to alpha failed", 1);
+  miner.add("connect to beta failed", 2);
+  miner.add("connect to cache server", 3);
+  miner.add("disk full on root", 4);
+  miner.add("", 5);  // Пустые строки не учитываются
+
+  std::vector<TemplateStats> templates = miner.templates();
+  ASSERT_EQ(templates.size(), 2u);
+  EXPECT_EQ(templates[0].text, "connect to <*> <*>");
+  EXPECT_EQ(templates[0].count, 3u);
+  EXPECT_EQ(templates[1].text, "disk full on root");
+}
+
+// Таблица ограничена: вытесняется давно не
+// встречавшийся шаблон, его ветка дерева удаляется
+TEST(TemplateMinerTest, EvictsLeastRecentlySeenTemplate) {
+  TemplateMinerOptions options;
+  options.maxTemplates = 2;
+  options.maxChildren = 2;
+  TemplateMiner miner(options);
+  miner.add("alpha started", 1);
+  miner.add("beta started", 2);
+  miner.add("alpha started", 3);
+  miner.add("gamma stopped", 4);  // Вытесняет beta
+  miner.add("beta started", 5);  // Вытесняет alpha
+
+  EXPECT_EQ(miner.size(), 2u);
+  EXPECT_EQ(miner.evicted(), 2u);
+  std::vector<TemplateStats> templates = miner.templates();
+  ASSERT_EQ(templates.size(), 2u);
+  EXPECT_EQ(templates[0].count, 1u);
+  EXPECT_EQ(templates[1].count, 1u);
+  std::vector<std::string> texts{templates[0].text,
+                                 templates[1].text};
+  std::sort(texts.begin(), texts.end());
+  EXPECT_EQ(texts, (std::vector<std::string>{
+                     "beta started", "gamma stopped"}));
+}
+
+// Одинаковые шаблоны майнеров складываются
+TEST(TemplateMinerTest, MergeSumsSameTemplates) {
+  TemplateMiner left, right;
+  left.add("job 1 done", 10);
+  left.add("job 2 done", 20);
+  right.add("job 3 done", 30);
+  right.add("queue empty", 5);
+
+  std::vector<TemplateStats> merged
+    = mergeTemplates({&left, &right}, 1);
+  ASSERT_EQ(merged.size(), 1u);
+  EXPECT_EQ(merged[0].text, "job <*> done");
+  EXPECT_EQ(merged[0].count, 3u);
+  EXPECT_EQ(merged[0].lastSeen, 30);
+}
@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include <time.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <string>
+
+#include "logger/Timestamp.h"
+
+using namespace logger;
+
+namespace {
+
+// Эталонное форматирование секунд через strftime
+std::string reference(std::time_t t) {
+  std::tm tm{};
+  localtime_r(&t, &tm);
+  char buf[32];
+  std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &tm);
+  return buf;
+}
+
+}  // namespace
+
+// Префикс совпадает со strftime, в том числе после смены
+// секунды (кэш пересобирается)
+TEST(TimestampTest, SecondsMatchStrftime) {
+  TimestampFormatter formatter;
+  char buf[TimestampFormatter::kMaxLength];
+
+  std::time_t base = 1700000000;
+  for (std::time_t t = base; t < base + 3; ++t) {
+    auto tp = std::chrono::system_clock::from_time_t(t);
+    std::size_t len = formatter.format(buf, tp);
+    EXPECT_EQ(std::string(buf, len), reference(t));
+  }
+}
+
+// Дробная часть для миллисекунд и микросекунд
+TEST(TimestampTest, FractionalPrecision) {
+  auto tp = std::chrono::system_clock::from_time_t(1700000000)
+            + std::chrono::microseconds(42007);
+  char buf[TimestampFormatter::kMaxLength];
+
+  TimestampFormatter millis(TimePrecision::Milliseconds);
+  std::size_t len = millis.format(buf, tp);
+  EXPECT_EQ(std::string(buf, len),
+            reference(1700000000) + ".042");
+
+  TimestampFormatter micros(TimePrecision::Microseconds);
+  len = micros.format(buf, tp);
+  EXPECT_EQ(std::string(buf, len),
+            reference(1700000000) + ".042007");
+}
+
+// Быстрые часы идут вровень с системными
+TEST(TimestampTest, FastClockTracksSystemClock) {
+  TimestampFormatter fast(TimePrecision::Milliseconds,
+                          ClockSource::Fast);
+  auto diff = fast.now() - std::chrono::system_clock::now();
+  auto ms
+    = std::chrono::duration_cast<std::chrono::milliseconds>(
+        diff)
+        .count();
+  EXPECT_LT(std::llabs(static_cast<long long>(ms)), 100);
+  EXPECT_EQ(fast.current().size(), 23u);
+}